@@ -0,0 +1,72 @@
+
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_565.h"
+#include "pixel_image.h"
+// host
+#include "fb_record.h"
+
+
+FbRecord::FbRecord(int width, int height, uint32_t baud) :
+    Framebuffer(width, height),
+    _baud(baud),
+    _paced(false),
+    _busy_until(0),
+    _stats{},
+    _ram(width * height)
+{
+}
+
+
+// Count one address window of wid x hgt pixels. Off-screen pixels are still
+// counted; the panel clips them but they are still sent.
+void FbRecord::window(int wid, int hgt)
+{
+    if (wid <= 0 || hgt <= 0)
+        return;
+    _stats.windows++;
+    _stats.pixels += uint64_t(wid) * hgt;
+    const uint64_t bytes = window_bytes + uint64_t(wid) * hgt * sizeof(Pixel565);
+    _stats.bytes += bytes;
+
+    if (_paced) {
+        const uint64_t now = time_us_64();
+        if (_busy_until < now)
+            _busy_until = now;
+        _busy_until += bytes_us(bytes);
+        if (_busy_until > now)
+            sleep_us(_busy_until - now);
+    }
+}
+
+
+void FbRecord::fill_rect(int col, int row, int wid, int hgt, Color clr)
+{
+    window(wid, hgt);
+    const Pixel565 p(clr);
+    for (int r = row; r < row + hgt; r++) {
+        if (r < 0 || r >= height())
+            continue;
+        for (int c = col; c < col + wid; c++) {
+            if (c >= 0 && c < width())
+                _ram[r * width() + c] = p;
+        }
+    }
+}
+
+
+void FbRecord::write(int col, int row, const PixelImageHdr *img)
+{
+    window(img->wid, img->hgt);
+    const Pixel565 *p = image_pixels<Pixel565>(img);
+    for (int r = row; r < row + img->hgt; r++) {
+        for (int c = col; c < col + img->wid; c++, p++) {
+            if (r >= 0 && r < height() && c >= 0 && c < width())
+                _ram[r * width() + c] = *p;
+        }
+    }
+}
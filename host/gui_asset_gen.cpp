@@ -0,0 +1,501 @@
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+// framebuffer
+#include "color.h"
+#include "font.h"
+#include "pixel_image.h"
+// gui
+#include "gui_image.h"
+#include "gui_pixel.h"
+// build
+#include "gui_asset_fonts.h"
+
+// Usage: gui_asset_gen manifest out_dir
+//
+// Renders widget images at build time, instead of by constexpr label_img()
+// in every translation unit that declares one (see gui_assets() in the top
+// CMakeLists.txt). Each line of the manifest declares one asset:
+//
+//   label  name=ok wid=100 hgt=40 font=F fg=RRGGBB bg=RRGGBB text="OK"
+//          [brd=N brd_clr=RRGGBB]
+//   button name=nav wid=160 hgt=36 font=F fg=RRGGBB brd=N up=RRGGBB
+//          dn=RRGGBB text="Next"
+//   mask   name=nav wid=160 hgt=36 font=F bpp=4 text="Next"
+//   digits font=F fg=RRGGBB bg=RRGGBB
+//
+// A label's, button's or mask's wid and hgt may be left out: they are then
+// the text's (font.width(), font.y_adv), or fit="TEXT"'s if given (to size
+// two images alike), plus pad=N on each side. Either may also be a multiple
+// of that size without the padding, e.g. wid=2x hgt=2x.
+//
+// A color is RRGGBB, or as Color names it: none, black, white, red, green,
+// blue, or gray(N) for N percent (Color::gray()).
+//
+// '#' starts a comment. Each asset goes in its own header in out_dir, with
+// the names the macros in gui_macros.h would declare: a label is NAME_img,
+// a button NAME_btn_up_img and NAME_btn_dn_img (as BUTTON_1), a mask
+// NAME_mask (as MASK_LABEL_IMG), and digits F_0_img ... F_9_img and
+// F_digit_img[10] (as DIGIT_IMAGE_ARRAY). Pass &NAME_img.hdr to a widget as
+// usual. gui_assets.h includes them all.
+//
+// A header is only written if its contents change, so editing one asset
+// recompiles only what includes that asset.
+//
+// The pixels are GuiPixel as this program is built (its bytes, so the
+// target must have the same byte order; both are little endian). The fonts
+// are the ones the build lists (GUI_ASSET_FONTS in the top CMakeLists.txt):
+// the host fonts in the host build, the framebuffer library's when built
+// for a pico build.
+
+static const struct {
+    const char *name;
+    const Font *font;
+} fonts[] = {
+#define GUI_ASSET_FONT(F) {#F, &F},
+    GUI_ASSET_FONT_LIST
+#undef GUI_ASSET_FONT
+};
+
+
+struct Asset {
+    int line;
+    std::string kind;
+    std::vector<std::pair<std::string, std::string>> args;
+
+    const std::string *get(const char *key) const
+    {
+        for (const auto &a : args)
+            if (a.first == key)
+                return &a.second;
+        return nullptr;
+    }
+};
+
+
+static const char *manifest_name = "";
+
+
+static void fail(const Asset &a, const char *msg, const char *what = "")
+{
+    fprintf(stderr, "%s:%d: %s%s\n", manifest_name, a.line, msg, what);
+    exit(1);
+}
+
+
+static std::string str_arg(const Asset &a, const char *key)
+{
+    const std::string *v = a.get(key);
+    if (v == nullptr)
+        fail(a, "missing ", key);
+    return *v;
+}
+
+
+static int int_arg(const Asset &a, const char *key, int dflt = -1)
+{
+    const std::string *v = a.get(key);
+    if (v == nullptr && dflt >= 0)
+        return dflt;
+    const std::string s = str_arg(a, key);
+    char *end;
+    const long n = strtol(s.c_str(), &end, 0);
+    if (*end != '\0' || n < 0 || n > 4096)
+        fail(a, "bad number for ", key);
+    return int(n);
+}
+
+
+static Color color_arg(const Asset &a, const char *key,
+                       const char *dflt = nullptr)
+{
+    const std::string *v = a.get(key);
+    if (v == nullptr && dflt == nullptr)
+        fail(a, "missing ", key);
+    const std::string s = v != nullptr ? *v : dflt;
+    static const struct {
+        const char *name;
+        Color color;
+    } named[] = {
+        {"none", Color::none()}, {"black", Color::black()},
+        {"white", Color::white()}, {"red", Color::red()},
+        {"green", Color::green()}, {"blue", Color::blue()},
+    };
+    for (const auto &n : named)
+        if (s == n.name)
+            return n.color;
+    char *end;
+    if (s.compare(0, 5, "gray(") == 0) {
+        const long pct = strtol(s.c_str() + 5, &end, 10);
+        if (end == s.c_str() + 5 || strcmp(end, ")") != 0 || pct < 0 ||
+            pct > 100)
+            fail(a, "bad gray (0 to 100) for ", key);
+        return Color::gray(int(pct));
+    }
+    const unsigned long rgb = strtoul(s.c_str(), &end, 16);
+    if (s.size() != 6 || *end != '\0')
+        fail(a, "bad color (RRGGBB, a name or gray(N)) for ", key);
+    return Color(uint8_t(rgb >> 16), uint8_t(rgb >> 8), uint8_t(rgb));
+}
+
+
+static const Font &font_arg(const Asset &a, std::string &name)
+{
+    name = str_arg(a, "font");
+    for (const auto &f : fonts)
+        if (name == f.name)
+            return *f.font;
+    fail(a, "unknown font ", name.c_str());
+    return *fonts[0].font; // not reached
+}
+
+
+// One dimension of an image: as given, N times the text's ("Nx"), or the
+// text's plus padding.
+static int dim_arg(const Asset &a, const char *key, int text, int pad)
+{
+    const std::string *v = a.get(key);
+    if (v == nullptr)
+        return text + 2 * pad;
+    if (v->empty() || v->back() != 'x')
+        return int_arg(a, key);
+    char *end;
+    const long n = strtol(v->c_str(), &end, 10);
+    if (end != v->c_str() + v->size() - 1 || n < 1 || n * text > 4096)
+        fail(a, "bad multiple for ", key);
+    return int(n) * text;
+}
+
+
+// An image's size, from its text's (or fit's).
+static void size_arg(const Asset &a, const Font &font, const std::string &txt,
+                     int &wid, int &hgt)
+{
+    const std::string *fit = a.get("fit");
+    const int pad = int_arg(a, "pad", 0);
+    wid = dim_arg(a, "wid", font.width((fit != nullptr ? *fit : txt).c_str()),
+                  pad);
+    hgt = dim_arg(a, "hgt", font.y_adv, pad);
+}
+
+
+// An identifier, as it will be used in C++.
+static std::string name_arg(const Asset &a)
+{
+    const std::string name = str_arg(a, "name");
+    bool ok = !name.empty() && !isdigit((unsigned char)name[0]);
+    for (char c : name)
+        ok &= isalnum((unsigned char)c) || c == '_';
+    if (!ok)
+        fail(a, "bad name ", name.c_str());
+    return name;
+}
+
+
+// label_img(), at run time
+static std::vector<GuiPixel> render(int wid, int hgt, const char *txt,
+                                    const Font &font, Color fg, int brd_thk,
+                                    Color brd_clr, Color bg)
+{
+    std::vector<GuiPixel> pixels(size_t(wid) * hgt, GuiPixel(bg));
+
+    if (brd_clr != Color::none()) {
+        for (int r = 0; r < hgt; r++) {
+            for (int c = 0; c < wid; c++) {
+                if (r < brd_thk || r >= hgt - brd_thk || c < brd_thk ||
+                    c >= wid - brd_thk)
+                    pixels[r * wid + c] = GuiPixel(brd_clr);
+            }
+        }
+    }
+
+    int col = (wid - font.width(txt)) / 2;
+    const int row = (hgt - font.y_adv) / 2;
+    for (const char *s = txt; *s != '\0'; s++) {
+        const Glyph *g = font.glyph(*s);
+        for (int y = 0; y < g->hgt; y++) {
+            for (int x = 0; x < g->wid; x++) {
+                int c = col + g->x_off + x;
+                int r = row + g->y_off + y;
+                int a = font.alpha(g, x, y);
+                if (a == 0 || c < 0 || c >= wid || r < 0 || r >= hgt)
+                    continue;
+                pixels[r * wid + c] = GuiPixel(fg.blend(bg, a));
+            }
+        }
+        col += g->x_adv;
+    }
+
+    return pixels;
+}
+
+
+// mask_img(), at run time
+static std::vector<uint8_t> render_mask(int wid, int hgt, int bpp,
+                                        const char *txt, const Font &font)
+{
+    std::vector<uint8_t> bits((size_t(wid) * hgt * bpp + 7) / 8, 0);
+
+    const int max = (1 << bpp) - 1;
+    int col = (wid - font.width(txt)) / 2;
+    const int row = (hgt - font.y_adv) / 2;
+    for (const char *s = txt; *s != '\0'; s++) {
+        const Glyph *g = font.glyph(*s);
+        for (int y = 0; y < g->hgt; y++) {
+            for (int x = 0; x < g->wid; x++) {
+                int c = col + g->x_off + x;
+                int r = row + g->y_off + y;
+                int a = font.alpha(g, x, y);
+                if (a == 0 || c < 0 || c >= wid || r < 0 || r >= hgt)
+                    continue;
+                int q = (a * max + 127) / 255;
+                if (q == 0)
+                    q = 1;
+                const int bit = (r * wid + c) * bpp;
+                bits[bit / 8] |= uint8_t(q << (8 - bpp - bit % 8));
+            }
+        }
+        col += g->x_adv;
+    }
+
+    return bits;
+}
+
+
+// One image: its header, then its bytes, in a section of its own (so the
+// linker drops images nothing uses).
+static void emit(std::ostringstream &out, const std::string &name,
+                 const char *hdr_type, const std::string &hdr,
+                 const char *data, const uint8_t *bytes, size_t cnt)
+{
+    out << "\nstatic const struct {\n"
+        << "    " << hdr_type << " hdr;\n"
+        << "    uint8_t " << data << "[" << cnt << "];\n"
+        << "} " << name << " __attribute__((aligned(4), section(\".rodata.gui_"
+        << name << "\"))) = {\n"
+        << "    " << hdr << ",\n"
+        << "    {";
+    for (size_t i = 0; i < cnt; i++) {
+        if (i % 12 == 0)
+            out << "\n       ";
+        char hex[8];
+        snprintf(hex, sizeof(hex), " 0x%02x,", bytes[i]);
+        out << hex;
+    }
+    out << "\n    },\n};\n";
+}
+
+
+static void emit(std::ostringstream &out, const std::string &name, int wid,
+                 int hgt, const std::vector<GuiPixel> &pixels)
+{
+    emit(out, name, "PixelImageHdr",
+         "{" + std::to_string(wid) + ", " + std::to_string(hgt) + "}",
+         "pixels", reinterpret_cast<const uint8_t *>(pixels.data()),
+         pixels.size() * sizeof(GuiPixel));
+}
+
+
+static const char *base_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    return slash == nullptr ? path : slash + 1;
+}
+
+
+static void header(std::ostringstream &out, const Asset &a)
+{
+    // no line number: moving an asset must not rewrite its header
+    out << "// Generated by gui_asset_gen from " << base_name(manifest_name)
+        << " (" << a.kind << "); do not edit.\n"
+        << "#pragma once\n\n"
+        << "#include <cstdint>\n"
+        << "// framebuffer\n"
+        << "#include \"pixel_image.h\"\n"
+        << "// gui\n"
+        << "#include \"gui_image.h\"\n"
+        << "#include \"gui_pixel.h\"\n\n"
+        << "static_assert(sizeof(GuiPixel) == " << sizeof(GuiPixel)
+        << ", \"regenerate for this GuiPixel\");\n";
+}
+
+
+// Write 'text' to 'path' unless it is already there.
+static void update(const std::string &path, const std::string &text)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (in) {
+        std::ostringstream old;
+        old << in.rdbuf();
+        if (old.str() == text)
+            return;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+    if (!out) {
+        fprintf(stderr, "%s: can't write\n", path.c_str());
+        exit(1);
+    }
+}
+
+
+// Split a manifest line into kind and key=value pairs (a value may be
+// quoted, with \" and \\ escapes).
+static bool parse(const std::string &line, Asset &a)
+{
+    size_t i = 0;
+    auto skip_space = [&] {
+        while (i < line.size() && isspace((unsigned char)line[i]))
+            i++;
+    };
+    skip_space();
+    if (i == line.size() || line[i] == '#')
+        return false;
+    while (i < line.size() && !isspace((unsigned char)line[i]))
+        a.kind += line[i++];
+    while (true) {
+        skip_space();
+        if (i == line.size() || line[i] == '#')
+            break;
+        std::string key;
+        while (i < line.size() && line[i] != '=' &&
+               !isspace((unsigned char)line[i]))
+            key += line[i++];
+        if (i == line.size() || line[i] != '=')
+            fail(a, "expected key=value at ", key.c_str());
+        i++;
+        std::string value;
+        if (i < line.size() && line[i] == '"') {
+            for (i++; i < line.size() && line[i] != '"'; i++) {
+                if (line[i] == '\\' && i + 1 < line.size())
+                    i++;
+                value += line[i];
+            }
+            if (i == line.size())
+                fail(a, "unterminated string for ", key.c_str());
+            i++;
+        } else {
+            while (i < line.size() && !isspace((unsigned char)line[i]))
+                value += line[i++];
+        }
+        a.args.emplace_back(key, value);
+    }
+    return true;
+}
+
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        fprintf(stderr, "usage: gui_asset_gen manifest out_dir\n");
+        return 1;
+    }
+    manifest_name = argv[1];
+    const std::string dir = argv[2];
+
+    std::ifstream in(manifest_name);
+    if (!in) {
+        fprintf(stderr, "%s: can't read\n", manifest_name);
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    std::string line;
+    for (int n = 1; std::getline(in, line); n++) {
+        Asset a;
+        a.line = n;
+        if (!parse(line, a))
+            continue;
+
+        std::ostringstream out;
+        header(out, a);
+        std::string file;
+        std::string font_name;
+
+        if (a.kind == "label") {
+            const std::string name = name_arg(a);
+            const Font &font = font_arg(a, font_name);
+            const std::string text = str_arg(a, "text");
+            int wid, hgt;
+            size_arg(a, font, text, wid, hgt);
+            emit(out, name + "_img", wid, hgt,
+                 render(wid, hgt, text.c_str(), font, color_arg(a, "fg"),
+                        int_arg(a, "brd", 0), color_arg(a, "brd_clr", "none"),
+                        color_arg(a, "bg")));
+            file = name;
+        } else if (a.kind == "button") {
+            const std::string name = name_arg(a);
+            const Font &font = font_arg(a, font_name);
+            const std::string text = str_arg(a, "text");
+            int wid, hgt;
+            size_arg(a, font, text, wid, hgt);
+            const Color fg = color_arg(a, "fg");
+            const int brd = int_arg(a, "brd");
+            emit(out, name + "_btn_up_img", wid, hgt,
+                 render(wid, hgt, text.c_str(), font, fg, brd, fg,
+                        color_arg(a, "up")));
+            emit(out, name + "_btn_dn_img", wid, hgt,
+                 render(wid, hgt, text.c_str(), font, fg, brd, fg,
+                        color_arg(a, "dn")));
+            file = name;
+        } else if (a.kind == "mask") {
+            const std::string name = name_arg(a);
+            const Font &font = font_arg(a, font_name);
+            const std::string text = str_arg(a, "text");
+            const int bpp = int_arg(a, "bpp");
+            if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8)
+                fail(a, "bpp must be 1, 2, 4 or 8");
+            int wid, hgt;
+            size_arg(a, font, text, wid, hgt);
+            const std::vector<uint8_t> bits =
+                render_mask(wid, hgt, bpp, text.c_str(), font);
+            emit(out, name + "_mask", "MaskImageHdr",
+                 "{{" + std::to_string(wid) + ", " + std::to_string(hgt) +
+                     "}, " + std::to_string(bpp) + "}",
+                 "bits", bits.data(), bits.size());
+            file = name;
+        } else if (a.kind == "digits") {
+            const Font &font = font_arg(a, font_name);
+            const Color fg = color_arg(a, "fg");
+            const Color bg = color_arg(a, "bg");
+            for (char d = '0'; d <= '9'; d++) {
+                const char txt[2] = {d, '\0'};
+                emit(out, font_name + "_" + d + "_img", font.width(txt),
+                     font.y_adv,
+                     render(font.width(txt), font.y_adv, txt, font, fg, 0,
+                            Color::none(), bg));
+            }
+            out << "\nstatic const PixelImageHdr *" << font_name
+                << "_digit_img[10] = {\n";
+            for (char d = '0'; d <= '9'; d++)
+                out << "    &" << font_name << "_" << d << "_img.hdr,\n";
+            out << "};\n";
+            file = font_name + "_digits";
+        } else {
+            fail(a, "unknown asset kind ", a.kind.c_str());
+        }
+
+        for (const std::string &f : files)
+            if (f == file)
+                fail(a, "duplicate asset ", file.c_str());
+        files.push_back(file);
+        update(dir + "/" + file + ".h", out.str());
+    }
+
+    std::ostringstream all;
+    all << "// Generated by gui_asset_gen from " << base_name(manifest_name)
+        << "; do not edit.\n"
+        << "#pragma once\n\n";
+    for (const std::string &f : files)
+        all << "#include \"" << f << ".h\"\n";
+    update(dir + "/gui_assets.h", all.str());
+
+    return 0;
+}
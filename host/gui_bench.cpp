@@ -0,0 +1,1119 @@
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+// framebuffer
+#include "color.h"
+#include "font.h"
+#include "pixel_565.h"
+#include "pixel_666.h"
+#include "pixel_image.h"
+// touchscreen
+#include "touchscreen.h"
+// gui
+#include "gui.h"
+// host
+#include "fb_record.h"
+#include "gui_render_thread.h"
+#include "host_font.h"
+#include "ts_script.h"
+
+// Usage: gui_bench [spi_baud [bench_name ...]]
+//
+// Each benchmark prints what went to the panel: address windows, pixels,
+// estimated bytes, and estimated milliseconds at the SPI baud (default
+// 15 MHz, what gui_test asks for).
+
+using HAlign = Framebuffer::HAlign;
+using Event = Touchscreen::Event;
+
+static uint32_t spi_baud = 15'000'000;
+
+// clang-format off
+namespace PageShow { static void run(); }
+namespace SliderDrag { static void run(); }
+namespace NumberUpdate { static void run(); }
+namespace HitTest { static void run(); }
+namespace RenderQueue { static void run(); }
+namespace Blit { static void run(); }
+namespace DisplayList { static void run(); }
+namespace Rle { static void run(); }
+namespace Mask { static void run(); }
+namespace StaticPage { static void run(); }
+namespace Text { static void run(); }
+namespace PageSwap { static void run(); }
+namespace Background { static void run(); }
+namespace Compose { static void run(); }
+namespace PixelFormat { static void run(); }
+// clang-format on
+
+static struct {
+    const char *name;
+    void (*func)();
+} benches[] = {
+    {"PageShow", PageShow::run},
+    {"SliderDrag", SliderDrag::run},
+    {"NumberUpdate", NumberUpdate::run},
+    {"HitTest", HitTest::run},
+    {"RenderQueue", RenderQueue::run},
+    {"Blit", Blit::run},
+    {"DisplayList", DisplayList::run},
+    {"Rle", Rle::run},
+    {"Mask", Mask::run},
+    {"StaticPage", StaticPage::run},
+    {"Text", Text::run},
+    {"PageSwap", PageSwap::run},
+    {"Background", Background::run},
+    {"Compose", Compose::run},
+    {"PixelFormat", PixelFormat::run},
+};
+static const int num_benches = sizeof(benches) / sizeof(benches[0]);
+
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+        spi_baud = strtoul(argv[1], nullptr, 0);
+
+    printf("spi: %lu Hz (max %lu bytes/sec)\n", (unsigned long)spi_baud,
+           (unsigned long)(spi_baud / 8));
+
+    for (int i = 0; i < num_benches; i++) {
+        bool selected = argc < 3;
+        for (int a = 2; a < argc; a++)
+            selected |= strcmp(argv[a], benches[i].name) == 0;
+        if (selected) {
+            printf("\n%s\n", benches[i].name);
+            benches[i].func();
+        }
+    }
+
+    return 0;
+}
+
+
+static void report(const char *what, const FbRecord &fb, int reps = 1)
+{
+    const FbRecord::Stats &s = fb.stats();
+    printf("  %-32s %8llu windows %10llu pixels %10llu bytes %9.3f ms\n", what,
+           (unsigned long long)(s.windows / reps),
+           (unsigned long long)(s.pixels / reps),
+           (unsigned long long)(s.bytes / reps), fb.us() / 1000.0 / reps);
+}
+
+
+// route an event the way gui_test does: focus first, then the page
+static void dispatch(GuiPage &page, Event &event)
+{
+    if (GuiWidget::focus != nullptr)
+        GuiWidget::focus->event(event);
+    else
+        page.event(event);
+}
+
+
+static constexpr Color screen_fg = Color::black();
+static constexpr Color screen_bg = Color::white();
+
+static constexpr Font font = host_font_24;
+
+DIGIT_IMAGE_ARRAY(host_font_48, screen_fg, screen_bg);
+
+static constexpr int lbl_wid = 120;
+static constexpr int lbl_hgt = font.y_adv;
+
+static constexpr PixelImage<Pixel565, lbl_wid, lbl_hgt> lbl_img =
+    label_img<Pixel565, lbl_wid, lbl_hgt>("Label", font, screen_fg, screen_bg);
+
+static constexpr int btn_wid = 160;
+static constexpr int btn_hgt = font.y_adv + 12;
+
+static constexpr PixelImage<Pixel565, btn_wid, btn_hgt> btn_up_img =
+    label_img<Pixel565, btn_wid, btn_hgt>("Button", font, screen_fg, 4,
+                                          screen_fg, Color::gray(80));
+
+static constexpr PixelImage<Pixel565, btn_wid, btn_hgt> btn_dn_img =
+    label_img<Pixel565, btn_wid, btn_hgt>("Button", font, screen_fg, 6,
+                                          screen_fg, Color::red());
+
+static void nop(intptr_t)
+{
+}
+
+
+namespace PageShow {
+
+static constexpr PixelImage<Pixel565, 200, 130> dlg_img =
+    label_img<Pixel565, 200, 130>("Dialog", font, screen_fg, 2, screen_fg,
+                                  Color::gray(90));
+
+static void overdraw(const GuiPage &page)
+{
+    const GuiPage::Overdraw od = page.overdraw();
+    printf("  %-32s %8.3f (%lu painted / %lu visible pixels)\n", "overdraw",
+           double(od.ratio()), (unsigned long)od.painted,
+           (unsigned long)od.visible);
+}
+
+static void run()
+{
+    FbRecord fb(480, 320, spi_baud);
+
+    GuiLabel l0(fb, 10, 60, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiLabel l1(fb, 10, 100, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiLabel l2(fb, 10, 140, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiButton b0(fb, 0, 0, screen_bg, &btn_up_img.hdr, &btn_up_img.hdr,
+                 &btn_dn_img.hdr, nop, 0, nop, 0, nop, 0);
+    GuiButton b1(fb, 160, 0, screen_bg, &btn_up_img.hdr, &btn_up_img.hdr,
+                 &btn_dn_img.hdr, nop, 0, nop, 0, nop, 0);
+    GuiNumber n0(fb, 400, 200, screen_bg, host_font_48_digit_img, 12345,
+                 HAlign::Right);
+    GuiSlider s0(fb, 40, 260, 400, 40, screen_fg, screen_bg, Color::gray(90),
+                 Color::white(), 0, 100, 50, nop, 0);
+    GuiPage page({&l0, &l1, &l2, &b0, &b1, &n0, &s0});
+
+    fb.reset_stats();
+    page.visible(true);
+    report("show", fb);
+    overdraw(page);
+
+    fb.reset_stats();
+    page.visible(false);
+    report("hide", fb);
+
+    // the same page with a dialog over the labels
+    GuiLabel dlg(fb, 0, 50, screen_bg, &dlg_img.hdr, &dlg_img.hdr);
+    GuiPage page2({&l0, &l1, &l2, &b0, &b1, &n0, &s0, &dlg});
+    fb.reset_stats();
+    page2.visible(true);
+    report("show, dialog over labels", fb);
+    overdraw(page2);
+}
+
+} // namespace PageShow
+
+
+namespace SliderDrag {
+
+static GuiNumber *num = nullptr;
+static GuiSlider *sld = nullptr;
+
+static void on_value(intptr_t)
+{
+    num->set_value(sld->get_value());
+}
+
+// samples_per_frame > 1 models touch samples arriving faster than the page
+// redraws; they go through a GuiEventQueue
+static void drag(const char *what, bool deferred, int samples_per_frame = 1)
+{
+    FbRecord fb(480, 320, spi_baud);
+
+    GuiNumber n(fb, 100, 140, screen_bg, host_font_48_digit_img, 0,
+                HAlign::Right);
+    GuiSlider s(fb, 120, 140, 340, 40, screen_fg, screen_bg, Color::gray(90),
+                Color::white(), 0, 100, 0, on_value, 0);
+    GuiPage page({&n, &s});
+    num = &n;
+    sld = &s;
+
+    page.deferred(deferred);
+    page.visible(true);
+
+    // full-length drag, several touch samples per value step
+    TsScript ts;
+    ts.drag(120, 160, 460, 160, 400);
+
+    fb.reset_stats();
+    if (samples_per_frame == 1) {
+        while (ts.pending() > 0) {
+            Event event(ts.get_event());
+            dispatch(page, event);
+            page.flush();
+        }
+    } else {
+        GuiEventQueue events;
+        while (ts.pending() > 0 || !events.empty()) {
+            for (int i = 0; i < samples_per_frame && ts.pending() > 0; i++)
+                events.push(ts.get_event());
+            while (events.dispatch(page))
+                ;
+            page.flush();
+        }
+    }
+    report(what, fb);
+}
+
+static void run()
+{
+    drag("drag, immediate", false);
+    drag("drag, deferred", true);
+    drag("drag, queued, 4 samples/frame", true, 4);
+}
+
+} // namespace SliderDrag
+
+
+namespace NumberUpdate {
+
+// Per update. "erase+draw" is what set_value() used to do: erase the old
+// number, then draw every digit of the new one.
+static void update(const char *what, int from, int to, int step)
+{
+    for (int pass = 0; pass < 2; pass++) {
+        FbRecord fb(480, 320, spi_baud);
+
+        GuiNumber n(fb, 240, 140, screen_bg, host_font_48_digit_img, from,
+                    HAlign::Center);
+        GuiPage page({&n});
+        page.visible(true);
+
+        fb.reset_stats();
+        int reps = 0;
+        for (int v = from + step; v <= to; v += step, reps++) {
+            if (pass == 1)
+                n.erase();
+            n.set_value(v);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "%s, %s", what,
+                 pass == 0 ? "digit diff" : "erase+draw");
+        report(name, fb, reps);
+    }
+}
+
+static void run()
+{
+    update("count by 1", 0, 9999, 1);
+    update("4999 -> 5000", 4999, 5000, 1);
+    update("count by 37", 0, 99999, 37);
+}
+
+} // namespace NumberUpdate
+
+
+namespace HitTest {
+
+// A busy page: max_widgets widgets, mostly labels, in a 6 x 5 grid.
+static void run()
+{
+    FbRecord fb(480, 320, spi_baud);
+
+    static constexpr int cols = 6;
+    static constexpr int rows = 5;
+    static constexpr int cell_wid = 480 / cols;
+    static constexpr int cell_hgt = 320 / rows;
+
+    GuiLabel *labels[cols * rows] = {};
+    GuiButton *buttons[cols * rows] = {};
+    GuiWidget *widgets[cols * rows];
+    for (int i = 0; i < cols * rows; i++) {
+        int c = (i % cols) * cell_wid;
+        int r = (i / cols) * cell_hgt;
+        // every fifth widget is a button
+        if ((i % 5) == 4) {
+            buttons[i] = new GuiButton(fb, c, r, screen_bg, &lbl_img.hdr,
+                                       &lbl_img.hdr, &lbl_img.hdr, nop, 0, nop,
+                                       0, nop, 0);
+            widgets[i] = buttons[i];
+        } else {
+            labels[i] = new GuiLabel(fb, c, r, screen_bg, &lbl_img.hdr,
+                                     &lbl_img.hdr);
+            widgets[i] = labels[i];
+        }
+    }
+    GuiPage page({widgets[0],  widgets[1],  widgets[2],  widgets[3],
+                  widgets[4],  widgets[5],  widgets[6],  widgets[7],
+                  widgets[8],  widgets[9],  widgets[10], widgets[11],
+                  widgets[12], widgets[13], widgets[14], widgets[15],
+                  widgets[16], widgets[17], widgets[18], widgets[19],
+                  widgets[20], widgets[21], widgets[22], widgets[23],
+                  widgets[24], widgets[25], widgets[26], widgets[27],
+                  widgets[28], widgets[29]});
+    page.visible(true);
+
+    // 'up' events with nothing focused are claimed without redrawing, so
+    // this times just the dispatch
+    static constexpr int events = 200'000;
+    for (int pass = 0; pass < 2; pass++) {
+        page.indexed(pass == 0);
+        unsigned seed = 1;
+        int claimed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < events; i++) {
+            seed = seed * 1103515245 + 12345;
+            Event event(Event::Type::up, (seed >> 8) % 480, (seed >> 20) % 320);
+            if (page.event(event))
+                claimed++;
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+        printf("  %-32s %8.1f ns/event (%d of %d claimed)\n",
+               pass == 0 ? "indexed" : "linear scan", double(ns) / events,
+               claimed, events);
+    }
+
+    for (int i = 0; i < cols * rows; i++) {
+        delete labels[i];
+        delete buttons[i];
+    }
+}
+
+} // namespace HitTest
+
+
+namespace RenderQueue {
+
+static GuiNumber *num = nullptr;
+static GuiSlider *sld = nullptr;
+
+static void on_value(intptr_t)
+{
+    num->set_value(sld->get_value());
+}
+
+static double ms_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// SliderDrag's deferred drag against a panel that takes the SPI time for
+// each write, timing the GUI core: with the queue it only waits for the
+// render core when the ring is full.
+static void drag(const char *what, GuiRenderQueue *queue)
+{
+    FbRecord fb(480, 320, spi_baud);
+    fb.paced(true);
+
+    GuiNumber n(fb, 100, 140, screen_bg, host_font_48_digit_img, 0,
+                HAlign::Right);
+    GuiSlider s(fb, 120, 140, 340, 40, screen_fg, screen_bg, Color::gray(90),
+                Color::white(), 0, 100, 0, on_value, 0);
+    GuiPage page({&n, &s});
+    num = &n;
+    sld = &s;
+
+    page.deferred(true);
+    page.visible(true);
+
+    TsScript ts;
+    ts.drag(120, 160, 460, 160, 400);
+
+    fb.reset_stats();
+    double gui_ms = 0;
+    double max_frame_ms = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        GuiRenderThread *render = nullptr;
+        if (queue != nullptr) {
+            render = new GuiRenderThread(*queue);
+            GuiWidget::canvas = queue;
+        }
+        while (ts.pending() > 0) {
+            auto frame = std::chrono::steady_clock::now();
+            Event event(ts.get_event());
+            dispatch(page, event);
+            page.flush();
+            const double frame_ms = ms_since(frame);
+            gui_ms += frame_ms;
+            if (frame_ms > max_frame_ms)
+                max_frame_ms = frame_ms;
+        }
+        GuiWidget::canvas = nullptr;
+        delete render; // waits for everything queued
+    }
+    const double total_ms = ms_since(start);
+
+    report(what, fb);
+    printf("  %-32s %8.3f ms gui core (max %.3f ms/frame), %.3f ms total\n",
+           "", gui_ms, max_frame_ms, total_ms);
+    if (queue != nullptr)
+        printf("  %-32s %8lu full waits\n", "",
+               (unsigned long)queue->full_waits());
+}
+
+static void run()
+{
+    drag("drag, direct", nullptr);
+    GuiRenderQueue queue;
+    drag("drag, render queue", &queue);
+}
+
+} // namespace RenderQueue
+
+
+namespace Blit {
+
+// a full-screen gradient, computed a row at a time
+class Gradient : public GuiBlit::Source
+{
+public:
+
+    virtual int width() const override
+    {
+        return 480;
+    }
+
+    virtual int height() const override
+    {
+        return 320;
+    }
+
+    virtual void rows(int row, int cnt, Pixel565 *dst) const override
+    {
+        for (int r = row; r < row + cnt; r++)
+            for (int c = 0; c < 480; c++)
+                *dst++ = Pixel565(Color(uint8_t(c * 255 / 479),
+                                        uint8_t(r * 255 / 319), 128));
+    }
+};
+
+static void blit(const char *what, GuiRenderQueue *queue)
+{
+    FbRecord fb(480, 320, spi_baud);
+    fb.paced(true);
+
+    // 8 rows per strip
+    static constexpr int work_bytes = 2 * (16 + 8 * 480 * 2);
+    alignas(8) static uint8_t work[work_bytes];
+    GuiBlit b(work, work_bytes, queue);
+    const Gradient src;
+
+    GuiRenderThread *render = queue ? new GuiRenderThread(*queue) : nullptr;
+
+    static constexpr int reps = 4;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++) {
+        b.start(fb, 0, 0, src);
+        b.wait();
+    }
+    const double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    delete render;
+
+    report(what, fb, reps);
+    printf("  %-32s %8.3f ms per screen, %lu strip waits\n", "", ms / reps,
+           (unsigned long)b.strip_waits() / reps);
+}
+
+static void run()
+{
+    blit("gradient, direct", nullptr);
+    GuiRenderQueue queue;
+    blit("gradient, double-buffered", &queue);
+}
+
+} // namespace Blit
+
+
+namespace DisplayList {
+
+// A framebuffer that throws everything away, so only the GUI's own work is
+// timed.
+class FbNull : public Framebuffer
+{
+public:
+
+    FbNull() : Framebuffer(480, 320)
+    {
+    }
+
+    virtual void fill_rect(int, int, int, int, Color) override
+    {
+        ops++;
+    }
+
+    virtual void write(int, int, const PixelImageHdr *) override
+    {
+        ops++;
+    }
+
+    uint64_t ops = 0;
+};
+
+// A page like NavGroup1's page 2: three sliders, each with a label and a
+// number. Times the GUI's part of drawing it; the panel gets the same
+// either way.
+static void run()
+{
+    FbNull fb;
+
+    GuiLabel l0(fb, 10, 20, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiLabel l1(fb, 10, 120, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiLabel l2(fb, 10, 220, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiNumber n0(fb, 220, 10, screen_bg, host_font_48_digit_img, 25,
+                 HAlign::Right);
+    GuiNumber n1(fb, 220, 110, screen_bg, host_font_48_digit_img, 50,
+                 HAlign::Right);
+    GuiNumber n2(fb, 220, 210, screen_bg, host_font_48_digit_img, 75,
+                 HAlign::Right);
+    GuiSlider s0(fb, 240, 20, 220, 40, screen_fg, screen_bg, Color::gray(90),
+                 Color::white(), 0, 100, 25, nullptr, 0);
+    GuiSlider s1(fb, 240, 120, 220, 40, screen_fg, screen_bg, Color::gray(90),
+                 Color::white(), 0, 100, 50, nullptr, 0);
+    GuiSlider s2(fb, 240, 220, 220, 40, screen_fg, screen_bg, Color::gray(90),
+                 Color::white(), 0, 100, 75, nullptr, 0);
+    GuiPage page({&l0, &n0, &s0, &l1, &n1, &s1, &l2, &n2, &s2});
+    page.visible(true);
+
+    static constexpr int max_ops = 64;
+    GuiDisplayList::Op ops[max_ops];
+    GuiDisplayList list(ops, max_ops);
+
+    // Passes 2 and 3 change one slider per draw (which redraws the slider
+    // as it would anyway), so with a list it is recorded each time.
+    static constexpr int reps = 100'000;
+    static const char *const whats[] = {
+        "draw widgets",
+        "replay list",
+        "draw widgets, one slider changed",
+        "replay, one slider changed",
+    };
+    for (int pass = 0; pass < 4; pass++) {
+        page.display_list(pass % 2 == 0 ? nullptr : &list);
+        fb.ops = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; i++) {
+            if (pass >= 2)
+                s1.set_value(i % 101);
+            page.draw();
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+        const char *what = whats[pass];
+        printf("  %-32s %8.1f ns/draw, %llu writes/draw\n", what,
+               double(ns) / reps, (unsigned long long)(fb.ops / reps));
+    }
+    printf("  list: %d ops, %d bytes, %d bytes/op\n", list.size(), list.bytes(),
+           int(sizeof(GuiDisplayList::Op)));
+}
+
+} // namespace DisplayList
+
+
+namespace Rle {
+
+// gui_test's nav buttons: three 160 x 48 states each, raw and run-length
+// encoded.
+
+static constexpr int nav_wid = 160;
+static constexpr int nav_hgt = font.y_adv + 12;
+
+static constexpr PixelImage<Pixel565, nav_wid, nav_hgt> raw_ena =
+    label_img<Pixel565, nav_wid, nav_hgt>("PAGE 0", font, screen_fg, 2,
+                                          screen_fg, Color::gray(80));
+static constexpr PixelImage<Pixel565, nav_wid, nav_hgt> raw_dis =
+    label_img<Pixel565, nav_wid, nav_hgt>("PAGE 0", font, screen_fg, 6,
+                                          screen_fg, Color::gray(95));
+static constexpr PixelImage<Pixel565, nav_wid, nav_hgt> raw_prs =
+    label_img<Pixel565, nav_wid, nav_hgt>("PAGE 0", font, screen_fg, 4,
+                                          screen_fg, Color::red());
+
+RLE_LABEL_IMG(rle_ena, nav_wid, nav_hgt, "PAGE 0", font, screen_fg, 2,
+              screen_fg, Color::gray(80));
+RLE_LABEL_IMG(rle_dis, nav_wid, nav_hgt, "PAGE 0", font, screen_fg, 6,
+              screen_fg, Color::gray(95));
+RLE_LABEL_IMG(rle_prs, nav_wid, nav_hgt, "PAGE 0", font, screen_fg, 4,
+              screen_fg, Color::red());
+
+static void blit(const char *what, const GuiImage &img, int flash_bytes)
+{
+    FbRecord fb(480, 320, spi_baud);
+    static constexpr int reps = 2000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++)
+        img.write(fb, 0, 0);
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    report(what, fb, reps);
+    printf("  %-32s %8.0f ns/draw (gui side), %d flash bytes read\n", "",
+           double(ns) / reps, flash_bytes);
+}
+
+static void run()
+{
+    const int raw = sizeof(raw_ena) + sizeof(raw_dis) + sizeof(raw_prs);
+    const int rle = sizeof(rle_ena) + sizeof(rle_dis) + sizeof(rle_prs);
+    printf("  %-32s %8d bytes raw, %d bytes rle (%.1f%%)\n",
+           "flash, 3 button states", raw, rle, 100.0 * rle / raw);
+
+    blit("raw", &raw_ena.hdr, sizeof(raw_ena));
+    blit("rle", &rle_ena.hdr, sizeof(rle_ena));
+
+    // The RP2040 XIP cache is 16 KB: three raw button states don't fit and
+    // every redraw misses; the rle states fit several times over.
+    printf("  %-32s %8.2f raw, %.2f rle (of the 16 KB XIP cache)\n",
+           "cache footprint, 3 states", raw / 16384.0, rle / 16384.0);
+}
+
+} // namespace Rle
+
+
+namespace Mask {
+
+// The same three nav button states as one text mask and three palettes, at
+// 1, 2 and 4 bits of coverage; and ten digits that GuiNumber draws in an
+// enabled or a disabled color.
+
+using Rle::nav_wid;
+using Rle::nav_hgt;
+
+MASK_LABEL_IMG(mask_1, 1, nav_wid, nav_hgt, "PAGE 0", font);
+MASK_LABEL_IMG(mask_2, 2, nav_wid, nav_hgt, "PAGE 0", font);
+MASK_LABEL_IMG(mask_4, 4, nav_wid, nav_hgt, "PAGE 0", font);
+
+static const GuiPalette pal_ena = {screen_fg, 2, screen_fg, Color::gray(80)};
+
+MASK_DIGIT_ARRAY(host_font_48, 4);
+
+static void run()
+{
+    const int raw = sizeof(Rle::raw_ena) * 3;
+    const int pal = 3 * sizeof(GuiPalette);
+    printf("  %-32s %8d bytes raw, %d bytes rle\n", "flash, 3 button states",
+           raw, int(sizeof(Rle::rle_ena) + sizeof(Rle::rle_dis) +
+                    sizeof(Rle::rle_prs)));
+    const int mask[] = {int(sizeof(mask_1)), int(sizeof(mask_2)),
+                        int(sizeof(mask_4))};
+    for (int i = 0; i < 3; i++)
+        printf("  %-32s %8d bytes %d-bit mask + palettes (%.1f%%)\n", "",
+               mask[i] + pal, 1 << i, 100.0 * (mask[i] + pal) / raw);
+
+    Rle::blit("mask 1-bit", GuiImage(&mask_1.hdr, &pal_ena), sizeof(mask_1));
+    Rle::blit("mask 4-bit", GuiImage(&mask_4.hdr, &pal_ena), sizeof(mask_4));
+
+    int dig_raw = 0;
+    int dig_mask = 0;
+    for (int d = 0; d < 10; d++) {
+        const PixelImageHdr *hdr = host_font_48_digit_img[d];
+        dig_raw += int(sizeof(PixelImageHdr)) +
+                   hdr->wid * hdr->hgt * int(sizeof(Pixel565));
+        const MaskImageHdr *mask = host_font_48_digit_mask[d];
+        dig_mask += int(sizeof(MaskImageHdr)) +
+                    (mask->hdr.wid * mask->hdr.hgt * mask->bpp + 7) / 8;
+    }
+    printf("  %-32s %8d bytes raw, %d bytes 4-bit mask + palettes\n",
+           "flash, digits enabled+disabled", 2 * dig_raw,
+           dig_mask + 2 * int(sizeof(GuiPalette)));
+}
+
+} // namespace Mask
+
+
+namespace StaticPage {
+
+// DisplayList's page (three labels, numbers and sliders) as a GuiPage and
+// as a GuiStaticPage: time spent calling the widgets, and RAM per page.
+
+using DisplayList::FbNull;
+
+struct Widgets {
+    GuiLabel l0, l1, l2;
+    GuiNumber n0, n1, n2;
+    GuiSlider s0, s1, s2;
+
+    Widgets(Framebuffer &fb) :
+        l0(fb, 10, 20, screen_bg, &lbl_img.hdr, &lbl_img.hdr),
+        l1(fb, 10, 120, screen_bg, &lbl_img.hdr, &lbl_img.hdr),
+        l2(fb, 10, 220, screen_bg, &lbl_img.hdr, &lbl_img.hdr),
+        n0(fb, 220, 10, screen_bg, host_font_48_digit_img, 25, HAlign::Right),
+        n1(fb, 220, 110, screen_bg, host_font_48_digit_img, 50, HAlign::Right),
+        n2(fb, 220, 210, screen_bg, host_font_48_digit_img, 75, HAlign::Right),
+        s0(fb, 240, 20, 220, 40, screen_fg, screen_bg, Color::gray(90),
+           Color::white(), 0, 100, 25, nullptr, 0),
+        s1(fb, 240, 120, 220, 40, screen_fg, screen_bg, Color::gray(90),
+           Color::white(), 0, 100, 50, nullptr, 0),
+        s2(fb, 240, 220, 220, 40, screen_fg, screen_bg, Color::gray(90),
+           Color::white(), 0, 100, 75, nullptr, 0)
+    {
+    }
+};
+
+// owning its widgets (calls are direct), and referring to them (calls to
+// GuiLabel, which is not final, stay virtual)
+using Static = GuiStaticPage<GuiLabel, GuiNumber, GuiSlider,
+                             GuiLabel, GuiNumber, GuiSlider,
+                             GuiLabel, GuiNumber, GuiSlider>;
+using StaticRefs = GuiStaticPage<GuiLabel &, GuiNumber &, GuiSlider &,
+                                 GuiLabel &, GuiNumber &, GuiSlider &,
+                                 GuiLabel &, GuiNumber &, GuiSlider &>;
+
+static constexpr int reps = 200'000;
+
+template <typename PAGE>
+static void measure(const char *what, PAGE &page)
+{
+    // a tap between the widgets is offered to all of them
+    Event down(Event::Type::down, 200, 300);
+    Event up(Event::Type::up, 200, 300);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++)
+        page.draw();
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++) {
+        page.event(down);
+        page.event(up);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    using ns = std::chrono::nanoseconds;
+    printf("  %-32s %8.1f ns/draw %8.1f ns/tap\n", what,
+           double(std::chrono::duration_cast<ns>(mid - start).count()) / reps,
+           double(std::chrono::duration_cast<ns>(end - mid).count()) / reps);
+}
+
+static void run()
+{
+    FbNull fb;
+    Widgets w(fb);
+    GuiPage page(
+        {&w.l0, &w.n0, &w.s0, &w.l1, &w.n1, &w.s1, &w.l2, &w.n2, &w.s2});
+    page.visible(true);
+    measure("GuiPage, indexed", page);
+    page.indexed(false);
+    measure("GuiPage, linear", page);
+
+    FbNull fb_s;
+    Widgets ws(fb_s);
+    Static spage(ws.l0, ws.n0, ws.s0, ws.l1, ws.n1, ws.s1, ws.l2, ws.n2,
+                 ws.s2);
+    spage.visible(true);
+    measure("GuiStaticPage", spage);
+
+    GuiPageAdapter<Static> adapter(spage);
+    GuiPageBase &base = adapter;
+    measure("GuiStaticPage, via adapter", base);
+
+    StaticRefs rpage(ws.l0, ws.n0, ws.s0, ws.l1, ws.n1, ws.s1, ws.l2, ws.n2,
+                     ws.s2);
+    rpage.visible(true);
+    measure("GuiStaticPage of references", rpage);
+
+    printf("  %-32s %8d GuiPage, %d GuiStaticPage of references\n",
+           "RAM per page (bytes)", int(sizeof(GuiPage)),
+           int(sizeof(StaticRefs)));
+}
+
+} // namespace StaticPage
+
+
+namespace Text {
+
+// A status line with a changing value, drawn at runtime: each glyph blended
+// as it is drawn, or copied from glyph caches of a few sizes.
+
+using DisplayList::FbNull;
+
+static uint8_t cache_mem[16384];
+
+static void measure(const char *what, GuiGlyphCache *cache)
+{
+    FbNull fb;
+    GuiImage::glyph_cache = cache;
+    GuiText txt(fb, 10, 10, screen_bg, font, screen_fg, "");
+
+    static constexpr int reps = 20'000;
+    char buf[GuiText::max_len + 1];
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++) {
+        snprintf(buf, sizeof(buf), "Battery %d.%02d V, %d%%", 3 + i % 2,
+                 i % 100, i % 101);
+        txt.set_text(buf);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    GuiImage::glyph_cache = nullptr;
+
+    printf("  %-32s %8.0f ns/draw", what, double(ns) / reps);
+    if (cache != nullptr)
+        printf(", %.1f%% hits", 100.0 * cache->hit_rate());
+    printf("\n");
+}
+
+static void run()
+{
+    measure("no cache", nullptr);
+    const int slots[] = {4, 8, 16, 32};
+    for (int s : slots) {
+        GuiGlyphCache cache(cache_mem, sizeof(cache_mem), s);
+        char what[40];
+        snprintf(what, sizeof(what), "cache, %d slots of %d bytes", s,
+                 cache.slot_bytes());
+        measure(what, &cache);
+    }
+}
+
+} // namespace Text
+
+
+namespace PageSwap {
+
+// Two pages with the same buttons and slider, and different labels and
+// numbers, as when switching between pages of a nav group: hide one and
+// show the other, or GuiPageBase::swap().
+
+struct Pages {
+    GuiButton a_b0, a_b1;
+    GuiLabel a_l0, a_l1;
+    GuiSlider a_s0;
+    GuiPage a;
+    GuiButton b_b0, b_b1;
+    GuiLabel b_l0;
+    GuiNumber b_n0;
+    GuiSlider b_s0;
+    GuiPage b;
+
+    Pages(Framebuffer &fb) :
+        a_b0(fb, 0, 0, screen_bg, &btn_up_img.hdr, &btn_up_img.hdr,
+             &btn_dn_img.hdr, nop, 0, nop, 0, nop, 0),
+        a_b1(fb, 160, 0, screen_bg, &btn_up_img.hdr, &btn_up_img.hdr,
+             &btn_dn_img.hdr, nop, 0, nop, 0, nop, 0),
+        a_l0(fb, 10, 60, screen_bg, &lbl_img.hdr, &lbl_img.hdr),
+        a_l1(fb, 10, 100, screen_bg, &lbl_img.hdr, &lbl_img.hdr),
+        a_s0(fb, 40, 260, 400, 40, screen_fg, screen_bg, Color::gray(90),
+             Color::white(), 0, 100, 50, nop, 0),
+        a({&a_b0, &a_b1, &a_l0, &a_l1, &a_s0}),
+        b_b0(fb, 0, 0, screen_bg, &btn_up_img.hdr, &btn_up_img.hdr,
+             &btn_dn_img.hdr, nop, 0, nop, 0, nop, 0),
+        b_b1(fb, 160, 0, screen_bg, &btn_up_img.hdr, &btn_up_img.hdr,
+             &btn_dn_img.hdr, nop, 0, nop, 0, nop, 0),
+        b_l0(fb, 10, 80, screen_bg, &lbl_img.hdr, &lbl_img.hdr),
+        b_n0(fb, 400, 160, screen_bg, host_font_48_digit_img, 12345,
+             HAlign::Right),
+        b_s0(fb, 40, 260, 400, 40, screen_fg, screen_bg, Color::gray(90),
+             Color::white(), 0, 100, 20, nop, 0),
+        b({&b_b0, &b_b1, &b_l0, &b_n0, &b_s0})
+    {
+    }
+};
+
+static void run()
+{
+    FbRecord fb(480, 320, spi_baud);
+    Pages p(fb);
+
+    p.a.visible(true);
+    fb.reset_stats();
+    p.a.visible(false);
+    p.b.visible(true);
+    report("hide a, show b", fb);
+
+    fb.reset_stats();
+    p.b.visible(false);
+    p.a.visible(true);
+    report("hide b, show a", fb);
+
+    fb.reset_stats();
+    GuiPageBase::Swap s = GuiPageBase::swap(p.a, p.b);
+    report("swap a to b", fb);
+    printf("  %-32s %8lu erased %10lu saved\n", "", (unsigned long)s.erased,
+           (unsigned long)s.saved);
+
+    fb.reset_stats();
+    s = GuiPageBase::swap(p.b, p.a);
+    report("swap b to a", fb);
+    printf("  %-32s %8lu erased %10lu saved\n", "", (unsigned long)s.erased,
+           (unsigned long)s.saved);
+}
+
+} // namespace PageSwap
+
+
+namespace Background {
+
+// Hiding a label, over a solid color and over a gradient: the erase sends
+// the label's area either way (only the window count differs), and after
+// the first time the gradient's tiles come from the cache.
+
+static uint8_t mem[16 * 1024];
+
+static void run()
+{
+    FbRecord fb(480, 320, spi_baud);
+    const GuiBackground::GradientSource grad(Color::gray(90), Color::gray(40),
+                                             320);
+    GuiBackground bg(grad, mem, sizeof(mem));
+    GuiLabel l0(fb, 10, 60, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+
+    fb.reset_stats();
+    l0.erase();
+    report("erase, color", fb);
+
+    fb.reset_stats();
+    bg.restore(fb, 0, 0, fb.width(), fb.height());
+    report("whole screen, gradient", fb);
+
+    l0.background(&bg);
+    bg.clear();
+    bg.reset_stats();
+    fb.reset_stats();
+    l0.erase();
+    report("erase, gradient (cold)", fb);
+
+    fb.reset_stats();
+    const int reps = 100;
+    for (int i = 0; i < reps; i++)
+        l0.erase();
+    report("erase, gradient (cached)", fb, reps);
+    printf("  %-32s %8.1f%%\n", "tile hit rate", 100.0 * bg.hit_rate());
+}
+
+} // namespace Background
+
+
+namespace Compose {
+
+// Showing a page straight to the panel and through a GuiCompositor, with
+// bands from a 16 KB and a 4 KB work buffer: controls drawn in many small
+// windows, labels overlapping, and PageShow's dialog over labels (which
+// occlusion culling already handles).
+
+static constexpr PixelImage<Pixel565, 200, 130> dlg_img =
+    label_img<Pixel565, 200, 130>("Dialog", font, screen_fg, 2, screen_fg,
+                                  Color::gray(90));
+
+static uint8_t work[16 * 1024];
+
+static void show(const char *what, GuiPage &page, FbRecord &fb,
+                 GuiCompositor *comp)
+{
+    page.visible(false);
+    page.compositor(comp);
+    fb.reset_stats();
+    page.visible(true);
+    report(what, fb);
+}
+
+static void run()
+{
+    FbRecord fb(480, 320, spi_baud);
+    GuiCompositor big(work, sizeof(work));
+    GuiCompositor small(work, sizeof(work) / 4);
+
+    GuiSlider sld(fb, 40, 200, 400, 40, screen_fg, screen_bg, Color::gray(90),
+                  Color::white(), 0, 100, 50, nop, 0);
+    GuiNumber n0(fb, 40, 140, screen_bg, host_font_48_digit_img, 12345);
+    GuiNumber n1(fb, 440, 140, screen_bg, host_font_48_digit_img, 678,
+                 HAlign::Right);
+    GuiPage controls({&sld, &n0, &n1});
+    show("controls, direct", controls, fb, nullptr);
+    show("controls, composed 16 KB", controls, fb, &big);
+    show("controls, composed 4 KB", controls, fb, &small);
+    controls.visible(false);
+
+    // each label half under the next
+    GuiLabel s0(fb, 10, 10, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiLabel s1(fb, 70, 10 + lbl_hgt / 2, screen_bg, &lbl_img.hdr,
+                &lbl_img.hdr);
+    GuiLabel s2(fb, 130, 10 + lbl_hgt, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiLabel s3(fb, 190, 10 + 3 * lbl_hgt / 2, screen_bg, &lbl_img.hdr,
+                &lbl_img.hdr);
+    GuiPage stack({&s0, &s1, &s2, &s3});
+    show("stack, direct", stack, fb, nullptr);
+    show("stack, composed 16 KB", stack, fb, &big);
+    show("stack, composed 4 KB", stack, fb, &small);
+    stack.visible(false);
+
+    GuiLabel m0(fb, 10, 60, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiLabel m1(fb, 10, 100, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiLabel m2(fb, 10, 140, screen_bg, &lbl_img.hdr, &lbl_img.hdr);
+    GuiButton c0(fb, 0, 0, screen_bg, &btn_up_img.hdr, &btn_up_img.hdr,
+                 &btn_dn_img.hdr, nop, 0, nop, 0, nop, 0);
+    GuiButton c1(fb, 160, 0, screen_bg, &btn_up_img.hdr, &btn_up_img.hdr,
+                 &btn_dn_img.hdr, nop, 0, nop, 0, nop, 0);
+    GuiLabel dlg(fb, 0, 50, screen_bg, &dlg_img.hdr, &dlg_img.hdr);
+    GuiPage dialog({&m0, &m1, &m2, &c0, &c1, &dlg});
+    show("dialog, direct", dialog, fb, nullptr);
+    show("dialog, composed 16 KB", dialog, fb, &big);
+    show("dialog, composed 4 KB", dialog, fb, &small);
+}
+
+} // namespace Compose
+
+
+namespace PixelFormat {
+
+// A button image sent to a panel in 18-bit mode: stored as RGB565 and
+// converted pixel by pixel into the line buffer on every write, or stored
+// pre-encoded as RGB666 (GUI_PIXEL=Pixel666) and copied straight. The bus
+// carries three bytes per pixel either way; what differs is the CPU time
+// per write (host time here) and the flash per image. RGB565 to an RGB565
+// panel is the straight copy the library does by default.
+
+static constexpr PixelImage<Pixel565, btn_wid, btn_hgt> img_565 =
+    label_img<Pixel565, btn_wid, btn_hgt>("Button", font, screen_fg, 4,
+                                          screen_fg, Color::gray(80));
+
+static constexpr PixelImage<Pixel666, btn_wid, btn_hgt> img_666 =
+    label_img<Pixel666, btn_wid, btn_hgt>("Button", font, screen_fg, 4,
+                                          screen_fg, Color::gray(80));
+
+static constexpr int pixels = btn_wid * btn_hgt;
+
+static Pixel565 line_565[pixels];
+static Pixel666 line_666[pixels];
+
+// what a driver for an 18-bit panel does with RGB565 pixels
+static void convert(const Pixel565 *src, Pixel666 *dst, int cnt)
+{
+    for (int i = 0; i < cnt; i++) {
+        const uint16_t v = src[i].rgb();
+        const uint8_t r = uint8_t((v >> 11) << 3);
+        const uint8_t g = uint8_t(((v >> 5) & 0x3f) << 2);
+        const uint8_t b = uint8_t((v & 0x1f) << 3);
+        dst[i] = Pixel666(Color(r, g, b));
+    }
+}
+
+static void time(const char *what, int flash_bytes, void (*write)())
+{
+    static constexpr int reps = 20'000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++)
+        write();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    printf("  %-32s %8.3f us/write %6.2f ns/pixel %8d bytes flash\n", what,
+           double(ns) / reps / 1000.0, double(ns) / reps / pixels,
+           flash_bytes);
+}
+
+static void run()
+{
+    time("565 to 18-bit panel, convert", int(sizeof(img_565)), [] {
+        convert(img_565.pixels, line_666, pixels);
+        asm volatile("" : : "r"(line_666) : "memory");
+    });
+    time("666 to 18-bit panel, copy", int(sizeof(img_666)), [] {
+        memcpy(line_666, img_666.pixels, sizeof(line_666));
+        asm volatile("" : : "r"(line_666) : "memory");
+    });
+    time("565 to 16-bit panel, copy", int(sizeof(img_565)), [] {
+        memcpy(line_565, img_565.pixels, sizeof(line_565));
+        asm volatile("" : : "r"(line_565) : "memory");
+    });
+
+    // RGB565 drops the low bit of red and blue (and a blend's rounding)
+    // before the panel sees them
+    int differ = 0;
+    for (int i = 0; i < pixels; i++) {
+        Pixel666 p;
+        convert(&img_565.pixels[i], &p, 1);
+        if (p != img_666.pixels[i])
+            differ++;
+    }
+    printf("  %-32s %8d of %d pixels\n", "converted != pre-encoded", differ,
+           pixels);
+}
+
+} // namespace PixelFormat
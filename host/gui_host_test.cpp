@@ -0,0 +1,2640 @@
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+// framebuffer
+#include "color.h"
+#include "font.h"
+#include "pixel_565.h"
+#include "pixel_image.h"
+// gui
+#include "gui.h"
+#include "gui_assets.h" // generated from gui_host_test_assets.txt
+// host
+#include "fb_record.h"
+#include "hardware/gpio.h"
+#include "gui_render_thread.h"
+#include "host_clock.h"
+#include "host_font.h"
+#include "ts_script.h"
+
+using HAlign = Framebuffer::HAlign;
+
+// Tests return true on pass. check() prints what failed and keeps going so
+// one run shows every failure.
+static bool check_(bool ok, const char *what, const char *file, int line)
+{
+    if (!ok)
+        printf("  FAIL %s:%d: %s\n", file, line, what);
+    return ok;
+}
+#define check(X) ok &= check_((X), #X, __FILE__, __LINE__)
+
+// clang-format off
+namespace Dirty1 { static bool run(); }
+namespace HitTest1 { static bool run(); }
+namespace NumberDiff1 { static bool run(); }
+namespace SliderDelta1 { static bool run(); }
+namespace Queue1 { static bool run(); }
+namespace Render1 { static bool run(); }
+namespace Blit1 { static bool run(); }
+namespace DisplayList1 { static bool run(); }
+namespace Overlap1 { static bool run(); }
+namespace Rle1 { static bool run(); }
+namespace Mask1 { static bool run(); }
+namespace StaticPage1 { static bool run(); }
+namespace Text1 { static bool run(); }
+namespace Loop1 { static bool run(); }
+namespace Anim1 { static bool run(); }
+namespace Stats1 { static bool run(); }
+namespace Latency1 { static bool run(); }
+namespace Touch1 { static bool run(); }
+namespace Idle1 { static bool run(); }
+namespace Swap1 { static bool run(); }
+namespace Background1 { static bool run(); }
+namespace Compose1 { static bool run(); }
+namespace Assets1 { static bool run(); }
+// clang-format on
+
+static struct {
+    const char *name;
+    bool (*func)();
+} tests[] = {
+    {"Dirty1", Dirty1::run},
+    {"HitTest1", HitTest1::run},
+    {"NumberDiff1", NumberDiff1::run},
+    {"SliderDelta1", SliderDelta1::run},
+    {"Queue1", Queue1::run},
+    {"Render1", Render1::run},
+    {"Blit1", Blit1::run},
+    {"DisplayList1", DisplayList1::run},
+    {"Overlap1", Overlap1::run},
+    {"Rle1", Rle1::run},
+    {"Mask1", Mask1::run},
+    {"StaticPage1", StaticPage1::run},
+    {"Text1", Text1::run},
+    {"Loop1", Loop1::run},
+    {"Anim1", Anim1::run},
+    {"Stats1", Stats1::run},
+    {"Latency1", Latency1::run},
+    {"Touch1", Touch1::run},
+    {"Idle1", Idle1::run},
+    {"Swap1", Swap1::run},
+    {"Background1", Background1::run},
+    {"Compose1", Compose1::run},
+    {"Assets1", Assets1::run},
+};
+static const int num_tests = sizeof(tests) / sizeof(tests[0]);
+
+
+// run all tests, or just the ones named on the command line
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    for (int i = 0; i < num_tests; i++) {
+        bool selected = argc < 2;
+        for (int a = 1; a < argc; a++)
+            selected |= strcmp(argv[a], tests[i].name) == 0;
+        if (!selected)
+            continue;
+        printf("%s\n", tests[i].name);
+        bool ok = tests[i].func();
+        printf("%s %s\n", ok ? "PASS" : "FAIL", tests[i].name);
+        if (!ok)
+            failed++;
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+
+static constexpr Color screen_fg = Color::black();
+static constexpr Color screen_bg = Color::white();
+
+DIGIT_IMAGE_ARRAY(host_font_48, screen_fg, screen_bg);
+
+static bool same_rect(const FbRecord &a, const FbRecord &b, const GuiRect &rect)
+{
+    for (int r = rect.row; r < rect.row + rect.hgt; r++)
+        for (int c = rect.col; c < rect.col + rect.wid; c++)
+            if (a.pixel(c, r) != b.pixel(c, r))
+                return false;
+    return true;
+}
+
+static bool same_screen(const FbRecord &a, const FbRecord &b)
+{
+    return same_rect(a, b, GuiRect{0, 0, a.width(), a.height()});
+}
+
+
+namespace Dirty1 {
+
+// a number driven by a slider, like NavGroup1's page 2
+struct Rig {
+    GuiNumber num;
+    GuiSlider sld;
+    GuiPage page;
+
+    Rig(FbRecord &fb) :
+        num(fb, 200, 40, screen_bg, host_font_48_digit_img, 0, HAlign::Right),
+        sld(fb, 240, 40, 200, 40, screen_fg, screen_bg, Color::gray(90),
+            Color::white(), 0, 100, 0, nullptr, 0),
+        page({&num, &sld})
+    {
+        fb.fill_rect(0, 0, fb.width(), fb.height(), screen_bg);
+    }
+
+    // a burst of model updates in one loop pass
+    void burst()
+    {
+        for (int v = 1; v <= 5; v++) {
+            sld.set_value(v * 10);
+            num.set_value(v * 1111);
+        }
+    }
+};
+
+static bool run()
+{
+    bool ok = true;
+
+    FbRecord fb_imm;
+    Rig imm(fb_imm);
+    imm.page.visible(true);
+    fb_imm.reset_stats();
+    imm.burst();
+    const uint64_t imm_pixels = fb_imm.stats().pixels;
+
+    FbRecord fb_def;
+    Rig def(fb_def);
+    def.page.deferred(true);
+    def.page.visible(true);
+    fb_def.reset_stats();
+    def.burst();
+    check(fb_def.stats().pixels == 0); // nothing until flush
+    def.page.flush();
+    const uint64_t def_pixels = fb_def.stats().pixels;
+
+    printf("  burst: immediate %llu pixels, deferred %llu pixels per flush\n",
+           (unsigned long long)imm_pixels, (unsigned long long)def_pixels);
+    check(def_pixels < imm_pixels);
+    check(same_screen(fb_imm, fb_def));
+
+    // nothing pending, nothing drawn
+    fb_def.reset_stats();
+    def.page.flush();
+    check(fb_def.stats().pixels == 0);
+
+    // one slider step costs one handle move
+    def.sld.set_value(def.sld.get_value() + 1);
+    imm.sld.set_value(imm.sld.get_value() + 1);
+    fb_def.reset_stats();
+    def.page.flush();
+    check(fb_def.stats().pixels > 0);
+    check(same_screen(fb_imm, fb_def));
+
+    // shrinking number: old digits must be gone after the flush
+    def.num.set_value(7);
+    imm.num.set_value(7);
+    def.page.flush();
+    check(same_screen(fb_imm, fb_def));
+
+    // leaving deferred mode flushes
+    def.num.set_value(42);
+    imm.num.set_value(42);
+    def.page.deferred(false);
+    check(same_screen(fb_imm, fb_def));
+
+    return ok;
+}
+
+} // namespace Dirty1
+
+
+namespace HitTest1 {
+
+static constexpr int btn_wid = 60;
+static constexpr int btn_hgt = 30;
+
+static constexpr PixelImage<Pixel565, btn_wid, btn_hgt> btn_img =
+    label_img<Pixel565, btn_wid, btn_hgt>("B", host_font_16, screen_fg, 1,
+                                          screen_fg, screen_bg);
+
+static int last_down = -1;
+
+static void on_down(intptr_t arg)
+{
+    last_down = int(arg);
+}
+
+static void on_value(intptr_t)
+{
+    last_down = 100;
+}
+
+// a widget from outside the library that only overrides event()
+class Tapper : public GuiWidget
+{
+public:
+
+    Tapper(Framebuffer &fb, int col, int row) :
+        GuiWidget(fb, col, row, 40, 40, screen_bg)
+    {
+    }
+
+    virtual bool event(Touchscreen::Event &event) override
+    {
+        if (event.type != Touchscreen::Event::Type::down ||
+            !rect().contains(GuiRect{event.col, event.row, 1, 1}))
+            return false;
+        last_down = 200;
+        return true;
+    }
+};
+
+// The index must send every tap to the same widget the linear scan does,
+// including to widgets that don't say whether they are interactive.
+static bool run()
+{
+    bool ok = true;
+
+    FbRecord fb;
+
+    // labels, buttons (one hidden, one disabled) and a slider, with gaps
+    GuiLabel l0(fb, 0, 0, screen_bg, &btn_img.hdr, &btn_img.hdr);
+    GuiButton b0(fb, 10, 40, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                 &btn_img.hdr, nullptr, 0, on_down, 0, nullptr, 0);
+    GuiButton b1(fb, 75, 40, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                 &btn_img.hdr, nullptr, 0, on_down, 1, nullptr, 0);
+    GuiLabel l1(fb, 200, 200, screen_bg, &btn_img.hdr, &btn_img.hdr);
+    GuiButton b2(fb, 300, 250, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                 &btn_img.hdr, nullptr, 0, on_down, 2, nullptr, 0);
+    GuiButton b3(fb, 400, 10, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                 &btn_img.hdr, nullptr, 0, on_down, 3, nullptr, 0);
+    GuiButton b4(fb, 400, 60, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                 &btn_img.hdr, nullptr, 0, on_down, 4, nullptr, 0);
+    GuiSlider s0(fb, 20, 150, 300, 30, screen_fg, screen_bg, Color::gray(90),
+                 Color::white(), 0, 10, 5, on_value, 0);
+    Tapper t0(fb, 400, 200);
+    GuiPage page({&l0, &b0, &b1, &l1, &b2, &b3, &b4, &s0, &t0});
+    b3.visible(false);
+    b4.enabled(false);
+    page.visible(true);
+
+    int mismatches = 0;
+    for (int r = 0; r < fb.height(); r += 3) {
+        for (int c = 0; c < fb.width(); c += 3) {
+            int hit[2];
+            for (int pass = 0; pass < 2; pass++) {
+                page.indexed(pass == 0);
+                s0.set_value(5);
+                last_down = -1;
+                Touchscreen::Event down(Touchscreen::Event::Type::down, c, r);
+                Touchscreen::Event up(Touchscreen::Event::Type::up, c, r);
+                page.event(down);
+                if (GuiWidget::focus != nullptr)
+                    GuiWidget::focus->event(up);
+                hit[pass] = last_down;
+            }
+            if (hit[0] != hit[1])
+                mismatches++;
+        }
+    }
+    check(mismatches == 0);
+    check(GuiWidget::focus == nullptr);
+
+    for (int pass = 0; pass < 2; pass++) {
+        page.indexed(pass == 0);
+        last_down = -1;
+        Touchscreen::Event down(Touchscreen::Event::Type::down, 420, 220);
+        check(page.event(down) && last_down == 200);
+    }
+
+    return ok;
+}
+
+} // namespace HitTest1
+
+
+namespace NumberDiff1 {
+
+// After every update, the screen must match a clean screen with just the
+// new number drawn on it.
+static bool run()
+{
+    bool ok = true;
+
+    const HAlign aligns[] = {HAlign::Left, HAlign::Center, HAlign::Right};
+    const int values[] = {0,    7,    10,   99,   100,  4999, 5000, 5001,
+                          1,    1111, 8888, 123,  9,    45678, 0,   2147483647,
+                          3,    200,  199,  5000, 5000, 60};
+
+    for (HAlign align : aligns) {
+        FbRecord fb;
+        fb.fill_rect(0, 0, fb.width(), fb.height(), screen_bg);
+        GuiNumber num(fb, 240, 100, screen_bg, host_font_48_digit_img, 1,
+                      align);
+        num.draw();
+
+        int bad = 0;
+        for (int v : values) {
+            num.set_value(v);
+
+            FbRecord ref;
+            ref.fill_rect(0, 0, ref.width(), ref.height(), screen_bg);
+            GuiNumber ref_num(ref, 240, 100, screen_bg, host_font_48_digit_img,
+                              v, align);
+            ref_num.draw();
+
+            if (!same_screen(fb, ref))
+                bad++;
+        }
+        check(bad == 0);
+    }
+
+    // only the digit that changed
+    FbRecord fb;
+    GuiNumber num(fb, 240, 100, screen_bg, host_font_48_digit_img, 5000,
+                  HAlign::Right);
+    num.draw();
+    fb.reset_stats();
+    num.set_value(5003);
+    check(fb.stats().windows == 1);
+    check(fb.stats().pixels == uint64_t(host_font_48_3_img.hdr.wid *
+                                        host_font_48_3_img.hdr.hgt));
+
+    return ok;
+}
+
+} // namespace NumberDiff1
+
+
+namespace SliderDelta1 {
+
+// Moving the handle between any two values must leave exactly what a fresh
+// draw at the new value does, and cost less than erase + draw when the old
+// and new handles overlap. A forced draw still draws it all, and a hidden
+// slider draws nothing.
+static bool run()
+{
+    bool ok = true;
+
+    struct {
+        int wid, hgt, val_max;
+    } cfgs[] = {
+        {120, 20, 30}, // handle moves a few pixels per step
+        {200, 41, 10}, // handle moves more than its width per step
+        {60, 30, 100}, // several values per pixel
+    };
+
+    for (auto &cfg : cfgs) {
+        const GuiRect area{10, 10, cfg.wid, cfg.hgt};
+        int bad = 0;
+        uint64_t delta_pixels = 0;
+        uint64_t full_pixels = 0;
+        for (int v0 = 0; v0 <= cfg.val_max; v0++) {
+            for (int v1 = 0; v1 <= cfg.val_max; v1++) {
+                FbRecord fb(area.col + cfg.wid + 10, area.row + cfg.hgt + 10);
+                GuiSlider sld(fb, area.col, area.row, cfg.wid, cfg.hgt,
+                              screen_fg, screen_bg, Color::gray(90),
+                              Color::red(), 0, cfg.val_max, v0, nullptr, 0);
+                sld.draw();
+                fb.reset_stats();
+                sld.set_value(v1);
+                delta_pixels += fb.stats().pixels;
+
+                FbRecord ref(area.col + cfg.wid + 10, area.row + cfg.hgt + 10);
+                GuiSlider ref_sld(ref, area.col, area.row, cfg.wid, cfg.hgt,
+                                  screen_fg, screen_bg, Color::gray(90),
+                                  Color::red(), 0, cfg.val_max, v1, nullptr,
+                                  0);
+                ref_sld.draw();
+
+                if (!same_rect(fb, ref, area))
+                    bad++;
+
+                // what erase_handle() + draw_handle() sends, at most
+                const int handle_wid = cfg.hgt / 2 * 2 + 1;
+                if (v0 != v1)
+                    full_pixels += uint64_t(2 * handle_wid * (cfg.hgt - 2));
+            }
+        }
+        printf("  %dx%d 0..%d: %llu pixels moving, %llu erase+draw\n",
+               cfg.wid, cfg.hgt, cfg.val_max,
+               (unsigned long long)delta_pixels,
+               (unsigned long long)full_pixels);
+        check(bad == 0);
+        check(delta_pixels <= full_pixels);
+    }
+
+    const GuiRect area{10, 10, 120, 20};
+    FbRecord fb(140, 40);
+    GuiSlider sld(fb, area.col, area.row, area.wid, area.hgt, screen_fg,
+                  screen_bg, Color::gray(90), Color::red(), 0, 30, 10,
+                  nullptr, 0);
+    sld.enabled(true, true); // first draw
+    check(fb.stats().pixels >= uint64_t(area.area()));
+    fb.reset_stats();
+    sld.enabled(true, true);
+    check(fb.stats().pixels >= uint64_t(area.area()));
+
+    fb.reset_stats();
+    sld.visible(false);
+    sld.set_value(20);
+    sld.enabled(false);
+    check(fb.stats().pixels == 0);
+
+    // shown again, the handle is drawn where it is now
+    sld.visible(true);
+    sld.enabled(true);
+    FbRecord ref(140, 40);
+    GuiSlider ref_sld(ref, area.col, area.row, area.wid, area.hgt, screen_fg,
+                      screen_bg, Color::gray(90), Color::red(), 0, 30, 20,
+                      nullptr, 0);
+    ref_sld.draw();
+    check(same_rect(fb, ref, area));
+
+    return ok;
+}
+
+} // namespace SliderDelta1
+
+
+namespace Queue1 {
+
+using Event = Touchscreen::Event;
+using Type = Event::Type;
+
+static int value_calls = 0;
+
+static void on_value(intptr_t)
+{
+    value_calls++;
+}
+
+static bool run()
+{
+    bool ok = true;
+
+    // runs of moves collapse to the newest; downs and ups stay
+    GuiEventQueue q;
+    q.push(Event(Type::down, 1, 1));
+    for (int i = 2; i <= 10; i++)
+        q.push(Event(Type::move, i, i));
+    q.push(Event(Type::up, 10, 10));
+    q.push(Event(Type::down, 20, 20));
+    q.push(Event(Type::move, 21, 21));
+    q.push(Event(Type::move, 22, 22));
+    check(q.size() == 5);
+    check(q.coalesced() == 9);
+    Event e;
+    check(q.pop(e) && e.type == Type::down && e.col == 1);
+    check(q.pop(e) && e.type == Type::move && e.col == 10);
+    check(q.pop(e) && e.type == Type::up && e.col == 10);
+    check(q.pop(e) && e.type == Type::down && e.col == 20);
+    check(q.pop(e) && e.type == Type::move && e.col == 22);
+    check(!q.pop(e));
+
+    // full: the oldest move makes room; with no moves, downs are refused
+    for (int i = 0; i < GuiEventQueue::capacity / 2; i++) {
+        q.push(Event(Type::down, i, 0));
+        q.push(Event(Type::move, i, 0));
+    }
+    check(q.size() == GuiEventQueue::capacity);
+    check(q.push(Event(Type::up, 99, 0)));
+    check(q.dropped() == 1);
+    check(q.pop(e) && e.type == Type::down && e.col == 0);
+    check(q.pop(e) && e.type == Type::down && e.col == 1);
+    while (q.pop(e))
+        ;
+    for (int i = 0; i < GuiEventQueue::capacity; i++)
+        check(q.push(Event(Type::down, i, 0)));
+    check(!q.push(Event(Type::up, 0, 0)));
+    check(q.refused() == 1);
+
+    // A slider falling behind: four touch samples arrive per redraw. The
+    // handler sees fewer moves, and the slider still ends up at the end.
+    FbRecord fb;
+    GuiSlider s(fb, 40, 100, 400, 40, screen_fg, screen_bg, Color::gray(90),
+                Color::white(), 0, 100, 0, on_value, 0);
+    GuiPage page({&s});
+    page.visible(true);
+
+    TsScript ts;
+    ts.drag(40, 120, 440, 120, 200);
+    GuiEventQueue events;
+    int dispatched = 0;
+    while (ts.pending() > 0 || !events.empty()) {
+        for (int i = 0; i < 4 && ts.pending() > 0; i++)
+            events.push(ts.get_event());
+        while (events.dispatch(page))
+            dispatched++;
+    }
+    printf("  200-move drag at 4 samples per frame: %d dispatched, %lu "
+           "coalesced, %d value changes\n",
+           dispatched, (unsigned long)events.coalesced(), value_calls);
+    check(dispatched < 202);
+    check(events.coalesced() > 0);
+    check(s.get_value() == 100);
+    check(GuiWidget::focus == nullptr);
+
+    return ok;
+}
+
+} // namespace Queue1
+
+
+namespace Render1 {
+
+// The same updates drawn directly and through a GuiRenderQueue run by
+// another thread must send the same writes, in the same order.
+
+static constexpr PixelImage<Pixel565, 100, 60> up_img =
+    label_img<Pixel565, 100, 60>("Up", host_font_16, screen_fg, 2, screen_fg,
+                                 Color::gray(80));
+
+static constexpr PixelImage<Pixel565, 100, 60> dn_img =
+    label_img<Pixel565, 100, 60>("Down", host_font_16, screen_bg, 2,
+                                 screen_fg, Color::gray(40));
+
+struct Rig {
+    GuiNumber num;
+    GuiSlider sld;
+    GuiButton btn;
+    GuiPage page;
+
+    Rig(FbRecord &fb) :
+        num(fb, 200, 40, screen_bg, host_font_48_digit_img, 0, HAlign::Right),
+        sld(fb, 240, 40, 200, 40, screen_fg, screen_bg, Color::gray(90),
+            Color::white(), 0, 100, 0, nullptr, 0),
+        btn(fb, 20, 120, screen_bg, &up_img.hdr, &up_img.hdr, &dn_img.hdr,
+            nullptr, 0, nullptr, 0, nullptr, 0, GuiButton::Mode::Check),
+        page({&num, &sld, &btn})
+    {
+    }
+
+    void updates()
+    {
+        page.visible(true);
+        for (int v = 0; v <= 100; v++) {
+            sld.set_value(v);
+            num.set_value(v * 37);
+            if (v % 10 == 0)
+                btn.pressed(!btn.pressed());
+        }
+        page.visible(false);
+        page.visible(true);
+    }
+};
+
+static bool run()
+{
+    bool ok = true;
+
+    FbRecord fb_ref;
+    fb_ref.fill_rect(0, 0, fb_ref.width(), fb_ref.height(), screen_bg);
+    fb_ref.reset_stats();
+    Rig ref(fb_ref);
+    ref.updates();
+
+    FbRecord fb;
+    fb.fill_rect(0, 0, fb.width(), fb.height(), screen_bg);
+    fb.reset_stats();
+    Rig rig(fb);
+    GuiRenderQueue queue;
+    {
+        GuiRenderThread render(queue);
+        GuiWidget::canvas = &queue;
+        rig.updates();
+        GuiWidget::canvas = nullptr;
+        queue.sync();
+        check(queue.done(queue.fence()));
+        check(same_screen(fb, fb_ref));
+    }
+
+    printf("  %llu windows, producer waited %lu times\n",
+           (unsigned long long)fb.stats().windows,
+           (unsigned long)queue.full_waits());
+    check(fb.stats().windows == fb_ref.stats().windows);
+    check(fb.stats().pixels == fb_ref.stats().pixels);
+
+    // without a render thread nothing is written until asked
+    FbRecord fb_man(16, 16);
+    fb_man.reset_stats();
+    queue.fill_rect(fb_man, 0, 0, 16, 16, Color::red());
+    const uint32_t f1 = queue.fence();
+    queue.fill_rect(fb_man, 4, 4, 8, 8, Color::blue());
+    const uint32_t f2 = queue.fence();
+    check(fb_man.stats().windows == 0);
+    check(!queue.done(f1));
+    check(queue.render_one());
+    check(queue.done(f1) && !queue.done(f2));
+    check(queue.render_one());
+    check(queue.done(f2));
+    check(!queue.render_one());
+    check(fb_man.pixel(0, 0) == Pixel565(Color::red()));
+    check(fb_man.pixel(4, 4) == Pixel565(Color::blue()));
+
+    return ok;
+}
+
+} // namespace Render1
+
+
+namespace Blit1 {
+
+// An image sent in strips, directly or through a render thread, must land
+// exactly as one write of the whole image does.
+
+static constexpr int img_wid = 100;
+static constexpr int img_hgt = 37; // not a multiple of the strip height
+
+static constexpr PixelImage<Pixel565, img_wid, img_hgt> img =
+    label_img<Pixel565, img_wid, img_hgt>("Blit", host_font_24, screen_fg, 3,
+                                          Color::red(), Color::gray(70));
+
+static bool run()
+{
+    bool ok = true;
+
+    FbRecord ref(160, 80);
+    ref.write(30, 20, &img.hdr);
+
+    // room for two strips of 4 rows (plus headers and alignment slop)
+    static constexpr int work_bytes = 2 * (8 + 4 * img_wid * 2) + 8;
+    alignas(8) static uint8_t work[work_bytes];
+    const GuiBlit::ImageSource src(&img.hdr);
+
+    for (int threaded = 0; threaded < 2; threaded++) {
+        FbRecord fb(160, 80);
+        GuiRenderQueue queue;
+        GuiBlit blit(work + 1, work_bytes - 1,
+                     threaded ? &queue : nullptr);
+        {
+            GuiRenderThread *render =
+                threaded ? new GuiRenderThread(queue) : nullptr;
+            blit.start(fb, 30, 20, src);
+            check(blit.strip_rows() >= 3);
+            int steps = 1;
+            while (blit.step())
+                steps++;
+            check(blit.sent());
+            blit.wait();
+            check(blit.done());
+            const int strips =
+                (img_hgt + blit.strip_rows() - 1) / blit.strip_rows();
+            check(steps == strips);
+            check(fb.stats().windows == uint64_t(strips));
+            delete render;
+        }
+        printf("  %s: %d rows/strip, %lu waits\n",
+               threaded ? "render thread" : "direct", blit.strip_rows(),
+               (unsigned long)blit.strip_waits());
+        check(fb.stats().pixels == ref.stats().pixels);
+        check(same_screen(fb, ref));
+    }
+
+    return ok;
+}
+
+} // namespace Blit1
+
+
+namespace DisplayList1 {
+
+// Showing a page from its display list must send exactly what drawing each
+// widget does, after any changes made while the page was hidden (a widget
+// drawing more ops than before, or fewer), and only the widgets that
+// changed are recorded again.
+
+static constexpr PixelImage<Pixel565, 100, 40> lbl_img =
+    label_img<Pixel565, 100, 40>("List", host_font_16, screen_fg, screen_bg);
+
+struct Rig {
+    GuiLabel lbl;
+    GuiNumber num;
+    GuiSlider sld;
+    GuiButton btn;
+    GuiPage page;
+
+    Rig(FbRecord &fb) :
+        lbl(fb, 20, 20, screen_bg, &lbl_img.hdr, &lbl_img.hdr),
+        num(fb, 200, 80, screen_bg, host_font_48_digit_img, 42,
+            HAlign::Right),
+        sld(fb, 240, 80, 200, 40, screen_fg, screen_bg, Color::gray(90),
+            Color::white(), 0, 100, 30, nullptr, 0),
+        btn(fb, 20, 160, screen_bg, &Render1::up_img.hdr,
+            &Render1::up_img.hdr, &Render1::dn_img.hdr, nullptr, 0, nullptr,
+            0, nullptr, 0, GuiButton::Mode::Check),
+        page({&lbl, &num, &sld, &btn})
+    {
+        fb.fill_rect(0, 0, fb.width(), fb.height(), screen_bg);
+        fb.reset_stats();
+        page.deferred(true);
+    }
+
+    void change()
+    {
+        num.set_value(31415);
+        sld.set_value(77);
+        page.flush(); // hidden: nothing drawn
+    }
+};
+
+static bool run()
+{
+    bool ok = true;
+
+    static constexpr int max_ops = 32;
+    GuiDisplayList::Op ops[max_ops];
+    GuiDisplayList list(ops, max_ops);
+
+    FbRecord fb_ref;
+    Rig ref(fb_ref);
+    FbRecord fb;
+    Rig rig(fb);
+    rig.page.display_list(&list);
+
+    ref.page.visible(true);
+    rig.page.visible(true);
+    check(same_screen(fb, fb_ref));
+    check(fb.stats().windows == fb_ref.stats().windows);
+    check(list.records() == 4);
+    printf("  %d ops, %d bytes (%d bytes/op)\n", list.size(), list.bytes(),
+           int(sizeof(GuiDisplayList::Op)));
+
+    ref.page.visible(false);
+    rig.page.visible(false);
+    ref.change();
+    rig.change();
+    fb_ref.reset_stats();
+    fb.reset_stats();
+    ref.page.visible(true);
+    rig.page.visible(true);
+    check(same_screen(fb, fb_ref));
+    check(fb.stats().windows == fb_ref.stats().windows);
+    check(fb.stats().pixels == fb_ref.stats().pixels);
+    check(list.records() == 4 + 2); // just the number and the slider
+
+    // shown again with nothing changed: no recording
+    rig.page.visible(false);
+    rig.page.visible(true);
+    check(list.records() == 6);
+    check(same_screen(fb, fb_ref));
+
+    // a list too small to hold the page falls back to drawing
+    GuiDisplayList::Op small_ops[2];
+    GuiDisplayList small(small_ops, 2);
+    FbRecord fb_small;
+    Rig rig_small(fb_small);
+    rig_small.page.display_list(&small);
+    rig_small.change();
+    rig_small.page.visible(true);
+    check(small.overflow());
+    check(same_screen(fb_small, fb_ref));
+
+    // the number drawing fewer ops than were recorded for it
+    const int ops_before = list.size();
+    for (Rig *r : {&ref, &rig}) {
+        r->page.visible(false);
+        r->num.set_value(7);
+        r->page.flush();
+    }
+    fb_ref.reset_stats();
+    fb.reset_stats();
+    ref.page.visible(true);
+    rig.page.visible(true);
+    check(list.size() < ops_before);
+    check(list.records() == 7);
+    check(same_screen(fb, fb_ref));
+    check(fb.stats().windows == fb_ref.stats().windows);
+
+    return ok;
+}
+
+} // namespace DisplayList1
+
+
+namespace Overlap1 {
+
+// Widgets stack in page order: a label entirely under another is not
+// drawn, a label over part of a button takes touches there, a widget that
+// changes under another does not paint over it, and one that moves or
+// shrinks off another leaves no hole in it.
+
+static int downs = 0;
+
+static void on_down(intptr_t)
+{
+    downs++;
+}
+
+static bool run()
+{
+    bool ok = true;
+
+    using Event = Touchscreen::Event;
+    const PixelImageHdr *up = &Render1::up_img.hdr; // 100 x 60
+    const PixelImageHdr *lbl = &DisplayList1::lbl_img.hdr; // 100 x 40
+
+    FbRecord fb(320, 120);
+    GuiLabel under(fb, 0, 0, screen_bg, up, up);
+    GuiLabel over(fb, 0, 0, screen_bg, up, up);
+    GuiButton btn(fb, 150, 20, screen_bg, up, up, &Render1::dn_img.hdr,
+                  nullptr, 0, on_down, 0, nullptr, 0);
+    GuiLabel cap(fb, 200, 40, screen_bg, lbl, lbl); // over btn's corner
+    GuiPage page({&under, &over, &btn, &cap});
+
+    page.visible(true);
+    check(fb.stats().windows == 3); // not 'under'
+
+    // painted: over + btn + cap; visible: over + btn less cap + cap
+    const GuiPage::Overdraw od = page.overdraw();
+    printf("  overdraw %u / %u = %.3f\n", (unsigned)od.painted,
+           (unsigned)od.visible, double(od.ratio()));
+    check(od.painted == 6000 + 6000 + 4000);
+    check(od.visible == 6000 + (6000 - 50 * 40) + 4000);
+
+    // top-down hit test, indexed and not
+    for (int indexed = 0; indexed < 2; indexed++) {
+        page.indexed(indexed != 0);
+        downs = 0;
+        Event down(Event::Type::down, 160, 30);
+        Event up_ev(Event::Type::up, 160, 30);
+        check(page.event(down) && downs == 1);
+        check(page.event(up_ev));
+        Event blocked(Event::Type::down, 220, 60); // on cap, over btn
+        check(!page.event(blocked) && downs == 1);
+        check(GuiWidget::focus == nullptr);
+    }
+
+    // raise the hidden label: now it is drawn, and 'over' is covered
+    fb.reset_stats();
+    page.raise(&under);
+    check(fb.stats().windows == 1);
+    fb.reset_stats();
+    page.draw();
+    check(fb.stats().windows == 3);
+
+    // a slider partly under an opaque label: changing it, right away or
+    // deferred, must not paint over the label
+    for (int deferred = 0; deferred < 2; deferred++) {
+        FbRecord fs(320, 120);
+        GuiSlider sld(fs, 20, 40, 280, 30, screen_fg, screen_bg,
+                      Color::gray(90), Color::white(), 0, 100, 10, nullptr, 0);
+        GuiLabel top(fs, 120, 20, screen_bg, lbl, lbl);
+        GuiPage sp({&sld, &top});
+        sp.visible(true);
+        sp.deferred(deferred != 0);
+        for (int v : {45, 50, 80, 45})
+            sld.set_value(v);
+        if (deferred != 0)
+            sp.flush();
+
+        FbRecord rs(320, 120);
+        GuiSlider rsld(rs, 20, 40, 280, 30, screen_fg, screen_bg,
+                       Color::gray(90), Color::white(), 0, 100, 45, nullptr,
+                       0);
+        GuiLabel rtop(rs, 120, 20, screen_bg, lbl, lbl);
+        GuiPage rp({&rsld, &rtop});
+        rp.visible(true);
+        check(same_screen(fs, rs));
+    }
+
+    // a slider over a label moves away, or a number over it gets narrower,
+    // right away or deferred: the label is drawn again where they were
+    for (int deferred = 0; deferred < 2; deferred++) {
+        FbRecord fm(480, 320);
+        fm.fill_rect(0, 0, fm.width(), fm.height(), screen_bg);
+        GuiLabel base(fm, 100, 100, screen_bg, up, up);
+        GuiSlider sld(fm, 150, 110, 120, 30, screen_fg, screen_bg,
+                      Color::gray(90), Color::white(), 0, 100, 10, nullptr, 0);
+        GuiNumber num(fm, 60, 130, screen_bg, host_font_48_digit_img, 88888);
+        GuiPage mp({&base, &sld, &num});
+        mp.visible(true);
+        mp.deferred(deferred != 0);
+        sld.move(150, 250);
+        num.set_value(1);
+        if (deferred != 0)
+            mp.flush();
+
+        FbRecord rm(480, 320);
+        rm.fill_rect(0, 0, rm.width(), rm.height(), screen_bg);
+        GuiLabel rbase(rm, 100, 100, screen_bg, up, up);
+        GuiSlider rsld(rm, 150, 250, 120, 30, screen_fg, screen_bg,
+                       Color::gray(90), Color::white(), 0, 100, 10, nullptr,
+                       0);
+        GuiNumber rnum(rm, 60, 130, screen_bg, host_font_48_digit_img, 1);
+        GuiPage rp({&rbase, &rsld, &rnum});
+        rp.visible(true);
+        check(same_screen(fm, rm));
+    }
+
+    return ok;
+}
+
+} // namespace Overlap1
+
+
+namespace Rle1 {
+
+// A run-length encoded image must draw exactly as its raw original, through
+// a label, the render queue and a display list.
+
+static constexpr PixelImage<Pixel565, 160, 48> raw_img =
+    label_img<Pixel565, 160, 48>("PAGE 1", host_font_24, screen_fg, 4,
+                                 screen_fg, Color::gray(80));
+
+RLE_LABEL_IMG(rle_lbl, 160, 48, "PAGE 1", host_font_24, screen_fg, 4,
+              screen_fg, Color::gray(80));
+
+// one color, more pixels than fit in one run
+RLE_LABEL_IMG(big_img, 300, 300, "", host_font_24, screen_fg, screen_bg);
+
+static bool run()
+{
+    bool ok = true;
+
+    printf("  160x48: %d bytes raw, %d runs, %d bytes rle\n",
+           int(sizeof(raw_img)), rle_lbl_runs, int(sizeof(rle_lbl)));
+    check(sizeof(rle_lbl) * 4 < sizeof(raw_img));
+    check(big_img_runs == 2);
+
+    FbRecord ref(320, 320);
+    ref.write(10, 20, &raw_img.hdr);
+
+    FbRecord fb(320, 320);
+    GuiLabel lbl(fb, 10, 20, screen_bg, &rle_lbl.hdr, &rle_lbl.hdr);
+    check(lbl.rect().wid == 160 && lbl.rect().hgt == 48);
+    lbl.draw();
+    check(same_screen(fb, ref));
+    check(fb.stats().pixels == ref.stats().pixels);
+
+    // through the render queue (decoded on the render thread) and a list
+    FbRecord fb_q(320, 320);
+    GuiLabel lbl_q(fb_q, 10, 20, screen_bg, &rle_lbl.hdr, &rle_lbl.hdr);
+    GuiPage page({&lbl_q});
+    GuiDisplayList::Op ops[4];
+    GuiDisplayList list(ops, 4);
+    page.display_list(&list);
+    GuiRenderQueue queue;
+    {
+        GuiRenderThread render(queue);
+        GuiWidget::canvas = &queue;
+        page.visible(true);
+        GuiWidget::canvas = nullptr;
+    }
+    check(list.size() == 1);
+    check(same_screen(fb_q, ref));
+
+    FbRecord fb_big(320, 320);
+    GuiImage(&big_img.hdr).write(fb_big, 0, 0);
+    check(fb_big.stats().pixels == 300 * 300);
+    check(fb_big.pixel(299, 299) == Pixel565(screen_bg));
+
+    return ok;
+}
+
+} // namespace Rle1
+
+
+namespace Mask1 {
+
+// With 8-bit coverage, a mask in a palette draws exactly as label_img()
+// does with the same colors. Fewer bits change only the text's edges.
+
+static const GuiPalette pal_ena = {screen_fg, 4, screen_fg, Color::gray(80)};
+static const GuiPalette pal_prs = {screen_fg, 6, screen_fg, Color::red()};
+
+static constexpr PixelImage<Pixel565, 160, 48> raw_ena =
+    label_img<Pixel565, 160, 48>("PAGE 1", host_font_24, screen_fg, 4,
+                                 screen_fg, Color::gray(80));
+static constexpr PixelImage<Pixel565, 160, 48> raw_prs =
+    label_img<Pixel565, 160, 48>("PAGE 1", host_font_24, screen_fg, 6,
+                                 screen_fg, Color::red());
+
+MASK_LABEL_IMG(mask_8, 8, 160, 48, "PAGE 1", host_font_24);
+MASK_LABEL_IMG(mask_4, 4, 160, 48, "PAGE 1", host_font_24);
+
+MASK_DIGIT_ARRAY(host_font_48, 8);
+
+static const GuiPalette num_ena = {screen_fg, 0, Color::none(), screen_bg};
+static const GuiPalette num_dis = {Color::gray(60), 0, Color::none(),
+                                   screen_bg};
+
+static bool run()
+{
+    bool ok = true;
+
+    printf("  160x48: %d bytes raw, %d bytes 4-bit mask\n",
+           int(sizeof(raw_ena)), int(sizeof(mask_4)));
+    check(sizeof(mask_4) * 3 < sizeof(raw_ena));
+
+    // one mask, a palette per button state
+    FbRecord ref(320, 320);
+    ref.write(10, 20, &raw_ena.hdr);
+    FbRecord fb(320, 320);
+    GuiButton btn(fb, 10, 20, screen_bg, GuiImage(&mask_8.hdr, &pal_ena),
+                  GuiImage(&mask_8.hdr, &pal_ena),
+                  GuiImage(&mask_8.hdr, &pal_prs), nullptr, 0, nullptr, 0,
+                  nullptr, 0, GuiButton::Mode::Check);
+    btn.draw();
+    check(same_screen(fb, ref));
+    ref.write(10, 20, &raw_prs.hdr);
+    btn.pressed(true);
+    btn.draw();
+    check(same_screen(fb, ref));
+
+    // 4 bits: border and background are exact, text is close
+    FbRecord fb4(320, 320);
+    GuiImage(&mask_4.hdr, &pal_prs).write(fb4, 10, 20);
+    int diff = 0;
+    for (int r = 20; r < 20 + 48; r++) {
+        for (int c = 10; c < 10 + 160; c++) {
+            const int a = ref.pixel(c, r).rgb() >> 11; // red, 5 bits
+            const int b = fb4.pixel(c, r).rgb() >> 11;
+            if (a != b)
+                diff++;
+            check(a - b <= 2 && b - a <= 2);
+        }
+    }
+    check(diff > 0);
+
+    // a number drawn from masks, enabled then disabled
+    FbRecord ref_n(320, 320);
+    GuiNumber num_ref(ref_n, 10, 20, screen_bg, host_font_48_digit_img, 1234);
+    num_ref.draw();
+    FbRecord fb_n(320, 320);
+    GuiNumber num(fb_n, 10, 20, screen_bg, host_font_48_digit_mask, &num_ena,
+                  &num_dis, 1234);
+    num.draw();
+    check(same_screen(fb_n, ref_n));
+
+    num.enabled(false);
+    GuiRect rect = num.rect();
+    int fg = 0;
+    int dis = 0;
+    for (int r = rect.row; r < rect.row + rect.hgt; r++) {
+        for (int c = rect.col; c < rect.col + rect.wid; c++) {
+            fg += fb_n.pixel(c, r) == Pixel565(screen_fg);
+            dis += fb_n.pixel(c, r) == Pixel565(Color::gray(60));
+        }
+    }
+    check(fg == 0 && dis > 0);
+
+    // recolored and shortened in one refresh
+    num.set_value(77);
+    num.enabled(true);
+    num_ref.set_value(77);
+    check(same_screen(fb_n, ref_n));
+
+    return ok;
+}
+
+} // namespace Mask1
+
+
+namespace StaticPage1 {
+
+// HitTest1's page as a GuiStaticPage, owning its widgets, must draw the same
+// and send every tap to the same widget as a GuiPage does. Taps go through
+// a GuiEventQueue and a GuiPageAdapter.
+
+using HitTest1::btn_hgt;
+using HitTest1::btn_img;
+using HitTest1::btn_wid;
+using HitTest1::last_down;
+using HitTest1::on_down;
+using HitTest1::on_value;
+
+static GuiButton button(Framebuffer &fb, int col, int row, int id)
+{
+    return GuiButton(fb, col, row, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                     &btn_img.hdr, nullptr, 0, on_down, id, nullptr, 0);
+}
+
+static GuiSlider slider(Framebuffer &fb)
+{
+    return GuiSlider(fb, 20, 150, 300, 30, screen_fg, screen_bg,
+                     Color::gray(90), Color::white(), 0, 10, 5, on_value, 0);
+}
+
+static bool run()
+{
+    bool ok = true;
+
+    FbRecord fb;
+    GuiLabel l0(fb, 0, 0, screen_bg, &btn_img.hdr, &btn_img.hdr);
+    GuiButton b0 = button(fb, 10, 40, 0);
+    GuiButton b1 = button(fb, 75, 40, 1);
+    GuiLabel l1(fb, 200, 200, screen_bg, &btn_img.hdr, &btn_img.hdr);
+    GuiButton b2 = button(fb, 300, 250, 2);
+    GuiSlider s0 = slider(fb);
+    GuiPage page({&l0, &b0, &b1, &l1, &b2, &s0});
+    b1.enabled(false);
+    page.visible(true);
+
+    FbRecord fb_s;
+    GuiStaticPage<GuiLabel, GuiButton, GuiButton, GuiLabel, GuiButton,
+                  GuiSlider>
+        spage(GuiLabel(fb_s, 0, 0, screen_bg, &btn_img.hdr, &btn_img.hdr),
+              button(fb_s, 10, 40, 0), button(fb_s, 75, 40, 1),
+              GuiLabel(fb_s, 200, 200, screen_bg, &btn_img.hdr, &btn_img.hdr),
+              button(fb_s, 300, 250, 2), slider(fb_s));
+    spage.widget<2>().enabled(false);
+    GuiPageAdapter<decltype(spage)> adapter(spage);
+    GuiPageBase &base = adapter;
+    base.visible(true);
+    check(same_screen(fb, fb_s));
+    const GuiRect b2_rect = spage.bounds()[4];
+    check(b2_rect.col == 300 && b2_rect.row == 250 &&
+          b2_rect.wid == btn_wid && b2_rect.hgt == btn_hgt);
+
+    GuiEventQueue queue;
+    int mismatches = 0;
+    for (int r = 0; r < fb.height(); r += 3) {
+        for (int c = 0; c < fb.width(); c += 3) {
+            Touchscreen::Event down(Touchscreen::Event::Type::down, c, r);
+            Touchscreen::Event up(Touchscreen::Event::Type::up, c, r);
+            int hit[2];
+
+            s0.set_value(5);
+            last_down = -1;
+            page.event(down);
+            if (GuiWidget::focus != nullptr)
+                GuiWidget::focus->event(up);
+            hit[0] = last_down;
+
+            spage.widget<5>().set_value(5);
+            last_down = -1;
+            queue.push(down);
+            queue.push(up);
+            while (queue.dispatch(base))
+                ;
+            hit[1] = last_down;
+
+            if (hit[0] != hit[1])
+                mismatches++;
+        }
+    }
+    check(mismatches == 0);
+    check(GuiWidget::focus == nullptr);
+    check(same_screen(fb, fb_s));
+
+    // a page of references is the size of its pointers and flags
+    GuiStaticPage<GuiLabel &, GuiButton &> refs(l0, b0);
+    printf("  sizeof: GuiPage %d, GuiStaticPage<2 refs> %d\n",
+           int(sizeof(GuiPage)), int(sizeof(refs)));
+    check(sizeof(refs) < sizeof(GuiPage) / 4);
+
+    // a GuiLabel & to a button is still a button
+    GuiStaticPage<GuiLabel &> derived(b2);
+    derived.visible(true);
+    last_down = -1;
+    Touchscreen::Event down(Touchscreen::Event::Type::down, 310, 260);
+    Touchscreen::Event up(Touchscreen::Event::Type::up, 310, 260);
+    check(derived.event(down) && last_down == 2);
+    check(GuiWidget::focus == &b2);
+    if (GuiWidget::focus != nullptr)
+        GuiWidget::focus->event(up);
+
+    base.visible(false);
+    check(fb_s.pixel(10, 40) == Pixel565(screen_bg));
+
+    return ok;
+}
+
+} // namespace StaticPage1
+
+
+namespace Text1 {
+
+// Text drawn at runtime must match label_img() of the same string, with or
+// without the glyph cache, and with a cache too small for the string, and
+// must not change under a render core still writing it.
+
+static constexpr const char *str = "Temp: 23.5 C (ok)";
+static constexpr int str_wid = host_font_24.width(str);
+
+static constexpr PixelImage<Pixel565, str_wid, 24> str_img =
+    label_img<Pixel565, str_wid, 24>(str, host_font_24, screen_fg,
+                                     Color::gray(90));
+
+static uint8_t cache_mem[8192];
+static uint8_t tiny_mem[1024];
+
+static bool run()
+{
+    bool ok = true;
+
+    FbRecord ref(320, 100);
+    ref.write(20, 30, &str_img.hdr);
+
+    GuiGlyphCache cache(cache_mem, sizeof(cache_mem), 16);
+    GuiGlyphCache tiny(tiny_mem, sizeof(tiny_mem), 2);
+    GuiGlyphCache *caches[] = {nullptr, &cache, &tiny};
+
+    for (GuiGlyphCache *c : caches) {
+        GuiImage::glyph_cache = c;
+        for (int pass = 0; pass < 2; pass++) {
+            if (c != nullptr && pass == 1)
+                c->reset_stats();
+            FbRecord fb(320, 100);
+            GuiText txt(fb, 20, 30, Color::gray(90), host_font_24, screen_fg,
+                        str);
+            check(txt.rect().wid == str_wid && txt.rect().hgt == 24);
+            txt.draw();
+            check(same_screen(fb, ref));
+        }
+    }
+    GuiImage::glyph_cache = nullptr;
+
+    // the second draw hit every glyph in the big cache; the tiny one thrashes
+    printf("  hit rate: %.2f (16 slots), %.2f (2 slots)\n", cache.hit_rate(),
+           tiny.hit_rate());
+    check(cache.hits() > 0 && cache.misses() == 0);
+    check(tiny.hit_rate() < 0.1f);
+
+    // shorter, right aligned: only what the old text covered is erased
+    FbRecord fb(320, 100);
+    GuiImage::glyph_cache = &cache;
+    GuiText txt(fb, 300, 30, Color::gray(90), host_font_24, screen_fg,
+                "12345 mV", Framebuffer::HAlign::Right);
+    txt.draw();
+    txt.set_text("7 mV");
+    FbRecord ref_r(320, 100);
+    const int old_wid = host_font_24.width("12345 mV");
+    ref_r.fill_rect(300 - old_wid, 30, old_wid, 24, Color::gray(90));
+    GuiText txt_r(ref_r, 300, 30, Color::gray(90), host_font_24, screen_fg,
+                  "7 mV", Framebuffer::HAlign::Right);
+    txt_r.draw();
+    check(same_screen(fb, ref_r));
+    check(txt.rect().col == 300 - host_font_24.width("7 mV"));
+    GuiImage::glyph_cache = nullptr;
+
+    // Through a render queue, the text is read when the render core writes
+    // it: set_text() must wait for that (here, the render core starts late)
+    // rather than change the text, and its width, under it.
+    {
+        FbRecord fq(320, 100);
+        GuiRenderQueue queue;
+        GuiWidget::canvas = &queue;
+        GuiText tq(fq, 20, 30, Color::gray(90), host_font_24, screen_fg, "1");
+        tq.draw();
+        const uint32_t drawn = queue.fence();
+        std::thread late([&queue] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            queue.run();
+        });
+        tq.set_text(str);
+        check(queue.done(drawn));
+        GuiWidget::canvas = nullptr;
+        queue.stop();
+        late.join();
+        check(same_screen(fq, ref));
+    }
+
+    // The same when the text is drawn by replaying a page's display list:
+    // the replay, not the recording, is what must be waited for.
+    {
+        FbRecord fq(320, 100);
+        GuiRenderQueue queue;
+        GuiWidget::canvas = &queue;
+        GuiText tq(fq, 20, 30, Color::gray(90), host_font_24, screen_fg, "1");
+        GuiDisplayList::Op ops[8];
+        GuiDisplayList list(ops, 8);
+        GuiPage page({&tq});
+        page.display_list(&list);
+        page.visible(true);
+        check(list.size() > 0);
+        const uint32_t drawn = queue.fence();
+        std::thread late([&queue] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            queue.run();
+        });
+        tq.set_text(str);
+        check(queue.done(drawn));
+        GuiWidget::canvas = nullptr;
+        queue.stop();
+        late.join();
+        check(same_screen(fq, ref));
+    }
+
+    return ok;
+}
+
+} // namespace Text1
+
+
+
+namespace Loop1 {
+
+// On the simulated clock: tasks run at their periods, earliest deadline
+// first; a touch is handled before any due task; a slow task makes others
+// miss deadlines; a slow redraw is an overrun.
+
+using HitTest1::btn_img;
+
+static char order[64];
+static int order_cnt = 0;
+
+static uint32_t sleep_for = 0; // in the button's handler
+
+static void mark(intptr_t c)
+{
+    if (order_cnt < int(sizeof(order)) - 1)
+        order[order_cnt++] = char(c);
+    order[order_cnt] = '\0';
+}
+
+static void on_tap(intptr_t c)
+{
+    mark(c);
+    sleep_us(sleep_for);
+}
+
+static void slow(intptr_t c)
+{
+    mark(c);
+    sleep_us(30'000);
+}
+
+static GuiLoop *loop_ = nullptr;
+
+static void quit(intptr_t)
+{
+    loop_->stop();
+}
+
+// advance the clock in 1 ms ticks, stepping until idle at each
+static void run_for(GuiLoop &loop, int ms)
+{
+    for (int i = 0; i < ms; i++) {
+        while (loop.step())
+            ;
+        HostClock::advance(1000);
+    }
+}
+
+static bool run()
+{
+    bool ok = true;
+    HostClock::simulate(true);
+
+    FbRecord fb;
+    TsScript ts;
+    GuiButton btn(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                  &btn_img.hdr, nullptr, 0, on_tap, 'T', nullptr, 0);
+    GuiPage page({&btn});
+    page.visible(true);
+
+    GuiLoop loop(ts);
+    loop.page(&page);
+    loop.frame_budget(GuiLoop::frame_us(480 * 320 / 4, 15'000'000));
+
+    const int a = loop.every(10'000, mark, 'a');
+    const int b = loop.every(25'000, mark, 'b');
+    run_for(loop, 101);
+    check(loop.runs(a) == 10 && loop.runs(b) == 4);
+    check(loop.stats().missed == 0);
+    check(strncmp(order, "aabaaab", 7) == 0);
+
+    // a is due, and a tap is waiting: the tap goes first
+    order_cnt = 0;
+    HostClock::advance(10'000);
+    ts.tap(15, 15);
+    while (loop.step())
+        ;
+    check(strcmp(order, "Ta") == 0);
+    check(loop.stats().frames == 1 && loop.stats().overruns == 0);
+
+    // a slow tap handler overruns the frame budget
+    sleep_for = 50'000;
+    ts.tap(15, 15);
+    loop.step();
+    sleep_for = 0;
+    check(loop.stats().overruns == 1);
+    check(loop.stats().worst_frame_us >= 50'000);
+
+    // a 30 ms task makes a 10 ms one miss deadlines
+    loop.cancel(b);
+    const int s = loop.every(50'000, slow, 's');
+    run_for(loop, 120);
+    check(loop.runs(s) >= 2);
+    check(loop.missed(a) >= 2 * loop.runs(s));
+    check(loop.missed(s) == 0);
+
+    // stop() from a task
+    loop.cancel(a);
+    loop.cancel(s);
+    loop_ = &loop;
+    const int q = loop.every(5'000, quit);
+    HostClock::advance(5'000);
+    loop.run();
+    check(loop.runs(q) == 1);
+
+    HostClock::simulate(false);
+    return ok;
+}
+
+} // namespace Loop1
+
+
+namespace Anim1 {
+
+// On the simulated clock: with a fast panel, a tween draws a frame every
+// minimum interval and ends exactly at its target; with a slow one, frames
+// are paced to the drawing time and the rest are skipped, and the tween
+// still ends on time. Delayed tweens wait their turn, and a tweened number
+// is laid out where it moves to.
+
+static Color fade[64];
+
+static void set_fade(intptr_t text, int i)
+{
+    reinterpret_cast<GuiText *>(text)->set_color(fade[i]);
+}
+
+static bool run()
+{
+    bool ok = true;
+    HostClock::simulate(true);
+
+    using Ease = GuiAnimator::Ease;
+    const int32_t one = GuiAnimator::one;
+    check(GuiAnimator::ease(Ease::linear, one / 2) == one / 2);
+    check(GuiAnimator::ease(Ease::in, one / 2) == one / 4);
+    check(GuiAnimator::ease(Ease::out, one / 2) == one * 3 / 4);
+    check(GuiAnimator::ease(Ease::in_out, one / 2) == one / 2);
+    for (Ease e : {Ease::linear, Ease::in, Ease::out, Ease::in_out})
+        check(GuiAnimator::ease(e, 0) == 0 && GuiAnimator::ease(e, one) == one);
+
+    FbRecord fb;
+    fb.paced(true);
+    fb.fill_rect(0, 0, fb.width(), fb.height(), screen_bg);
+
+    // fast panel: every frame at 20 ms
+    GuiSlider sld(fb, 40, 40, 400, 40, screen_fg, screen_bg, Color::gray(90),
+                  Color::white(), 0, 100, 0, nullptr, 0);
+    sld.draw();
+    GuiAnimator anim(20'000);
+    uint64_t start = time_us_64();
+    anim.start(0, 100, 1'000'000, GuiAnimator::slider_value, intptr_t(&sld),
+               Ease::in_out);
+    anim.run();
+    uint64_t took = time_us_64() - start;
+    printf("  fast: %lu frames, %lu skipped, %llu us\n",
+           (unsigned long)anim.stats().frames,
+           (unsigned long)anim.stats().skipped, (unsigned long long)took);
+    check(sld.get_value() == 100);
+    check(anim.stats().frames == 51 && anim.stats().skipped == 0);
+    check(anim.frame_us() == 20'000);
+    check(took >= 1'000'000 && took < 1'000'000 + 20'000);
+
+    // slow panel: each frame rewrites the text, ~50 ms at 4 MHz
+    for (int i = 0; i < 64; i++)
+        fade[i] = screen_fg.blend(screen_bg, 255 - i * 4);
+    GuiText txt(fb, 40, 120, screen_bg, host_font_48, fade[0], "0123456789");
+    txt.draw();
+    fb.baud(4'000'000);
+    fb.reset_stats();
+    txt.draw();
+    const uint32_t draw_us = uint32_t(fb.us());
+
+    anim.reset_stats();
+    start = time_us_64();
+    anim.start(0, 63, 1'000'000, set_fade, intptr_t(&txt));
+    anim.run();
+    took = time_us_64() - start;
+    const uint32_t frames = anim.stats().frames;
+    const uint32_t skipped = anim.stats().skipped;
+    printf("  slow: draw %lu us, %lu frames, %lu skipped, %llu us\n",
+           (unsigned long)draw_us, (unsigned long)frames,
+           (unsigned long)skipped, (unsigned long long)took);
+    check(draw_us > 2 * 20'000);
+    check(frames <= took / draw_us + 1);
+    check(frames + skipped >= 48 && frames + skipped <= 52);
+    check(anim.frame_us() >= draw_us - draw_us / 8);
+    check(took >= 1'000'000 && took < 1'000'000 + 2 * draw_us);
+    check(txt.get_color() == fade[63]);
+
+    // a timeline: the move starts when the fade ends
+    fb.baud(15'000'000);
+    fade[0] = screen_fg;
+    start = time_us_64();
+    const int f = anim.start(63, 0, 300'000, set_fade, intptr_t(&txt));
+    const int m = anim.start(40, 140, 200'000, GuiAnimator::widget_col,
+                             intptr_t(&txt), Ease::out, 300'000);
+    check(f >= 0 && m >= 0 && f != m);
+    while (anim.running(f)) {
+        anim.step();
+        HostClock::advance(1'000);
+    }
+    check(txt.rect().col < 140);
+    anim.run();
+    took = time_us_64() - start;
+    printf("  timeline: %llu us\n", (unsigned long long)took);
+    check(txt.rect().col == 140);
+    check(took >= 500'000 && took < 500'000 + 50'000);
+    check(!anim.running());
+
+    // a number's column, which it lays out from: it ends up where a number
+    // drawn there would be, with nothing left behind
+    FbRecord fn;
+    fn.fill_rect(0, 0, fn.width(), fn.height(), screen_bg);
+    GuiNumber num(fn, 40, 200, screen_bg, host_font_48_digit_img, 1234);
+    num.draw();
+    anim.start(40, 300, 200'000, GuiAnimator::widget_col, intptr_t(&num));
+    anim.run();
+    check(num.rect().col == 300);
+    FbRecord rn;
+    rn.fill_rect(0, 0, rn.width(), rn.height(), screen_bg);
+    GuiNumber rnum(rn, 300, 200, screen_bg, host_font_48_digit_img, 1234);
+    rnum.draw();
+    check(same_screen(fn, rn));
+
+    HostClock::simulate(false);
+    return ok;
+}
+
+} // namespace Anim1
+
+
+namespace Stats1 {
+
+// Per-widget counters (GUI_STATS) add up to what FbRecord received, each
+// widget's draw time is its share of the paced SPI time, and a tap lands in
+// the button's latency histogram.
+
+using HitTest1::btn_img;
+
+static void on_down(intptr_t)
+{
+    sleep_us(300);
+}
+
+struct Rig {
+    GuiNumber num;
+    GuiSlider sld;
+    GuiButton btn;
+    GuiPage page;
+
+    Rig(FbRecord &fb) :
+        num(fb, 200, 40, screen_bg, host_font_48_digit_img, 0, HAlign::Right),
+        sld(fb, 240, 40, 200, 40, screen_fg, screen_bg, Color::gray(90),
+            Color::white(), 0, 100, 0, nullptr, 0),
+        btn(fb, 20, 200, screen_bg, &btn_img.hdr, &btn_img.hdr, &btn_img.hdr,
+            nullptr, 0, on_down, 0, nullptr, 0),
+        page({&num, &sld, &btn})
+    {
+    }
+
+    uint64_t pixels() const
+    {
+        return num.stats().pixels + sld.stats().pixels + btn.stats().pixels;
+    }
+
+    uint64_t draw_us() const
+    {
+        return num.stats().draw_us + sld.stats().draw_us +
+               btn.stats().draw_us;
+    }
+};
+
+static bool run()
+{
+    bool ok = true;
+    HostClock::simulate(true);
+
+    check(GuiStats::bin(0) == 0 && GuiStats::bin(63) == 0);
+    check(GuiStats::bin(64) == 1 && GuiStats::bin(300) == 3);
+    check(GuiStats::bin(1'000'000) == GuiStats::bins - 1);
+
+    FbRecord fb;
+    fb.paced(true);
+    Rig rig(fb);
+
+    // every widget drawn once, all pixels accounted for
+    rig.page.visible(true);
+    check(rig.num.stats().draws == 1 && rig.sld.stats().draws == 1 &&
+          rig.btn.stats().draws == 1);
+    check(rig.pixels() == fb.stats().pixels);
+    // paced windows each round down to a microsecond
+    check(rig.draw_us() <= fb.us());
+    check(rig.draw_us() + fb.stats().windows >= fb.us());
+
+    // deferred changes: only what changed draws, and only its pixels count
+    rig.page.deferred(true);
+    rig.num.reset_stats();
+    rig.sld.reset_stats();
+    rig.btn.reset_stats();
+    fb.reset_stats();
+    rig.sld.set_value(60);
+    rig.page.flush();
+    check(rig.sld.stats().draws == 1 && rig.num.stats().draws == 0);
+    check(rig.sld.stats().pixels == fb.stats().pixels);
+    rig.num.set_value(1234);
+    rig.page.flush();
+    check(rig.num.stats().draws == 1 && rig.btn.stats().draws == 0);
+    check(rig.pixels() == fb.stats().pixels);
+
+    // immediate mode: invalidate() draws, and counts
+    rig.page.deferred(false);
+    fb.reset_stats();
+    rig.num.reset_stats();
+    rig.num.set_value(7);
+    check(rig.num.stats().draws == 1);
+    check(rig.num.stats().pixels == fb.stats().pixels);
+
+    // a displayed list: recording is not drawing, replaying is
+    static constexpr int max_ops = 32;
+    GuiDisplayList::Op ops[max_ops];
+    GuiDisplayList list(ops, max_ops);
+    rig.page.display_list(&list);
+    rig.page.visible(false);
+    rig.num.reset_stats();
+    rig.sld.reset_stats();
+    rig.btn.reset_stats();
+    fb.reset_stats();
+    rig.page.visible(true);
+    check(rig.pixels() == fb.stats().pixels);
+    rig.page.display_list(nullptr);
+
+    // a tap: the button claims it after its 300 us handler (and its redraw)
+    Touchscreen::Event down(Touchscreen::Event::Type::down, 30, 210);
+    Touchscreen::Event up(Touchscreen::Event::Type::up, 30, 210);
+    check(rig.page.event(down));
+    check(rig.page.event(up));
+    const GuiStats &st = rig.btn.stats();
+    check(st.events == 2);
+    uint32_t binned = 0;
+    for (int b = 0; b < GuiStats::bins; b++)
+        binned += st.latency[b];
+    check(binned == 2);
+    for (int b = 0; b < GuiStats::bin(300); b++)
+        check(st.latency[b] == 0);
+    check(st.latency_max_us >= 300);
+    check(rig.num.stats().events == 0);
+
+    GuiWidget::print_stats();
+
+    HostClock::simulate(false);
+    return ok;
+}
+
+} // namespace Stats1
+
+
+namespace Latency1 {
+
+// Scripted taps through GuiLoop on the simulated clock: a press's latency
+// is the button's paced redraw; a press queued behind a slow handler waits
+// for it; a press on nothing, or on a slider that redraws a button, is
+// abandoned; a slower panel is slower.
+
+using HitTest1::btn_img;
+using HitTest1::btn_wid;
+using HitTest1::btn_hgt;
+
+static void slow_down(intptr_t)
+{
+    sleep_us(5'000);
+}
+
+// disables a button, which redraws it
+static void disable(intptr_t arg)
+{
+    reinterpret_cast<GuiButton *>(arg)->enabled(false);
+}
+
+// let the loop handle everything, then wait a while
+static void settle(GuiLoop &loop)
+{
+    while (loop.step())
+        ;
+    HostClock::advance(100'000);
+}
+
+static bool run()
+{
+    bool ok = true;
+    HostClock::simulate(true);
+
+    check(GuiLatency::Hist::bin(7) == 7 && GuiLatency::Hist::bin(8) == 8);
+    check(GuiLatency::Hist::bin_us(GuiLatency::Hist::bin(1925)) <= 1925);
+    check(GuiLatency::Hist::bin_us(GuiLatency::Hist::bin(1925) + 1) > 1925);
+
+    FbRecord fb;
+    fb.paced(true);
+    TsScript ts;
+    GuiButton a(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                &btn_img.hdr, nullptr, 0, slow_down, 0, nullptr, 0);
+    GuiButton b(fb, 100, 10, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                &btn_img.hdr, nullptr, 0, nullptr, 0, nullptr, 0);
+    GuiPage page({&a, &b});
+    page.visible(true);
+    GuiLoop loop(ts);
+    loop.page(&page);
+
+    GuiLatency lat;
+    GuiLatency::probe = &lat;
+
+    // one window of the button's pixels
+    const uint32_t draw_us = uint32_t(
+        fb.bytes_us(FbRecord::window_bytes + btn_wid * btn_hgt * 2));
+
+    for (int i = 0; i < 20; i++) {
+        ts.tap(110, 20);
+        settle(loop);
+    }
+    lat.print();
+    check(lat.total().count() == 20 && lat.abandoned() == 0);
+    check(lat.queued().max() == 0 && lat.handled().max() == 0);
+    check(lat.drawn().max() == draw_us);
+    check(lat.total().percentile(50) == draw_us);
+    check(lat.total().percentile(99) == draw_us);
+
+    // b's press waits for a's: its redraw, 5 ms handler and release redraw
+    lat.reset();
+    ts.tap(20, 20);
+    ts.tap(110, 20);
+    settle(loop);
+    check(lat.total().count() == 2);
+    check(lat.queued().max() == 2 * draw_us + 5'000);
+    check(lat.total().max() == 3 * draw_us + 5'000);
+
+    // a press on nothing draws nothing
+    lat.reset();
+    ts.tap(300, 300);
+    settle(loop);
+    ts.tap(110, 20);
+    settle(loop);
+    check(lat.total().count() == 1 && lat.abandoned() == 1);
+
+    // the slider's press redraws b, but b was not pressed
+    GuiSlider sld(fb, 20, 200, 300, 30, screen_fg, screen_bg, Color::gray(90),
+                  Color::white(), 0, 100, 0, disable, intptr_t(&b));
+    GuiPage sld_page({&a, &b, &sld});
+    loop.page(&sld_page);
+    sld_page.visible(true);
+    lat.reset();
+    ts.tap(170, 215);
+    settle(loop);
+    ts.tap(20, 20);
+    settle(loop);
+    check(lat.total().count() == 1 && lat.abandoned() == 1);
+    sld_page.visible(false);
+    b.enabled(true);
+    loop.page(&page);
+    page.visible(true);
+
+    // a slower panel
+    lat.reset();
+    fb.baud(2'000'000);
+    const uint32_t slow_us = uint32_t(
+        fb.bytes_us(FbRecord::window_bytes + btn_wid * btn_hgt * 2));
+    for (int i = 0; i < 10; i++) {
+        ts.tap(110, 20);
+        settle(loop);
+    }
+    lat.print();
+    const uint32_t p50 = lat.total().percentile(50);
+    check(p50 >= slow_us && p50 <= slow_us + slow_us / 8);
+    check(lat.total().max() == slow_us);
+
+    GuiLatency::probe = nullptr;
+    HostClock::simulate(false);
+    return ok;
+}
+
+} // namespace Latency1
+
+
+namespace Touch1 {
+
+// GuiTouchInput reads the controller only after an INT edge (or after the
+// fallback time), stamps events with the edge's time, and dispatches
+// injected events through GuiLoop like real ones. A controller that never
+// runs out of events (a held touch) does not keep a read going forever.
+
+using HitTest1::btn_img;
+
+static const uint int_gpio = 17;
+
+// counts reads (I2C transactions on real hardware)
+class TsCount : public TsScript
+{
+public:
+
+    int reads = 0;
+
+    virtual Event get_event() override
+    {
+        reads++;
+        return TsScript::get_event();
+    }
+};
+
+// reports a held touch on every read
+class TsHeld : public Touchscreen
+{
+public:
+
+    int reads = 0;
+
+    virtual Event get_event() override
+    {
+        reads++;
+        return Event(Event::Type::move, 20, 20);
+    }
+};
+
+static int downs = 0;
+
+static void on_down(intptr_t)
+{
+    downs++;
+}
+
+static bool run()
+{
+    bool ok = true;
+    HostClock::simulate(true);
+    using Type = Touchscreen::Event::Type;
+
+    TsCount ts;
+    GuiTouchInput input(ts, int_gpio);
+    input.irq_enable(GPIO_IRQ_EDGE_FALL);
+
+    // no edge, no reads
+    input.get_event();
+    const int reads = ts.reads;
+    const uint32_t input_reads = input.reads();
+    for (int i = 0; i < 1000; i++) {
+        check(input.get_event().type == Type::none);
+        HostClock::advance(50);
+    }
+    check(ts.reads == reads);
+
+    // an edge: the next call reads the whole tap, stamped with the edge
+    ts.tap(20, 20);
+    HostGpio::edge(int_gpio, GPIO_IRQ_EDGE_RISE); // not enabled
+    check(input.get_event().type == Type::none);
+    const uint64_t edge_us = time_us_64();
+    HostGpio::edge(int_gpio, GPIO_IRQ_EDGE_FALL);
+    HostClock::advance(2'000);
+    check(input.get_event().type == Type::down);
+    check(input.event_us() == edge_us);
+    check(input.get_event().type == Type::up);
+    check(input.get_event().type == Type::none);
+    check(input.reads() == input_reads + 1);
+
+    // a missed edge is picked up after the fallback time
+    ts.tap(20, 20);
+    HostClock::advance(100'000);
+    check(input.get_event().type == Type::down);
+    check(input.get_event().type == Type::up);
+    check(input.reads() == input_reads + 2);
+
+    // injected events go through the ring to the loop and the button,
+    // without touching the controller
+    FbRecord fb;
+    GuiButton btn(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                  &btn_img.hdr, nullptr, 0, on_down, 0, nullptr, 0);
+    GuiPage page({&btn});
+    page.visible(true);
+    GuiLoop loop(input);
+    loop.page(&page);
+    const int before = ts.reads;
+    for (int i = 0; i < 5; i++) {
+        check(input.inject(Touchscreen::Event(Type::down, 20, 20)));
+        check(input.inject(Touchscreen::Event(Type::up, 20, 20)));
+        while (loop.step())
+            ;
+        HostClock::advance(1'000);
+    }
+    check(downs == 5);
+    check(ts.reads == before);
+
+    // a down's latency counts from its stamp, not from when it was read
+    GuiLatency lat;
+    GuiLatency::probe = &lat;
+    check(input.inject(Touchscreen::Event(Type::down, 20, 20),
+                       time_us_64() - 3'000));
+    check(input.inject(Touchscreen::Event(Type::up, 20, 20)));
+    while (loop.step())
+        ;
+    GuiLatency::probe = nullptr;
+    check(lat.total().count() == 1 && lat.queued().max() == 3'000);
+
+    // a full ring drops the newest
+    for (int i = 0; i < GuiTouchInput::Ring::capacity; i++)
+        check(input.inject(Touchscreen::Event(Type::move, i, 0)));
+    check(!input.inject(Touchscreen::Event(Type::move, 0, 0)));
+    check(input.ring().dropped() == 1);
+
+    // a held touch: one INT reads a ring's worth, and a poll a queue's worth
+    TsHeld held;
+    GuiTouchInput held_input(held, -1, 1'000);
+    HostClock::advance(1'000);
+    check(held_input.get_event().type == Type::move);
+    check(held.reads == GuiTouchInput::Ring::capacity);
+    GuiEventQueue queue;
+    held.reads = 0;
+    check(queue.poll(held) == GuiEventQueue::capacity);
+    check(held.reads == GuiEventQueue::capacity);
+
+    HostClock::simulate(false);
+    return ok;
+}
+
+} // namespace Touch1
+
+
+namespace Idle1 {
+
+// An idle GuiLoop on the simulated clock, with touches played in by
+// HostClock::at() callbacks: it sleeps between a 1 s update task's runs,
+// an interrupt wakes it at once, a polled touchscreen's touches are still
+// drawn within the wake bound, the backlight dims after 2 s without a
+// touch and comes back with the next, and wake() ends a sleep early. A
+// step longer than the wake bound doesn't stop the sleeps: not at all with
+// an interrupt, and only for a while when polled.
+
+using HitTest1::btn_img;
+
+static const uint int_gpio = 18;
+
+static FbRecord *fb_ = nullptr;
+static TsScript *ts_ = nullptr;
+static GuiLoop *loop_ = nullptr;
+
+static uint64_t tap_us = 0;
+static uint32_t worst_us = 0; // tap to pressed image drawn
+static int taps = 0;
+static uint32_t down_us = 0; // time the handler takes
+
+static void on_down(intptr_t)
+{
+    const uint32_t us = uint32_t(time_us_64() - tap_us);
+    if (us > worst_us)
+        worst_us = us;
+    taps++;
+    sleep_us(down_us);
+}
+
+// a tap that raises INT
+static void irq_tap(intptr_t)
+{
+    tap_us = time_us_64();
+    ts_->tap(20, 20);
+    HostGpio::edge(int_gpio, GPIO_IRQ_EDGE_FALL);
+}
+
+// a tap on a touchscreen without an interrupt
+static void quiet_tap(intptr_t)
+{
+    tap_us = time_us_64();
+    ts_->tap(20, 20);
+}
+
+// just before and after the dimming time, and after the second tap
+static int brightness[3];
+
+static void sample(intptr_t i)
+{
+    brightness[i] = fb_->brightness();
+}
+
+static void update(intptr_t)
+{
+    sleep_us(200); // some work
+}
+
+static void quit(intptr_t)
+{
+    loop_->stop();
+    GuiLoop::wake();
+}
+
+static bool run()
+{
+    bool ok = true;
+    HostClock::simulate(true);
+
+    FbRecord fb;
+    fb.paced(true);
+    fb.brightness(100);
+    TsScript ts;
+    fb_ = &fb;
+    ts_ = &ts;
+
+    GuiButton btn(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                  &btn_img.hdr, nullptr, 0, on_down, 0, nullptr, 0);
+    GuiPage page({&btn});
+    page.visible(true);
+
+    // interrupt-driven input
+    GuiTouchInput input(ts, int_gpio);
+    input.irq_enable(GPIO_IRQ_EDGE_FALL);
+    GuiLoop loop(input);
+    loop_ = &loop;
+    loop.page(&page);
+    const int upd = loop.every(1'000'000, update);
+    loop.idle(50'000);
+    loop.dim(&fb, 2'000'000, 10);
+
+    const uint64_t t0 = time_us_64();
+    HostClock::at(t0 + 500'000, irq_tap);
+    HostClock::at(t0 + 2'490'000, sample, 0);
+    HostClock::at(t0 + 2'560'000, sample, 1);
+    HostClock::at(t0 + 4'000'000, irq_tap);
+    HostClock::at(t0 + 4'100'000, sample, 2);
+    HostClock::at(t0 + 10'000'000, quit);
+    loop.run();
+    const uint64_t t1 = time_us_64();
+
+    const GuiLoop::Stats &st = loop.stats();
+    printf("  10 s: idle %llu us in %lu sleeps, dispatch %llu us, draw %llu "
+           "us, tasks %llu us; worst tap %lu us\n",
+           (unsigned long long)st.idle_us, (unsigned long)st.sleeps,
+           (unsigned long long)st.dispatch_us, (unsigned long long)st.draw_us,
+           (unsigned long long)st.task_us, (unsigned long)worst_us);
+    check(t1 == t0 + 10'000'000); // wake() ended the last sleep
+    check(taps == 2);
+    check(worst_us <= 2 * fb.bytes_us(FbRecord::window_bytes +
+                                      HitTest1::btn_wid * HitTest1::btn_hgt * 2));
+    check(loop.runs(upd) == 9); // quit() came first at 10 s
+    check(st.task_us == 9 * 200);
+    check(st.idle_us >= 10'000'000 - 10'000); // everything else is < 1%
+    check(st.dispatch_us > 0); // the button draws itself in its handler
+    check(st.sleeps < 10'000'000 / 40'000);
+    check(brightness[0] == 100 && brightness[1] == 10 && brightness[2] == 100);
+    check(loop.dimmed() && fb.brightness() == 10); // again from 6 s
+    loop.cancel(upd);
+
+    // a polled touchscreen: no interrupt, so the bound is what matters
+    GuiLoop polled(ts);
+    loop_ = &polled;
+    polled.page(&page);
+    polled.idle(20'000);
+    HostClock::at(time_us_64() + 1'000, quiet_tap); // learns the step time
+    HostClock::at(time_us_64() + 50'000, quit);
+    polled.run();
+    worst_us = 0;
+    taps = 0;
+    const uint64_t t2 = time_us_64();
+    for (int i = 0; i < 20; i++)
+        HostClock::at(t2 + 10'000 + i * 37'003, quiet_tap);
+    HostClock::at(t2 + 800'000, quit);
+    polled.run();
+    printf("  polled: %d taps, worst %lu us\n", taps, (unsigned long)worst_us);
+    check(taps == 20);
+    check(worst_us <= 20'000);
+    check(polled.stats().idle_us > 800'000 / 2);
+
+    // one step longer than the bound, with an interrupt (reads take time,
+    // so the clock moves on if the loop spins)
+    down_us = 60'000;
+    ts.read_us(100);
+    loop_ = &loop;
+    loop.dim(nullptr, 0, 0);
+    loop.reset_stats();
+    const uint64_t t3 = time_us_64();
+    HostClock::at(t3 + 10'000, irq_tap);
+    HostClock::at(t3 + 10'000'000, quit);
+    loop.run();
+    printf("  60 ms step: idle %llu us in %lu sleeps\n",
+           (unsigned long long)loop.stats().idle_us,
+           (unsigned long)loop.stats().sleeps);
+    check(loop.stats().idle_us >= 10'000'000 - 100'000);
+
+    // and polled: no sleeps for a while after it, then sleeps again
+    loop_ = &polled;
+    polled.reset_stats();
+    const uint64_t t4 = time_us_64();
+    HostClock::at(t4 + 10'000, quiet_tap);
+    HostClock::at(t4 + 10'000'000, quit);
+    polled.run();
+    check(polled.stats().idle_us >= 10'000'000 - 2 * GuiLoop::step_window_us -
+                                        100'000);
+    check(polled.stats().sleeps > 0);
+    ts.read_us(0);
+    down_us = 0;
+
+    HostClock::simulate(false);
+    return ok;
+}
+
+} // namespace Idle1
+
+
+namespace Swap1 {
+
+// GuiPageBase::swap() must leave the screen as hiding one page and showing
+// the other does, filling background only where no opaque widget of the
+// new page draws. Pages are GuiPages and a GuiStaticPage (via its adapter).
+// A widget that changed while its deferred page was hidden is drawn over
+// what it covers now, not what it covered when last drawn.
+
+using HitTest1::btn_hgt;
+using HitTest1::btn_img;
+using HitTest1::btn_wid;
+
+static constexpr int btn_area = btn_wid * btn_hgt;
+
+struct Screen {
+    // a: three labels and a number
+    GuiLabel a0, a1, a2;
+    GuiNumber a3;
+    GuiPage a;
+    // b: one label exactly over a0, one half over a1, and a button over a2
+    GuiLabel b0, b1;
+    GuiButton b2;
+    GuiPage b;
+    // c: one label over b1, one where nothing was
+    GuiLabel c0, c1;
+    GuiStaticPage<GuiLabel &, GuiLabel &> c;
+    GuiPageAdapter<decltype(c)> c_adapter;
+    // d: a number over a's
+    GuiNumber d0;
+    GuiPage d;
+
+    Screen(Framebuffer &fb) :
+        a0(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr),
+        a1(fb, 100, 10, screen_bg, &btn_img.hdr, &btn_img.hdr),
+        a2(fb, 10, 100, screen_bg, &btn_img.hdr, &btn_img.hdr),
+        a3(fb, 200, 200, screen_bg, host_font_48_digit_img, 1234),
+        a({&a0, &a1, &a2, &a3}),
+        b0(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr),
+        b1(fb, 130, 10, screen_bg, &btn_img.hdr, &btn_img.hdr),
+        b2(fb, 10, 100, screen_bg, &btn_img.hdr, &btn_img.hdr, &btn_img.hdr,
+           nullptr, 0, nullptr, 0, nullptr, 0),
+        b({&b0, &b1, &b2}),
+        c0(fb, 130, 10, screen_bg, &btn_img.hdr, &btn_img.hdr),
+        c1(fb, 300, 100, screen_bg, &btn_img.hdr, &btn_img.hdr),
+        c(c0, c1),
+        c_adapter(c),
+        d0(fb, 200, 200, screen_bg, host_font_48_digit_img, 88888),
+        d({&d0})
+    {
+    }
+};
+
+static bool run()
+{
+    bool ok = true;
+
+    FbRecord ref; // hide, then show
+    FbRecord fb;  // swap()
+    Screen rs(ref);
+    Screen ss(fb);
+    rs.a.visible(true);
+    ss.a.visible(true);
+    check(same_screen(ref, fb));
+
+    // a to b: a0 and a2 are all covered, a1 half, and the number not at all
+    ref.reset_stats();
+    fb.reset_stats();
+    rs.a.visible(false);
+    rs.b.visible(true);
+    const GuiPageBase::Swap s1 = GuiPageBase::swap(ss.a, ss.b);
+    check(same_screen(ref, fb));
+    const int num_area = ss.a3.rect().area();
+    check(num_area > 0);
+    check(s1.erased == uint32_t(btn_area / 2 + num_area));
+    check(s1.saved == uint32_t(2 * btn_area + btn_area / 2));
+    check(fb.stats().pixels + s1.saved == ref.stats().pixels);
+    printf("  a to b: %lu pixels erased, %lu saved\n",
+           (unsigned long)s1.erased, (unsigned long)s1.saved);
+
+    // b to c, c being a GuiStaticPage
+    ref.reset_stats();
+    fb.reset_stats();
+    rs.b.visible(false);
+    rs.c_adapter.visible(true);
+    const GuiPageBase::Swap s2 = GuiPageBase::swap(ss.b, ss.c_adapter);
+    check(same_screen(ref, fb));
+    check(s2.erased == uint32_t(2 * btn_area));
+    check(s2.saved == uint32_t(btn_area));
+    check(fb.stats().pixels + s2.saved == ref.stats().pixels);
+
+    // and back to a, over which nothing of c is erased twice
+    rs.c_adapter.visible(false);
+    rs.a.visible(true);
+    GuiPageBase::swap(ss.c_adapter, ss.a);
+    check(same_screen(ref, fb));
+
+    // the number was swapped out and back; a change is drawn as usual
+    rs.a3.set_value(1235);
+    ss.a3.set_value(1235);
+    check(same_screen(ref, fb));
+
+    // a to d and back, then d gets narrower while hidden
+    rs.a.visible(false);
+    rs.d.visible(true);
+    GuiPageBase::swap(ss.a, ss.d);
+    rs.d.visible(false);
+    rs.a.visible(true);
+    GuiPageBase::swap(ss.d, ss.a);
+    check(same_screen(ref, fb));
+    for (Screen *sc : {&rs, &ss}) {
+        sc->d.deferred(true);
+        sc->d0.set_value(1);
+        sc->d.flush();
+    }
+    rs.a.visible(false);
+    rs.d.visible(true);
+    GuiPageBase::swap(ss.a, ss.d);
+    check(same_screen(ref, fb));
+
+    return ok;
+}
+
+} // namespace Swap1
+
+
+namespace Background1 {
+
+// Widgets on a page with a GuiBackground must erase to exactly what the
+// background has there (drawing straight or through a canvas), at a cost of
+// the area erased, with repeated areas coming from cached tiles.
+
+using HitTest1::btn_hgt;
+using HitTest1::btn_img;
+using HitTest1::btn_wid;
+
+// the area of fb matches src
+static bool matches(const FbRecord &fb, const GuiBackground::Source &src,
+                    const GuiRect &r)
+{
+    std::vector<Pixel565> line(r.wid);
+    for (int row = r.row; row < r.row + r.hgt; row++) {
+        src.span(r.col, row, r.wid, line.data());
+        for (int c = 0; c < r.wid; c++)
+            if (!(fb.pixel(r.col + c, row) == line[c]))
+                return false;
+    }
+    return true;
+}
+
+static uint8_t mem[2][16 * 1024];
+static uint8_t work[64 * 1024];
+
+static bool run()
+{
+    bool ok = true;
+
+    // each source, for an area not on the tile grid
+    const GuiBackground::GradientSource vgrad(Color::red(), Color::blue(), 320);
+    const GuiBackground::GradientSource hgrad(Color::white(), Color::black(),
+                                              480, false);
+    const GuiBackground::TiledSource tiled(&btn_img.hdr);
+    const GuiBackground::ImageSource image(&btn_img.hdr, 20, 30,
+                                           Color::green());
+    const GuiBackground::Source *sources[] = {&vgrad, &hgrad, &tiled, &image};
+    for (const GuiBackground::Source *src : sources) {
+        FbRecord fb;
+        GuiBackground bg(*src, mem[0], sizeof(mem[0]));
+        const GuiRect r{7, 5, 150, 41};
+        bg.restore(fb, r.col, r.row, r.wid, r.hgt);
+        check(matches(fb, *src, r));
+        check(fb.stats().pixels == uint64_t(r.area()));
+    }
+
+    // the cache: a vertical gradient is the same in every column, so a
+    // screen needs one tile per row of tiles; and a second restore of an
+    // area is all hits
+    {
+        FbRecord fb;
+        GuiBackground bg(vgrad, mem[0], sizeof(mem[0]));
+        check(bg.slots() >= 20);
+        bg.restore(fb, 0, 0, 480, 320);
+        check(matches(fb, vgrad, GuiRect{0, 0, 480, 320}));
+        check(bg.misses() == 320 / GuiBackground::tile);
+        bg.reset_stats();
+        GuiBackground img_bg(image, mem[1], sizeof(mem[1]));
+        img_bg.restore(fb, 30, 40, 50, 20);
+        const uint32_t misses = img_bg.misses();
+        img_bg.restore(fb, 30, 40, 50, 20);
+        check(img_bg.misses() == misses && img_bg.hits() > 0);
+    }
+
+    // a number getting shorter through each canvas: the digits it uncovers
+    // are queued for the render core, recorded, or composed as background
+    using Code = GuiDisplayList::Op::Code;
+    for (int pass = 0; pass < 3; pass++) {
+        FbRecord fb;
+        GuiBackground bg(vgrad, mem[1], sizeof(mem[1]));
+        bg.restore(fb, 0, 0, 480, 320);
+        GuiNumber n0(fb, 200, 100, screen_bg, host_font_48_digit_img, 12345);
+        GuiPage page({&n0});
+        page.background(&bg);
+        page.visible(true);
+        const GuiRect before = n0.rect();
+
+        GuiRenderQueue queue;
+        GuiDisplayList::Op ops[8];
+        GuiDisplayList list(ops, 8);
+        GuiCompositor comp(work, sizeof(work));
+        if (pass == 0) {
+            GuiWidget::canvas = &queue;
+        } else if (pass == 1) {
+            GuiWidget::canvas = &list;
+            list.begin(0);
+        } else {
+            GuiWidget::canvas = &comp;
+            comp.begin(fb, before.col, before.row, before.wid, before.hgt,
+                       screen_bg);
+        }
+        n0.set_value(1);
+        GuiWidget::canvas = nullptr;
+        if (pass == 0) {
+            while (queue.render_one())
+                ;
+        } else if (pass == 1) {
+            int restores = 0;
+            for (int i = 0; i < list.size(); i++) {
+                if (list[i].code == Code::restore && list[i].bg == &bg) {
+                    restores++;
+                    bg.restore(fb, list[i].a, list[i].b, list[i].c,
+                               list[i].d);
+                }
+            }
+            check(restores > 0);
+        } else {
+            comp.end();
+        }
+        check(matches(fb, vgrad,
+                      GuiRect{n0.rect().col + n0.rect().wid, before.row,
+                              before.wid - n0.rect().wid, before.hgt}));
+    }
+
+    // a page over a gradient: hide, a number getting shorter, and a swap
+    FbRecord ref; // just the background
+    FbRecord fb;
+    GuiBackground ref_bg(vgrad, mem[0], sizeof(mem[0]));
+    GuiBackground bg(vgrad, mem[1], sizeof(mem[1]));
+    ref_bg.restore(ref, 0, 0, 480, 320);
+    bg.restore(fb, 0, 0, 480, 320);
+
+    GuiLabel l0(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr);
+    GuiLabel l1(fb, 100, 10, screen_bg, &btn_img.hdr, &btn_img.hdr);
+    GuiNumber n0(fb, 200, 100, screen_bg, host_font_48_digit_img, 12345);
+    GuiPage a({&l0, &l1, &n0});
+    a.background(&bg);
+    GuiLabel l2(fb, 130, 10, screen_bg, &btn_img.hdr, &btn_img.hdr);
+    GuiPage b({&l2});
+    b.background(&bg);
+
+    a.visible(true);
+    const GuiRect n0_rect = n0.rect();
+    fb.reset_stats();
+    n0.set_value(1); // the 1 is already there; four digits erased
+    check(fb.stats().pixels == uint64_t(n0_rect.area() - n0.rect().area()));
+    check(matches(fb, vgrad,
+                  GuiRect{n0.rect().col + n0.rect().wid, n0_rect.row,
+                          n0_rect.wid - n0.rect().wid, n0_rect.hgt}));
+
+    a.visible(false);
+    check(same_screen(ref, fb));
+
+    a.visible(true);
+    const GuiPageBase::Swap s = GuiPageBase::swap(a, b);
+    check(s.saved == uint32_t(btn_wid * btn_hgt / 2));
+    b.visible(false);
+    check(same_screen(ref, fb));
+
+    return ok;
+}
+
+} // namespace Background1
+
+
+namespace Compose1 {
+
+// A page drawn through a GuiCompositor must look exactly as drawn straight
+// to the panel (over its background), in fewer windows, and with no pixel
+// sent twice. Widgets overlap, and draw raw, run-length, mask and text
+// images, digits and rectangles.
+
+using HitTest1::btn_img;
+
+struct Scene {
+    GuiLabel raw;
+    GuiLabel rle;
+    GuiLabel mask;
+    GuiText text;
+    GuiNumber num;
+    GuiSlider sld;
+    GuiPage page;
+
+    Scene(Framebuffer &fb) :
+        raw(fb, 20, 20, screen_bg, &btn_img.hdr, &btn_img.hdr),
+        rle(fb, 50, 35, screen_bg, &Rle1::rle_lbl.hdr, &Rle1::rle_lbl.hdr),
+        mask(fb, 180, 60, screen_bg,
+             GuiImage(&Mask1::mask_8.hdr, &Mask1::pal_ena),
+             GuiImage(&Mask1::mask_8.hdr, &Mask1::pal_ena)),
+        text(fb, 30, 100, Color::gray(90), host_font_24, screen_fg, "T = 21.5"),
+        num(fb, 300, 120, screen_bg, host_font_48_digit_img, 4096),
+        sld(fb, 20, 180, 300, 30, screen_fg, screen_bg, Color::gray(90),
+            Color::white(), 0, 100, 40, nullptr, 0),
+        page({&raw, &rle, &mask, &text, &num, &sld})
+    {
+    }
+};
+
+static uint8_t work[2 * 480 * 2 * 16 + 64];
+static GuiDisplayList::Op ops[64];
+
+static bool run()
+{
+    bool ok = true;
+
+    FbRecord ref;
+    ref.fill_rect(0, 0, ref.width(), ref.height(), screen_bg);
+    Scene rs(ref);
+    ref.reset_stats();
+    rs.page.visible(true);
+    const FbRecord::Stats direct = ref.stats();
+
+    GuiRect area = rs.raw.rect();
+    for (const GuiWidget *w : {(GuiWidget *)&rs.rle, (GuiWidget *)&rs.mask,
+                               (GuiWidget *)&rs.text, (GuiWidget *)&rs.num,
+                               (GuiWidget *)&rs.sld})
+        area = area.bound(w->rect());
+
+    // as many rows as fit, a few rows, and replaying a display list
+    const int max_rows[] = {0, 7, 0};
+    for (int pass = 0; pass < 3; pass++) {
+        FbRecord fb;
+        fb.fill_rect(0, 0, fb.width(), fb.height(), screen_bg);
+        Scene ss(fb);
+        GuiCompositor comp(work, sizeof(work), max_rows[pass]);
+        GuiDisplayList list(ops, 64);
+        if (pass == 2)
+            ss.page.display_list(&list);
+        ss.page.compositor(&comp);
+        fb.reset_stats();
+        ss.page.visible(true);
+        check(same_screen(ref, fb));
+        check(comp.bands() > 0 && fb.stats().windows >= comp.bands() &&
+              fb.stats().windows < direct.windows);
+        check(fb.stats().pixels <= uint64_t(area.area()));
+        check(fb.stats().bytes <= direct.bytes);
+        if (pass == 0)
+            printf("  direct: %llu windows, %llu bytes; composed: %llu "
+                   "windows, %llu bytes\n",
+                   (unsigned long long)direct.windows,
+                   (unsigned long long)direct.bytes,
+                   (unsigned long long)fb.stats().windows,
+                   (unsigned long long)fb.stats().bytes);
+        if (pass == 2)
+            check(list.size() > 0 && !list.overflow());
+    }
+
+    // a row that does not fit: drawn straight to the panel
+    {
+        static uint8_t small[256];
+        FbRecord fb;
+        fb.fill_rect(0, 0, fb.width(), fb.height(), screen_bg);
+        Scene ss(fb);
+        GuiCompositor comp(small, sizeof(small));
+        ss.page.compositor(&comp);
+        ss.page.visible(true);
+        check(comp.bands() == 0);
+        check(same_screen(ref, fb));
+    }
+
+    // Labels in a staircase: over a tall band, the bounding box of each band
+    // is mostly gaps, so they are cheaper drawn straight. With short bands
+    // they are cheaper composed.
+    for (int rows : {0, 4}) {
+        FbRecord fb;
+        GuiLabel s0(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr);
+        GuiLabel s1(fb, 50, 25, screen_bg, &btn_img.hdr, &btn_img.hdr);
+        GuiLabel s2(fb, 90, 40, screen_bg, &btn_img.hdr, &btn_img.hdr);
+        GuiPage page({&s0, &s1, &s2});
+        page.visible(true);
+        const FbRecord::Stats straight = fb.stats();
+        GuiCompositor comp(work, sizeof(work), rows);
+        page.visible(false);
+        page.compositor(&comp);
+        fb.reset_stats();
+        page.visible(true);
+        check(fb.stats().bytes <= straight.bytes);
+        check((comp.bands() > 0) == (rows != 0));
+    }
+
+    // A button under a label is not drawn, and measuring it must not look
+    // like drawing it to the latency probe.
+    {
+        FbRecord fb;
+        GuiButton btn(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr,
+                      &btn_img.hdr, nullptr, 0, nullptr, 0, nullptr, 0);
+        GuiLabel lbl(fb, 10, 10, screen_bg, &btn_img.hdr, &btn_img.hdr);
+        GuiPage page({&btn, &lbl});
+        GuiCompositor comp(work, sizeof(work), 4);
+        page.compositor(&comp);
+        GuiLatency latency;
+        GuiLatency::probe = &latency;
+        Touchscreen::Event down(Touchscreen::Event::Type::down, 20, 20);
+        GuiLatency::captured(down);
+        GuiLatency::dispatched(down);
+        page.visible(true);
+        GuiLatency::probe = nullptr;
+        check(latency.total().count() == 0);
+    }
+
+    return ok;
+}
+
+} // namespace Compose1
+
+
+namespace Assets1 {
+
+// Images rendered by gui_asset_gen at build time must be byte for byte what
+// label_img() and mask_img() render at compile time, and draw the same
+// through a widget.
+
+static constexpr PixelImage<Pixel565, 160, 48> btn_dn_img =
+    label_img<Pixel565, 160, 48>("PAGE 1", host_font_24, screen_fg, 4,
+                                 screen_fg, Color::red());
+
+DIGIT_IMAGE_ARRAY(host_font_24, screen_fg, screen_bg);
+
+// a label sized to another text, plus 2 on each side
+static constexpr int fit_wid = host_font_24.width("Fits") + 4;
+static constexpr int fit_hgt = host_font_24.y_adv + 4;
+static constexpr PixelImage<Pixel565, fit_wid, fit_hgt> fit_img =
+    label_img<Pixel565, fit_wid, fit_hgt>("Fit", host_font_24, screen_fg,
+                                          screen_bg);
+
+// the same, in colors the manifest names
+static constexpr PixelImage<Pixel565, fit_wid, fit_hgt> dis_img =
+    label_img<Pixel565, fit_wid, fit_hgt>("Fit", host_font_24, Color::gray(75),
+                                          Color::gray(25));
+
+// a button twice its text's size
+static constexpr int x2_wid = host_font_24.width("Button") * 2;
+static constexpr int x2_hgt = host_font_24.y_adv * 2;
+static constexpr PixelImage<Pixel565, x2_wid, x2_hgt> x2_img =
+    label_img<Pixel565, x2_wid, x2_hgt>("Button", host_font_24, screen_fg, 4,
+                                        screen_fg, Color::gray(80));
+
+template <typename GEN, typename IMG>
+static bool same_img(const GEN &gen, const IMG &img)
+{
+    return gen.hdr.wid == img.hdr.wid && gen.hdr.hgt == img.hdr.hgt &&
+           sizeof(gen.pixels) == sizeof(img.pixels) &&
+           memcmp(gen.pixels, img.pixels, sizeof(img.pixels)) == 0;
+}
+
+static bool run()
+{
+    bool ok = true;
+
+    check(same_img(asset_lbl_img, DisplayList1::lbl_img));
+    check(same_img(asset_btn_up_img, Rle1::raw_img));
+    check(same_img(asset_btn_dn_img, btn_dn_img));
+    check(same_img(asset_fit_img, fit_img));
+    check(same_img(asset_dis_img, dis_img));
+    check(same_img(asset_2x_btn_dn_img, x2_img));
+    check(asset_nav_mask.hdr.hdr.wid == Mask1::mask_4.hdr.hdr.wid &&
+          asset_nav_mask.hdr.hdr.hgt == Mask1::mask_4.hdr.hdr.hgt &&
+          asset_nav_mask.hdr.bpp == Mask1::mask_4.hdr.bpp &&
+          sizeof(asset_nav_mask.bits) == sizeof(Mask1::mask_4.bits) &&
+          memcmp(asset_nav_mask.bits, Mask1::mask_4.bits,
+                 sizeof(Mask1::mask_4.bits)) == 0);
+    for (int d = 0; d < 10; d++) {
+        const PixelImageHdr *gen = ::host_font_24_digit_img[d];
+        const PixelImageHdr *img = host_font_24_digit_img[d];
+        check(gen->wid == img->wid && gen->hgt == img->hgt &&
+              memcmp(image_pixels<Pixel565>(gen), image_pixels<Pixel565>(img),
+                     sizeof(Pixel565) * img->wid * img->hgt) == 0);
+    }
+
+    FbRecord ref;
+    GuiButton rb(ref, 10, 10, screen_bg, &Rle1::raw_img.hdr,
+                 &Rle1::raw_img.hdr, &btn_dn_img.hdr, nullptr, 0, nullptr, 0,
+                 nullptr, 0);
+    GuiNumber rn(ref, 10, 80, screen_bg, host_font_24_digit_img, 1234567890);
+    rb.visible(true);
+    rn.visible(true);
+
+    FbRecord fb;
+    GuiButton b(fb, 10, 10, screen_bg, &asset_btn_up_img.hdr,
+                &asset_btn_up_img.hdr, &asset_btn_dn_img.hdr, nullptr, 0,
+                nullptr, 0, nullptr, 0);
+    GuiNumber n(fb, 10, 80, screen_bg, ::host_font_24_digit_img, 1234567890);
+    b.visible(true);
+    n.visible(true);
+    check(same_screen(ref, fb));
+
+    return ok;
+}
+
+} // namespace Assets1
@@ -0,0 +1,117 @@
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+// host
+#include "hardware/sync.h"
+#include "host_clock.h"
+#include "pico/stdlib.h"
+
+static std::atomic<bool> sim_on{false};
+static std::atomic<uint64_t> sim_now_us{0};
+
+// an event was sent (__sev()) and not yet waited for
+static std::atomic<bool> sev_pending{false};
+
+struct Callback {
+    uint64_t us;
+    void (*func)(intptr_t);
+    intptr_t arg;
+};
+
+// HostClock::at() callbacks, latest first (only the simulated clock's
+// thread uses these)
+static std::vector<Callback> callbacks;
+
+static uint64_t real_us()
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+
+void HostClock::simulate(bool s)
+{
+    sim_on = s;
+}
+
+
+bool HostClock::simulated()
+{
+    return sim_on;
+}
+
+
+// Run the next callback due at or before until; false if there is none.
+static bool fire_next(uint64_t until)
+{
+    if (callbacks.empty() || callbacks.back().us > until)
+        return false;
+    const Callback cb = callbacks.back();
+    callbacks.pop_back();
+    if (cb.us > sim_now_us)
+        sim_now_us = cb.us;
+    cb.func(cb.arg);
+    return true;
+}
+
+
+void HostClock::advance(uint64_t us)
+{
+    const uint64_t until = sim_now_us + us;
+    while (fire_next(until))
+        ;
+    if (until > sim_now_us)
+        sim_now_us = until;
+}
+
+
+void HostClock::at(uint64_t us, void (*func)(intptr_t), intptr_t arg)
+{
+    callbacks.push_back(Callback{us, func, arg});
+    std::stable_sort(callbacks.begin(), callbacks.end(),
+                     [](const Callback &a, const Callback &b) {
+                         return a.us > b.us;
+                     });
+}
+
+
+uint64_t time_us_64()
+{
+    return sim_on ? uint64_t(sim_now_us) : real_us();
+}
+
+
+void sleep_us(uint64_t us)
+{
+    if (sim_on)
+        HostClock::advance(us);
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+
+void __sev()
+{
+    sev_pending = true;
+}
+
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout)
+{
+    while (!sev_pending.exchange(false)) {
+        const uint64_t now = time_us_64();
+        if (now >= timeout)
+            return true;
+        if (!sim_on)
+            std::this_thread::sleep_for(std::chrono::microseconds(
+                std::min<uint64_t>(timeout - now, 100)));
+        else if (!fire_next(timeout))
+            sim_now_us = timeout;
+    }
+    return false;
+}
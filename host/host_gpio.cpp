@@ -0,0 +1,33 @@
+#include <cstdint>
+// host
+#include "hardware/gpio.h"
+#include "pico/stdlib.h"
+
+static const uint gpio_cnt = 30;
+
+static uint32_t enabled[gpio_cnt];
+
+static gpio_irq_callback_t irq_callback = nullptr;
+
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask,
+                                        bool enable,
+                                        gpio_irq_callback_t callback)
+{
+    if (gpio >= gpio_cnt)
+        return;
+    if (enable)
+        enabled[gpio] |= event_mask;
+    else
+        enabled[gpio] &= ~event_mask;
+    // one callback for all pins, as on the pico
+    irq_callback = callback;
+}
+
+
+void HostGpio::edge(uint gpio, uint32_t event_mask)
+{
+    if (gpio < gpio_cnt && (enabled[gpio] & event_mask) != 0 &&
+        irq_callback != nullptr)
+        irq_callback(gpio, enabled[gpio] & event_mask);
+}
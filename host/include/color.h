@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+// Host stand-in for the framebuffer library's Color: 8-bit RGB, plus "none"
+// (transparent, used for a border that is not drawn).
+
+class Color
+{
+public:
+
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a; // 0 for none(), else 255
+
+    constexpr Color() : r(0), g(0), b(0), a(255)
+    {
+    }
+
+    constexpr Color(uint8_t r_, uint8_t g_, uint8_t b_, uint8_t a_ = 255) :
+        r(r_),
+        g(g_),
+        b(b_),
+        a(a_)
+    {
+    }
+
+    static constexpr Color none()
+    {
+        return Color(0, 0, 0, 0);
+    }
+
+    static constexpr Color black()
+    {
+        return Color(0, 0, 0);
+    }
+
+    static constexpr Color white()
+    {
+        return Color(255, 255, 255);
+    }
+
+    static constexpr Color red()
+    {
+        return Color(255, 0, 0);
+    }
+
+    static constexpr Color green()
+    {
+        return Color(0, 255, 0);
+    }
+
+    static constexpr Color blue()
+    {
+        return Color(0, 0, 255);
+    }
+
+    // pct = 0 is black, 100 is white
+    static constexpr Color gray(int pct)
+    {
+        return Color(uint8_t(pct * 255 / 100), uint8_t(pct * 255 / 100),
+                     uint8_t(pct * 255 / 100));
+    }
+
+    // this color at coverage alpha (0..255) over bg
+    constexpr Color blend(Color bg, int alpha) const
+    {
+        return Color(uint8_t((r * alpha + bg.r * (255 - alpha)) / 255),
+                     uint8_t((g * alpha + bg.g * (255 - alpha)) / 255),
+                     uint8_t((b * alpha + bg.b * (255 - alpha)) / 255));
+    }
+
+    constexpr bool operator==(const Color &c) const
+    {
+        return r == c.r && g == c.g && b == c.b && a == c.a;
+    }
+
+    constexpr bool operator!=(const Color &c) const
+    {
+        return !(*this == c);
+    }
+};
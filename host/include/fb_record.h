@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_565.h"
+#include "pixel_image.h"
+
+// Host framebuffer: an in-memory RGB565 panel that counts what is sent to
+// it.
+//
+// Every fill_rect() or image write is one address window on a real panel.
+// Bytes are estimated as the window setup commands plus two bytes per
+// pixel, and time as those bytes at the SPI baud rate (8 bits per byte, no
+// gaps), i.e. the same "max bytes/sec" as spi_rate_max in gui_test.
+//
+// With paced(true), each window also takes that long: the call returns when
+// the panel would have received the last byte. The caller's thread sleeps
+// meanwhile, the way a DMA transfer leaves the CPU free; windows follow each
+// other back to back, so sleep overshoot does not add up.
+
+class FbRecord : public Framebuffer
+{
+public:
+
+    // CASET + 4, RASET + 4, RAMWR
+    static const int window_bytes = 11;
+
+    struct Stats {
+        uint64_t windows; // fill_rect() and write() calls
+        uint64_t pixels;  // pixels written
+        uint64_t bytes;   // estimated bytes over SPI
+    };
+
+    FbRecord(int width = 480, int height = 320, uint32_t baud = 15'000'000);
+
+    uint32_t baud() const
+    {
+        return _baud;
+    }
+
+    void baud(uint32_t b)
+    {
+        _baud = b;
+    }
+
+    bool paced() const
+    {
+        return _paced;
+    }
+
+    void paced(bool p)
+    {
+        _paced = p;
+    }
+
+    const Stats &stats() const
+    {
+        return _stats;
+    }
+
+    void reset_stats()
+    {
+        _stats = Stats{};
+    }
+
+    // estimated time to send bytes at the current baud
+    uint64_t bytes_us(uint64_t bytes) const
+    {
+        return bytes * 8 * 1'000'000 / _baud;
+    }
+
+    // estimated time for everything since reset_stats()
+    uint64_t us() const
+    {
+        return bytes_us(_stats.bytes);
+    }
+
+    Pixel565 pixel(int col, int row) const
+    {
+        return _ram[row * width() + col];
+    }
+
+    virtual void fill_rect(int col, int row, int wid, int hgt,
+                           Color c) override;
+
+    using Framebuffer::write;
+
+    virtual void write(int col, int row, const PixelImageHdr *img) override;
+
+private:
+
+    uint32_t _baud;
+    bool _paced;
+    uint64_t _busy_until; // time_us_64() the last paced window ends
+    Stats _stats;
+    std::vector<Pixel565> _ram;
+
+    void window(int wid, int hgt);
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+// Host stand-in for the framebuffer library's Font: proportional glyphs with
+// 8-bit coverage, printable ASCII only.
+
+struct Glyph {
+    uint32_t off;  // offset of glyph's first coverage byte in Font::bits
+    uint8_t wid;   // coverage bitmap size
+    uint8_t hgt;   //
+    uint8_t x_adv; // distance to the next glyph's origin
+    int8_t x_off;  // bitmap position relative to the glyph origin, where the
+    int8_t y_off;  // origin is the top left of the line
+};
+
+struct Font {
+
+    const uint8_t *bits;
+    const Glyph *glyphs;
+    char first;
+    char last;
+    int y_adv; // line height
+
+    constexpr const Glyph *glyph(char c) const
+    {
+        if (c < first || c > last)
+            c = '?';
+        return &glyphs[c - first];
+    }
+
+    // 0 (background) ... 255 (foreground)
+    constexpr uint8_t alpha(const Glyph *g, int x, int y) const
+    {
+        return bits[g->off + y * g->wid + x];
+    }
+
+    constexpr int width(char c) const
+    {
+        return glyph(c)->x_adv;
+    }
+
+    constexpr int width(const char *s) const
+    {
+        int w = 0;
+        while (*s != '\0')
+            w += width(*s++);
+        return w;
+    }
+};
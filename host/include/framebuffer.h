@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "pixel_image.h"
+
+// Host stand-in for the framebuffer library's Framebuffer: the drawing API
+// the gui library calls. A panel driver (on the host, FbRecord) implements
+// fill_rect() and write(); everything else is built from those two, the way
+// a panel sees it: one address window per call.
+
+class Framebuffer
+{
+public:
+
+    enum class HAlign {
+        Left,
+        Center,
+        Right,
+    };
+
+    enum class Rotation {
+        portrait,
+        landscape,
+        portrait2,
+        landscape2,
+    };
+
+    Framebuffer(int width, int height) : _phys_wid(width), _phys_hgt(height)
+    {
+        set_rotation(Rotation::landscape);
+    }
+
+    virtual ~Framebuffer() = default;
+
+    int width() const
+    {
+        return _width;
+    }
+
+    int height() const
+    {
+        return _height;
+    }
+
+    void set_rotation(Rotation r)
+    {
+        bool land = r == Rotation::landscape || r == Rotation::landscape2;
+        int big = _phys_wid > _phys_hgt ? _phys_wid : _phys_hgt;
+        int small = _phys_wid > _phys_hgt ? _phys_hgt : _phys_wid;
+        _width = land ? big : small;
+        _height = land ? small : big;
+    }
+
+    // percent, 0 is off
+    virtual void brightness(int pct)
+    {
+        _brightness = pct;
+    }
+
+    int brightness() const
+    {
+        return _brightness;
+    }
+
+    virtual void fill_rect(int col, int row, int wid, int hgt, Color c) = 0;
+
+    // one pixel wide outline
+    void draw_rect(int col, int row, int wid, int hgt, Color c)
+    {
+        fill_rect(col, row, wid, 1, c);
+        fill_rect(col, row + hgt - 1, wid, 1, c);
+        fill_rect(col, row + 1, 1, hgt - 2, c);
+        fill_rect(col + wid - 1, row + 1, 1, hgt - 2, c);
+    }
+
+    void line(int c0, int r0, int c1, int r1, Color c)
+    {
+        if (c0 == c1 || r0 == r1) {
+            int col = c0 < c1 ? c0 : c1;
+            int row = r0 < r1 ? r0 : r1;
+            int wid = (c0 < c1 ? c1 - c0 : c0 - c1) + 1;
+            int hgt = (r0 < r1 ? r1 - r0 : r0 - r1) + 1;
+            fill_rect(col, row, wid, hgt, c);
+            return;
+        }
+        // one pixel at a time
+        int dc = c1 > c0 ? c1 - c0 : c0 - c1;
+        int dr = r1 > r0 ? r0 - r1 : r1 - r0;
+        int sc = c0 < c1 ? 1 : -1;
+        int sr = r0 < r1 ? 1 : -1;
+        int err = dc + dr;
+        while (true) {
+            fill_rect(c0, r0, 1, 1, c);
+            if (c0 == c1 && r0 == r1)
+                break;
+            int e2 = 2 * err;
+            if (e2 >= dr) {
+                err += dr;
+                c0 += sc;
+            }
+            if (e2 <= dc) {
+                err += dc;
+                r0 += sr;
+            }
+        }
+    }
+
+    virtual void write(int col, int row, const PixelImageHdr *img) = 0;
+
+    // Write a non-negative number using digit images dig[0..9]. The number
+    // starts at col (Left), is centered on col (Center), or ends at col
+    // (Right). The rendered size is returned in wid and hgt.
+    void write(int col, int row, int num, const PixelImageHdr *dig[],
+               HAlign align, int *wid = nullptr, int *hgt = nullptr)
+    {
+        assert(num >= 0);
+        int digits[12];
+        int cnt = 0;
+        do {
+            digits[cnt++] = num % 10;
+            num /= 10;
+        } while (num > 0);
+        int w = 0;
+        int h = 0;
+        for (int i = 0; i < cnt; i++) {
+            w += dig[digits[i]]->wid;
+            if (dig[digits[i]]->hgt > h)
+                h = dig[digits[i]]->hgt;
+        }
+        if (align == HAlign::Center)
+            col -= w / 2;
+        else if (align == HAlign::Right)
+            col -= w;
+        for (int i = cnt - 1; i >= 0; i--) {
+            write(col, row, dig[digits[i]]);
+            col += dig[digits[i]]->wid;
+        }
+        if (wid != nullptr)
+            *wid = w;
+        if (hgt != nullptr)
+            *hgt = h;
+    }
+
+private:
+
+    const int _phys_wid;
+    const int _phys_hgt;
+    int _width;
+    int _height;
+    int _brightness = 0;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <thread>
+// gui
+#include "gui_render_queue.h"
+
+// Host stand-in for core1: a thread that runs a GuiRenderQueue from
+// construction until destruction. The destructor lets the thread write
+// everything still queued before joining it.
+
+class GuiRenderThread
+{
+public:
+
+    GuiRenderThread(GuiRenderQueue &queue) :
+        _queue(queue),
+        _thread([&queue] { queue.run(); })
+    {
+    }
+
+    ~GuiRenderThread()
+    {
+        _queue.stop();
+        _thread.join();
+    }
+
+    GuiRenderThread(const GuiRenderThread &) = delete;
+    GuiRenderThread &operator=(const GuiRenderThread &) = delete;
+
+private:
+
+    GuiRenderQueue &_queue;
+    std::thread _thread;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+
+// Host stand-in for the GPIO interrupt part of the pico SDK's hardware/gpio.
+// There are no pins; HostGpio::edge() calls the callback the way the GPIO
+// interrupt would.
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL = 0x4u,
+    GPIO_IRQ_EDGE_RISE = 0x8u,
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask,
+                                        bool enabled,
+                                        gpio_irq_callback_t callback);
+
+namespace HostGpio {
+
+// an edge on gpio: calls the callback if the edge is enabled
+void edge(uint gpio, uint32_t event_mask);
+
+} // namespace HostGpio
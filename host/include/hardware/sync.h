@@ -0,0 +1,7 @@
+#pragma once
+
+// Host stand-in for the part of the pico SDK's hardware/sync.h the gui
+// library uses.
+
+// Send an event: wakes best_effort_wfe_or_timeout() (see pico/stdlib.h).
+void __sev();
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// Clock behind the host time_us_64() and sleep_us().
+//
+// By default it is the host's steady clock. In simulated mode, time stands
+// still until advance() (or a sleep) moves it, so tests can model slow
+// hardware deterministically.
+
+namespace HostClock {
+
+void simulate(bool s);
+
+bool simulated();
+
+// move simulated time forward (no effect on the real clock)
+void advance(uint64_t us);
+
+// Call func(arg) when simulated time reaches us (e.g. to play an interrupt
+// into a sleeping loop). Callbacks run from advance(), sleeps and waits,
+// in time order, with the clock set to their time. Simulated mode only.
+void at(uint64_t us, void (*func)(intptr_t), intptr_t arg = 0);
+
+} // namespace HostClock
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "font.h"
+
+// Procedural fonts for host builds, which don't have the real font data.
+// Every printable character gets a distinct, proportional glyph with a mix
+// of full and partial coverage, which is all the gui code cares about.
+
+template <int HGT>
+struct HostFontData {
+
+    static constexpr int cnt = '~' - ' ' + 1;
+    static constexpr int max_wid = HGT / 2;
+    static constexpr int bmp_hgt = HGT * 3 / 4;
+
+    uint8_t bits[cnt * max_wid * bmp_hgt];
+    Glyph glyphs[cnt];
+
+    constexpr HostFontData() : bits{}, glyphs{}
+    {
+        uint32_t off = 0;
+        for (int i = 0; i < cnt; i++) {
+            const int c = ' ' + i;
+            const int wid = max_wid - (c % 3);
+            glyphs[i] = Glyph{off, uint8_t(wid), uint8_t(bmp_hgt),
+                              uint8_t(wid + 2), 1, int8_t(HGT / 8)};
+            for (int y = 0; y < bmp_hgt; y++) {
+                for (int x = 0; x < wid; x++) {
+                    bool edge = x == 0 || y == 0 || x == wid - 1 ||
+                                y == bmp_hgt - 1;
+                    bool on = edge ? ((c >> ((x + y) % 7)) & 1) != 0
+                                   : ((x * y + c) % 5) == 0;
+                    if (c == ' ')
+                        on = false;
+                    uint8_t a = on ? 255 : 0;
+                    if (on && ((x + y + c) % 4) == 0)
+                        a = 128;
+                    bits[off++] = a;
+                }
+            }
+        }
+    }
+};
+
+template <int HGT>
+inline constexpr HostFontData<HGT> host_font_data{};
+
+template <int HGT>
+inline constexpr Font host_font = {host_font_data<HGT>.bits,
+                                   host_font_data<HGT>.glyphs, ' ', '~', HGT};
+
+inline constexpr Font host_font_16 = host_font<16>;
+inline constexpr Font host_font_24 = host_font<24>;
+inline constexpr Font host_font_48 = host_font<48>;
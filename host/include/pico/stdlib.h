@@ -0,0 +1,52 @@
+#pragma once
+
+// Host stand-in for the subset of the pico SDK the gui library uses.
+//
+// Time comes from the host's steady clock, or from a simulated clock that
+// only moves when something advances it (see host_clock.h). Sleeping on the
+// simulated clock advances it instead of blocking.
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+typedef unsigned int uint;
+
+uint64_t time_us_64();
+
+inline uint32_t time_us_32()
+{
+    return uint32_t(time_us_64());
+}
+
+void sleep_us(uint64_t us);
+
+typedef uint64_t absolute_time_t;
+
+inline absolute_time_t from_us_since_boot(uint64_t us)
+{
+    return us;
+}
+
+inline absolute_time_t make_timeout_time_us(uint64_t us)
+{
+    return time_us_64() + us;
+}
+
+// Wait for an event (__sev(), see hardware/sync.h) or until timeout. Returns
+// true if it timed out. On the simulated clock, time jumps to the next
+// HostClock::at() callback or the timeout, whichever is first.
+bool best_effort_wfe_or_timeout(absolute_time_t timeout);
+
+inline void sleep_ms(uint32_t ms)
+{
+    sleep_us(uint64_t(ms) * 1000);
+}
+
+// Spin loops run on host threads standing in for the other core; give the
+// CPU away so they work even with fewer CPUs than threads.
+inline void tight_loop_contents()
+{
+    std::this_thread::yield();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "color.h"
+
+// Host stand-in for the framebuffer library's RGB565 pixel. The value is
+// stored in wire (big-endian) byte order, so an image is a straight copy to
+// the panel.
+
+struct Pixel565 {
+
+    uint16_t value;
+
+    constexpr Pixel565() : value(0)
+    {
+    }
+
+    constexpr Pixel565(Color c) :
+        value(swap(uint16_t(((c.r >> 3) << 11) | ((c.g >> 2) << 5) | (c.b >> 3))))
+    {
+    }
+
+    // native (not wire order) 565 value
+    constexpr uint16_t rgb() const
+    {
+        return swap(value);
+    }
+
+    constexpr bool operator==(const Pixel565 &p) const
+    {
+        return value == p.value;
+    }
+
+    constexpr bool operator!=(const Pixel565 &p) const
+    {
+        return value != p.value;
+    }
+
+    static constexpr uint16_t swap(uint16_t v)
+    {
+        return uint16_t((v << 8) | (v >> 8));
+    }
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "color.h"
+
+// Host stand-in for the framebuffer library's RGB666 pixel, for a panel in
+// 18-bit mode: three bytes in wire order, each color in the top six bits.
+
+struct Pixel666 {
+
+    uint8_t value[3];
+
+    constexpr Pixel666() : value{0, 0, 0}
+    {
+    }
+
+    constexpr Pixel666(Color c) :
+        value{uint8_t(c.r & 0xfc), uint8_t(c.g & 0xfc), uint8_t(c.b & 0xfc)}
+    {
+    }
+
+    constexpr bool operator==(const Pixel666 &p) const
+    {
+        return value[0] == p.value[0] && value[1] == p.value[1] &&
+               value[2] == p.value[2];
+    }
+
+    constexpr bool operator!=(const Pixel666 &p) const
+    {
+        return !(*this == p);
+    }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "font.h"
+
+// Host stand-in for the framebuffer library's images.
+//
+// A PixelImage is a header followed directly by the pixels, row-major. Code
+// that only needs the size uses the header; Framebuffer::write() finds the
+// pixels right after it.
+
+struct PixelImageHdr {
+    int wid;
+    int hgt;
+};
+
+template <typename PIXEL, int WID, int HGT>
+struct PixelImage {
+    PixelImageHdr hdr;
+    PIXEL pixels[WID * HGT];
+};
+
+template <typename PIXEL>
+inline const PIXEL *image_pixels(const PixelImageHdr *hdr)
+{
+    return reinterpret_cast<const PIXEL *>(hdr + 1);
+}
+
+// Render text centered in a WID x HGT image, with an optional border.
+template <typename PIXEL, int WID, int HGT>
+constexpr PixelImage<PIXEL, WID, HGT> label_img(const char *txt,
+                                                const Font &font, Color fg,
+                                                int brd_thk, Color brd_clr,
+                                                Color bg)
+{
+    PixelImage<PIXEL, WID, HGT> img{};
+    img.hdr = PixelImageHdr{WID, HGT};
+
+    for (int i = 0; i < WID * HGT; i++)
+        img.pixels[i] = PIXEL(bg);
+
+    if (brd_clr != Color::none()) {
+        for (int r = 0; r < HGT; r++) {
+            for (int c = 0; c < WID; c++) {
+                if (r < brd_thk || r >= HGT - brd_thk || c < brd_thk ||
+                    c >= WID - brd_thk)
+                    img.pixels[r * WID + c] = PIXEL(brd_clr);
+            }
+        }
+    }
+
+    int col = (WID - font.width(txt)) / 2;
+    const int row = (HGT - font.y_adv) / 2;
+    for (const char *s = txt; *s != '\0'; s++) {
+        const Glyph *g = font.glyph(*s);
+        for (int y = 0; y < g->hgt; y++) {
+            for (int x = 0; x < g->wid; x++) {
+                int c = col + g->x_off + x;
+                int r = row + g->y_off + y;
+                int a = font.alpha(g, x, y);
+                if (a == 0 || c < 0 || c >= WID || r < 0 || r >= HGT)
+                    continue;
+                img.pixels[r * WID + c] = PIXEL(fg.blend(bg, a));
+            }
+        }
+        col += g->x_adv;
+    }
+
+    return img;
+}
+
+template <typename PIXEL, int WID, int HGT>
+constexpr PixelImage<PIXEL, WID, HGT> label_img(const char *txt,
+                                                const Font &font, Color fg,
+                                                Color bg)
+{
+    return label_img<PIXEL, WID, HGT>(txt, font, fg, 0, Color::none(), bg);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// Host stand-in for the touchscreen library's Touchscreen.
+
+class Touchscreen
+{
+public:
+
+    enum class Rotation {
+        portrait,
+        landscape,
+        portrait2,
+        landscape2,
+    };
+
+    struct Event {
+
+        enum class Type {
+            none,
+            down,
+            move,
+            up,
+        };
+
+        Type type;
+        int col;
+        int row;
+
+        Event(Type t = Type::none, int c = 0, int r = 0) :
+            type(t),
+            col(c),
+            row(r)
+        {
+        }
+
+        const char *type_name() const
+        {
+            switch (type) {
+                case Type::down:
+                    return "down";
+                case Type::move:
+                    return "move";
+                case Type::up:
+                    return "up";
+                default:
+                    return "none";
+            }
+        }
+    };
+
+    virtual ~Touchscreen() = default;
+
+    // Next event, or an event of type none if nothing happened
+    virtual Event get_event() = 0;
+
+    virtual void set_rotation(Rotation)
+    {
+    }
+};
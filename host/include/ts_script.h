@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+// pico
+#include "pico/stdlib.h"
+// touchscreen
+#include "touchscreen.h"
+
+// Host touchscreen that plays back a script of events, one per
+// get_event(), then reports none. Each get_event() can be made to take
+// time (e.g. the controller's SPI read), so a loop that polls it moves the
+// simulated clock on.
+
+class TsScript : public Touchscreen
+{
+public:
+
+    using Type = Event::Type;
+
+    void add(Type type, int col, int row)
+    {
+        _events.push_back(Event(type, col, row));
+    }
+
+    // down at (c0, r0), steps moves to (c1, r1), up at (c1, r1)
+    void drag(int c0, int r0, int c1, int r1, int steps)
+    {
+        add(Type::down, c0, r0);
+        for (int i = 1; i <= steps; i++)
+            add(Type::move, c0 + (c1 - c0) * i / steps,
+                r0 + (r1 - r0) * i / steps);
+        add(Type::up, c1, r1);
+    }
+
+    void tap(int col, int row)
+    {
+        add(Type::down, col, row);
+        add(Type::up, col, row);
+    }
+
+    void clear()
+    {
+        _events.clear();
+        _next = 0;
+    }
+
+    // events not yet returned
+    size_t pending() const
+    {
+        return _events.size() - _next;
+    }
+
+    // time each get_event() takes (0, the default, for none)
+    void read_us(uint32_t us)
+    {
+        _read_us = us;
+    }
+
+    virtual Event get_event() override
+    {
+        if (_read_us != 0)
+            sleep_us(_read_us);
+        if (_next >= _events.size())
+            return Event();
+        return _events[_next++];
+    }
+
+private:
+
+    std::vector<Event> _events;
+    size_t _next = 0;
+    uint32_t _read_us = 0;
+};
@@ -1,8 +1,25 @@
 #pragma once
 
+#include "gui_animator.h"
+#include "gui_background.h"
+#include "gui_blit.h"
 #include "gui_button.h"
+#include "gui_compositor.h"
+#include "gui_display_list.h"
+#include "gui_event_queue.h"
+#include "gui_glyph_cache.h"
+#include "gui_image.h"
 #include "gui_label.h"
+#include "gui_latency.h"
+#include "gui_loop.h"
 #include "gui_macros.h"
 #include "gui_number.h"
 #include "gui_page.h"
+#include "gui_page_base.h"
+#include "gui_pixel.h"
+#include "gui_render_queue.h"
 #include "gui_slider.h"
+#include "gui_static_page.h"
+#include "gui_stats.h"
+#include "gui_text.h"
+#include "gui_touch_input.h"
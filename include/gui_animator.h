@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+// gui
+#include "gui_page_base.h"
+
+// Animates widget properties. A tween moves an int property (a slider's
+// value, a widget's column or row, an index into a table of colors, ...)
+// from one value to another over a time, calling a setter with the values
+// in between. Tweens can start later than now, so several can be laid out
+// on a timeline.
+//
+// Each frame sets every tween to its value for the time the frame starts.
+// A late frame therefore jumps to where the animation should be by then:
+// when drawing falls behind, frames are skipped rather than queued, and
+// the animation still ends on time.
+//
+// Frames are paced to what the display keeps up with. The interval between
+// frames is the longer of the minimum interval and the (smoothed) time
+// recent frames took to set their values and draw. On a slow SPI bus that
+// gives fewer, bigger steps instead of frames that start ever later.
+//
+// Progress and easing are 16.16 fixed point; there is no floating point.
+
+class GuiAnimator
+{
+public:
+
+    static const int max_tweens = 8;
+
+    // 1.0 in 16.16 fixed point
+    static const int32_t one = 1 << 16;
+
+    enum class Ease {
+        linear,
+        in,     // starts slow
+        out,    // ends slow
+        in_out, // starts and ends slow
+    };
+
+    using Setter = void (*)(intptr_t arg, int val);
+
+    // If page is set, it is flushed after each frame's values are set (for
+    // widgets on a page in deferred mode).
+    GuiAnimator(uint32_t frame_us_min = 20'000, GuiPageBase *page = nullptr);
+
+    // Tween from 'from' to 'to' over dur_us, starting delay_us from now.
+    // set(arg, from) is called on the first frame and set(arg, to) on the
+    // last. Returns the tween's id, or -1 if there are already max_tweens.
+    int start(int from, int to, uint32_t dur_us, Setter set, intptr_t arg,
+              Ease ease = Ease::linear, uint32_t delay_us = 0);
+
+    // stop a tween, leaving the property where it is
+    void cancel(int tween);
+
+    // any tween not done yet
+    bool running() const;
+
+    bool running(int tween) const
+    {
+        return _tweens[tween].set != nullptr;
+    }
+
+    // time the next frame is due (the latest of the paced interval and the
+    // first tween's start)
+    uint64_t due_us() const;
+
+    // If a frame is due, draw it; returns true if it did.
+    bool step();
+
+    // step() until no tweens are left, sleeping between frames
+    void run();
+
+    // For GuiLoop::every(), with arg the GuiAnimator. Use the minimum frame
+    // interval as the period; step() skips the calls that are not due.
+    static void task(intptr_t arg);
+
+    uint32_t frame_us_min() const
+    {
+        return _frame_us_min;
+    }
+
+    // the interval frames are paced at now
+    uint32_t frame_us() const
+    {
+        return _frame_us;
+    }
+
+    struct Stats {
+        uint32_t frames;
+        uint32_t skipped; // frames at the minimum interval not drawn
+        uint32_t worst_frame_us;
+    };
+
+    const Stats &stats() const
+    {
+        return _stats;
+    }
+
+    // pacing is kept
+    void reset_stats()
+    {
+        _stats = Stats{};
+    }
+
+    // p in [0, one] eased, also in [0, one]
+    static int32_t ease(Ease e, int32_t p);
+
+    // setters for common properties
+    static void slider_value(intptr_t slider, int val); // GuiSlider *
+    static void widget_col(intptr_t widget, int col);   // GuiWidget *
+    static void widget_row(intptr_t widget, int row);   // GuiWidget *
+
+private:
+
+    struct Tween {
+        Setter set; // nullptr if the slot is free
+        intptr_t arg;
+        int from;
+        int to;
+        uint64_t start_us;
+        uint32_t dur_us;
+        Ease ease;
+    };
+    std::array<Tween, max_tweens> _tweens;
+
+    GuiPageBase *_page;
+
+    const uint32_t _frame_us_min;
+    uint32_t _frame_us;
+    uint32_t _render_us; // smoothed time to draw a frame
+    bool _rendered;      // _render_us holds a measured frame
+
+    uint64_t _next_us; // paced time of the next frame
+    uint64_t _last_us; // time the last frame started, 0 if idle
+    uint32_t _skip_us; // part of a minimum interval not yet counted
+
+    Stats _stats;
+};
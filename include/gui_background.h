@@ -0,0 +1,219 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_pixel.h"
+
+// What is behind a page's widgets, where that is not one color: an image, a
+// gradient or a tiled pattern. Widgets with a background (see
+// GuiWidget::background()) erase by restoring just the area they uncover
+// from it, instead of filling with their bg color.
+//
+// The pixels come from a Source, a span of a screen row at a time. Restored
+// areas are built from tiles (tile x tile pixels, on a grid from the screen's
+// top left), and tiles are kept in RAM, least recently used out first, so
+// an area erased again and again (a number changing width, a widget moving
+// back and forth) is only computed once. A source that repeats (a pattern,
+// or a gradient that is the same in every column) says so, and all tiles
+// that look the same share one slot.
+//
+// The memory is provided by the caller: one strip for writing (tile rows
+// high, strip_cols wide) and the rest for tiles. An area is sent a strip at
+// a time, so the cost of a restore is proportional to its area.
+//
+// Widgets drawing through a canvas hand it the area to restore (see
+// GuiCanvas::restore()). With a GuiRenderQueue the render core restores it,
+// so while the queue is in use only the render core may use the background.
+
+class GuiBackground
+{
+public:
+
+    static const int tile = 16;
+    static const int strip_cols = 8 * tile;
+
+    class Source
+    {
+    public:
+
+        virtual ~Source() = default;
+
+        // Fill dst with the wid pixels of screen row 'row' from 'col'.
+        virtual void span(int col, int row, int wid, GuiPixel *dst) const = 0;
+
+        // The source is the same every period_wid columns (every
+        // period_hgt rows); 0 if it does not repeat.
+        virtual int period_wid() const
+        {
+            return 0;
+        }
+
+        virtual int period_hgt() const
+        {
+            return 0;
+        }
+    };
+
+    // an image with its top left at (col, row), and a color elsewhere
+    class ImageSource : public Source
+    {
+    public:
+
+        ImageSource(const PixelImageHdr *img, int col = 0, int row = 0,
+                    Color outside = Color::black()) :
+            _img(img),
+            _col(col),
+            _row(row),
+            _outside(outside)
+        {
+        }
+
+        virtual void span(int col, int row, int wid,
+                          GuiPixel *dst) const override;
+
+    private:
+
+        const PixelImageHdr *_img;
+        int _col;
+        int _row;
+        GuiPixel _outside;
+    };
+
+    // from c0 to c1, top to bottom (vertical) or left to right, over 'len'
+    // pixels; c1 past that
+    class GradientSource : public Source
+    {
+    public:
+
+        GradientSource(Color c0, Color c1, int len, bool vertical = true) :
+            _c0(c0),
+            _c1(c1),
+            _len(len > 1 ? len : 1),
+            _vertical(vertical)
+        {
+        }
+
+        virtual void span(int col, int row, int wid,
+                          GuiPixel *dst) const override;
+
+        virtual int period_wid() const override
+        {
+            return _vertical ? 1 : 0;
+        }
+
+        virtual int period_hgt() const override
+        {
+            return _vertical ? 0 : 1;
+        }
+
+    private:
+
+        Color _c0;
+        Color _c1;
+        int _len;
+        bool _vertical;
+
+        GuiPixel at(int i) const;
+    };
+
+    // an image repeated across and down from the top left of the screen
+    class TiledSource : public Source
+    {
+    public:
+
+        TiledSource(const PixelImageHdr *img) : _img(img)
+        {
+        }
+
+        virtual void span(int col, int row, int wid,
+                          GuiPixel *dst) const override;
+
+        virtual int period_wid() const override
+        {
+            return _img->wid;
+        }
+
+        virtual int period_hgt() const override
+        {
+            return _img->hgt;
+        }
+
+    private:
+
+        const PixelImageHdr *_img;
+    };
+
+    // 'mem' must hold the strip (strip_cols x tile pixels, plus a
+    // PixelImageHdr) and at least one tile (tile x tile pixels); up to
+    // max_slots tiles are used.
+    GuiBackground(const Source &src, uint8_t *mem, int mem_bytes);
+
+    static const int max_slots = 32;
+
+    // Write the background's pixels for the area to fb.
+    void restore(Framebuffer &fb, int col, int row, int wid, int hgt);
+
+    const Source &source() const
+    {
+        return _src;
+    }
+
+    // Forget the cached tiles (e.g. the source changed).
+    void clear();
+
+    int slots() const
+    {
+        return _slot_cnt;
+    }
+
+    uint32_t hits() const
+    {
+        return _hits;
+    }
+
+    uint32_t misses() const
+    {
+        return _misses;
+    }
+
+    // hits / lookups (0 if none yet)
+    float hit_rate() const
+    {
+        const uint32_t lookups = _hits + _misses;
+        return lookups == 0 ? 0.0f : float(_hits) / float(lookups);
+    }
+
+    void reset_stats()
+    {
+        _hits = 0;
+        _misses = 0;
+    }
+
+private:
+
+    const Source &_src;
+
+    PixelImageHdr *_strip; // pixels follow
+
+    struct Slot {
+        int col; // tile's top left, reduced by the source's period
+        int row;
+        bool used;
+        uint32_t last; // for least recently used
+        GuiPixel *pixels;
+    };
+    std::array<Slot, max_slots> _slots;
+    int _slot_cnt;
+    uint32_t _clock;
+
+    uint32_t _hits;
+    uint32_t _misses;
+
+    // pixels of the tile with its top left at (col, row)
+    const GuiPixel *get(int col, int row);
+};
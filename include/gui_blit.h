@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_pixel.h"
+
+class GuiRenderQueue;
+
+// Write a rectangle of pixels to the panel a strip of rows at a time, from
+// two strip buffers in RAM.
+//
+// The pixels come from a Source, which fills in rows on request: a copy of
+// an image, or pixels computed on the fly. The caller's work buffer is split
+// into two strips.
+//
+// With a GuiRenderQueue, strips are queued and the render core writes them.
+// While it sends one strip, the GUI core fills the other, and it only waits
+// if that strip is still being sent (each strip has a fence). Without a
+// queue, each strip is written before step() returns.
+//
+// Either way, step() sends one strip, so the main loop can handle events
+// between strips of a large transfer. The caller can also use finish(), which
+// steps until everything is queued or written.
+
+class GuiBlit
+{
+public:
+
+    class Source
+    {
+    public:
+
+        virtual ~Source() = default;
+
+        virtual int width() const = 0;
+
+        virtual int height() const = 0;
+
+        // Fill 'cnt' rows starting at 'row', width() pixels each.
+        virtual void rows(int row, int cnt, GuiPixel *dst) const = 0;
+    };
+
+    // rows copied from an image
+    class ImageSource : public Source
+    {
+    public:
+
+        ImageSource(const PixelImageHdr *img) : _img(img)
+        {
+        }
+
+        virtual int width() const override
+        {
+            return _img->wid;
+        }
+
+        virtual int height() const override
+        {
+            return _img->hgt;
+        }
+
+        virtual void rows(int row, int cnt, GuiPixel *dst) const override;
+
+    private:
+
+        const PixelImageHdr *_img;
+    };
+
+    // 'work' must be big enough for two strips of at least one row of the
+    // widest source used, plus a PixelImageHdr each.
+    GuiBlit(uint8_t *work, int work_bytes, GuiRenderQueue *queue = nullptr);
+
+    // Start sending 'src' to (col, row). Anything still unsent from the
+    // previous start() is sent first. 'src' must stay valid until sent().
+    void start(Framebuffer &fb, int col, int row, const Source &src);
+
+    // Fill and send (or queue) the next strip. Returns true if there are
+    // strips left.
+    bool step();
+
+    // step() until all strips are sent or queued
+    void finish();
+
+    // All strips are sent or queued (with a queue, they may still be
+    // being written).
+    bool sent() const
+    {
+        return _src == nullptr;
+    }
+
+    // All strips have been written to the panel.
+    bool done() const;
+
+    // finish() and wait until done()
+    void wait();
+
+    // rows per strip for the current source
+    int strip_rows() const
+    {
+        return _strip_rows;
+    }
+
+    // times step() had to wait for a strip buffer to be sent
+    uint32_t strip_waits() const
+    {
+        return _strip_waits;
+    }
+
+private:
+
+    struct Strip {
+        PixelImageHdr *hdr; // pixels follow
+        bool queued;        // fence is valid
+        uint32_t fence;
+    };
+
+    Strip _strips[2];
+    int _strip_bytes; // each, including the header
+    int _strip_rows;
+    int _strip_next;
+
+    GuiRenderQueue *_queue;
+
+    Framebuffer *_fb;
+    int _col;
+    int _row;
+    const Source *_src; // nullptr once all is sent
+    int _next_row;      // next source row to send
+
+    uint32_t _strip_waits;
+
+    bool strip_done(const Strip &strip) const;
+};
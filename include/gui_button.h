@@ -9,7 +9,9 @@
 // touchscreen
 #include "touchscreen.h"
 // gui
+#include "gui_image.h"
 #include "gui_label.h"
+#include "gui_latency.h"
 
 
 // A button is a label that can be clicked.
@@ -59,9 +61,9 @@ public:
     };
 
     GuiButton(Framebuffer &fb, int col, int row, Color bg,       //
-              const PixelImageHdr *img_enabled,                  //
-              const PixelImageHdr *img_disabled,                 //
-              const PixelImageHdr *img_pressed,                  //
+              GuiImage img_enabled,                              //
+              GuiImage img_disabled,                             //
+              GuiImage img_pressed,                              //
               void (*on_click)(intptr_t), intptr_t on_click_arg, //
               void (*on_down)(intptr_t), intptr_t on_down_arg,   //
               void (*on_up)(intptr_t), intptr_t on_up_arg,       //
@@ -81,15 +83,23 @@ public:
 
     virtual void draw() override
     {
-        if (_visible)
-            _fb.write(_col, _row,
-                      _enabled ? (_pressed ? _img_pressed : _img_enabled)
-                               : _img_disabled);
+        if (!_visible)
+            return;
+        GuiLatency::draw_start(this);
+        write(_col, _row,
+              _enabled ? (_pressed ? _img_pressed : _img_enabled)
+                       : _img_disabled);
+        GuiLatency::draw_end(this);
     }
 
     // System calls this to see if button wants to claim event
     virtual bool event(Touchscreen::Event &event) override;
 
+    virtual bool interactive() const override
+    {
+        return true;
+    }
+
     // Return true if button is pressed (useful for toggle or sticky buttons)
     bool pressed() const
     {
@@ -100,13 +110,13 @@ public:
     {
         if (_pressed != p) {
             _pressed = p;
-            draw();
+            invalidate();
         }
     }
 
 protected:
 
-    const PixelImageHdr *_img_pressed;
+    GuiImage _img_pressed;
 
 private:
 
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_background.h"
+#include "gui_image.h"
+
+// Something widgets can draw on instead of going straight to their
+// Framebuffer (see GuiWidget::canvas). Each call says which Framebuffer the
+// widget would have drawn to, so a canvas can pass it along.
+
+class GuiCanvas
+{
+public:
+
+    virtual ~GuiCanvas() = default;
+
+    virtual void fill_rect(Framebuffer &fb, int col, int row, int wid, int hgt,
+                           Color c) = 0;
+
+    virtual void draw_rect(Framebuffer &fb, int col, int row, int wid, int hgt,
+                           Color c) = 0;
+
+    virtual void line(Framebuffer &fb, int c0, int r0, int c1, int r1,
+                      Color c) = 0;
+
+    virtual void write(Framebuffer &fb, int col, int row,
+                       const GuiImage &img) = 0;
+
+    // Put back bg's pixels for the area (see GuiWidget::erase_rect()).
+    virtual void restore(Framebuffer &fb, GuiBackground &bg, int col, int row,
+                         int wid, int hgt) = 0;
+
+    // A canvas that writes later, on another core (GuiRenderQueue), reads
+    // images and their palettes when it writes them. fence() covers what was
+    // drawn so far, and wait() returns once that has been written, after
+    // which the caller may change it. Nothing to wait for by default.
+    virtual uint32_t fence() const
+    {
+        return 0;
+    }
+
+    virtual void wait(uint32_t fence) const
+    {
+        (void)fence;
+    }
+};
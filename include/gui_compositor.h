@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_background.h"
+#include "gui_canvas.h"
+#include "gui_image.h"
+#include "gui_pixel.h"
+#include "gui_rect.h"
+
+// Draws an area a band of rows at a time into RAM, then sends each band to
+// the panel as one image (see GuiPage::compositor()).
+//
+// Drawing straight to the panel opens an address window per primitive, and
+// where widgets overlap, the same pixels cross the bus once per widget.
+// Here everything that touches a band is drawn into the band buffer in page
+// order, clipped to the band, and the band is written in one window: each
+// pixel is sent once. The band starts out as the background (a color, or a
+// GuiBackground's source), for any pixels no widget draws.
+//
+// The caller's work buffer is split in two: the band, and room to decode
+// image rows (runs, masks, text) before they are clipped into it. A band is
+// as many rows of the area as fit, up to max_rows.
+//
+// GuiPage composes each group of overlapping widgets in bands trimmed to
+// the rows and columns its widgets cover. Pixels in a band that no widget
+// draws get the background of the group's bottom widget, so nothing else
+// may show through there. A group whose bands would send more bytes than
+// drawing it straight (gaps, or a lone widget drawn in one window) is drawn
+// straight, and partial updates (invalidate(), flush()) always are.
+
+class GuiCompositor : public GuiCanvas
+{
+public:
+
+    // 'work' must hold at least one row of the widest area composed, twice,
+    // plus a PixelImageHdr. max_rows of 0 is as many as fit.
+    GuiCompositor(uint8_t *work, int work_bytes, int max_rows = 0);
+
+    // rows per band for an area wid pixels wide (0 if a row does not fit)
+    int band_rows(int wid) const;
+
+    // Start a band: (col, row), wid x hgt, filled with bg, or from src if
+    // not null.
+    void begin(Framebuffer &fb, int col, int row, int wid, int hgt, Color bg,
+               const GuiBackground::Source *src = nullptr);
+
+    // Send the band.
+    void end();
+
+    virtual void fill_rect(Framebuffer &fb, int col, int row, int wid, int hgt,
+                           Color c) override;
+
+    virtual void draw_rect(Framebuffer &fb, int col, int row, int wid, int hgt,
+                           Color c) override;
+
+    virtual void line(Framebuffer &fb, int c0, int r0, int c1, int r1,
+                      Color c) override;
+
+    virtual void write(Framebuffer &fb, int col, int row,
+                       const GuiImage &img) override;
+
+    virtual void restore(Framebuffer &fb, GuiBackground &bg, int col, int row,
+                         int wid, int hgt) override;
+
+    GuiRect band() const
+    {
+        return _band;
+    }
+
+    // primitives drawn (clipped or not)
+    uint32_t ops() const
+    {
+        return _ops;
+    }
+
+    // Bytes the primitives drawn would have sent straight to the panel, one
+    // address window each (clipped or not). The page compares this with
+    // band_bytes() to decide whether composing is worth it.
+    uint32_t direct_bytes() const
+    {
+        return _direct_bytes;
+    }
+
+    // bytes to send a band (or any one window) of wid x hgt
+    static uint32_t window_bytes(int wid, int hgt)
+    {
+        if (wid <= 0 || hgt <= 0)
+            return 0;
+        return window_cmd_bytes + uint32_t(wid) * hgt * sizeof(GuiPixel);
+    }
+
+    // bands sent
+    uint32_t bands() const
+    {
+        return _bands;
+    }
+
+    void reset_stats()
+    {
+        _ops = 0;
+        _bands = 0;
+    }
+
+private:
+
+    PixelImageHdr *_hdr; // band pixels follow
+    GuiPixel *_decode;
+    int _pixels; // in the band, and in _decode
+    int _max_rows;
+
+    Framebuffer *_fb;
+    GuiRect _band;
+
+    uint32_t _ops;
+    uint32_t _bands;
+    uint32_t _direct_bytes;
+
+    // setting the column and row addresses and starting the write
+    static const int window_cmd_bytes = 11;
+
+    void fill(int col, int row, int wid, int hgt, Color c);
+
+    GuiPixel *at(int col, int row) const
+    {
+        return reinterpret_cast<GuiPixel *>(_hdr + 1) +
+               (row - _band.row) * _band.wid + (col - _band.col);
+    }
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_background.h"
+#include "gui_canvas.h"
+#include "gui_image.h"
+
+// What a page's widgets draw, kept as a list of drawing ops so the page can
+// be shown again by replaying them (see GuiPage::display_list()).
+//
+// Each op is tagged with the index of the widget that drew it, and the ops
+// are kept in widget order. begin(w) records widget w again: what it draws
+// next is written over its old ops, in place, and end() (or the next
+// begin()) drops any old ops it did not draw over. Images and backgrounds
+// are kept by pointer and must stay put.
+//
+// The ops live in storage the caller provides. If an op does not fit, the
+// list is marked overflowed and is not used until clear().
+//
+// The page records the widgets that changed since they were last recorded,
+// then replays the list. Replaying saves only what the widgets' draw() works
+// out (digits, slider geometry): on the host, about 10% of drawing the page.
+// A widget that changed is recorded and then replayed, so a page with one
+// changing between every draw is slower with a list than without. It pays
+// for a page shown again and again with few changes.
+
+class GuiDisplayList : public GuiCanvas
+{
+public:
+
+    struct Op {
+        enum class Code : uint8_t {
+            fill_rect, // a, b, c, d = col, row, wid, hgt
+            draw_rect, // a, b, c, d = col, row, wid, hgt
+            line,      // a, b, c, d = c0, r0, c1, r1
+            write,     // a, b = col, row
+            restore,   // a, b, c, d = col, row, wid, hgt from bg
+        };
+        Code code;
+        uint8_t widget;
+        int16_t a;
+        int16_t b;
+        int16_t c;
+        int16_t d;
+        Color color;
+        GuiImage img;
+        GuiBackground *bg;
+    };
+
+    GuiDisplayList(Op *ops, int max_ops);
+
+    int size() const
+    {
+        return _cnt;
+    }
+
+    int max_size() const
+    {
+        return _max;
+    }
+
+    // memory used by the ops recorded
+    int bytes() const
+    {
+        return _cnt * int(sizeof(Op));
+    }
+
+    bool overflow() const
+    {
+        return _overflow;
+    }
+
+    const Op &operator[](int i) const
+    {
+        return _ops[i];
+    }
+
+    void clear();
+
+    // Record widget again; ops drawn until end() or the next begin()
+    // replace its old ones.
+    void begin(int widget);
+
+    void end();
+
+    // times begin() has been called since clear()
+    uint32_t records() const
+    {
+        return _records;
+    }
+
+    virtual void fill_rect(Framebuffer &fb, int col, int row, int wid, int hgt,
+                           Color c) override;
+
+    virtual void draw_rect(Framebuffer &fb, int col, int row, int wid, int hgt,
+                           Color c) override;
+
+    virtual void line(Framebuffer &fb, int c0, int r0, int c1, int r1,
+                      Color c) override;
+
+    virtual void write(Framebuffer &fb, int col, int row,
+                       const GuiImage &img) override;
+
+    virtual void restore(Framebuffer &fb, GuiBackground &bg, int col, int row,
+                         int wid, int hgt) override;
+
+private:
+
+    Op *_ops;
+    int _max;
+    int _cnt;
+    bool _overflow;
+
+    int _widget;  // widget being recorded
+    int _insert;  // where its next op goes
+    int _replace; // end of its old ops not yet drawn over
+
+    uint32_t _records;
+
+    void insert(const Op &op);
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+// touchscreen
+#include "touchscreen.h"
+
+class GuiPageBase;
+class GuiTouchInput;
+
+// Fixed-size queue of touch events between the touchscreen and dispatch.
+//
+// The main loop reads everything the touchscreen has (poll()) and then
+// dispatches from the queue. If dispatching (and the redraws it causes) falls
+// behind, moves pile up; a move queued right behind another move replaces
+// it, so the handler only ever sees the newest position. Downs and ups are
+// never merged or dropped.
+//
+// If the queue is full, room is made by dropping the oldest queued move
+// (the ones after it supersede it). If there is no move to drop, a new move
+// is dropped, and a new down or up is refused: push() returns false and the
+// caller should dispatch something and try again.
+
+class GuiEventQueue
+{
+public:
+
+    using Event = Touchscreen::Event;
+
+    static const int capacity = 16;
+
+    GuiEventQueue();
+
+    bool empty() const
+    {
+        return _cnt == 0;
+    }
+
+    int size() const
+    {
+        return _cnt;
+    }
+
+    // Add an event (type none is ignored). Returns false only if a down or
+    // up could not be queued.
+    bool push(const Event &event);
+
+    // Remove the oldest event; false if empty.
+    bool pop(Event &event);
+
+    // Read events from the touchscreen until it has none, until a down or up
+    // does not fit, or until capacity have been read. Returns the number
+    // read.
+    int poll(Touchscreen &ts);
+
+    // As above; the latency probe times each down from when the controller
+    // signalled it (GuiTouchInput::event_us()) instead of from now.
+    int poll(GuiTouchInput &ts);
+
+    // Pop one event and send it to the widget with focus, or else the page.
+    // Returns false if the queue was empty.
+    bool dispatch(GuiPageBase &page);
+
+    // moves replaced by a newer move
+    uint32_t coalesced() const
+    {
+        return _coalesced;
+    }
+
+    // moves dropped because the queue was full
+    uint32_t dropped() const
+    {
+        return _dropped;
+    }
+
+    // downs and ups refused because the queue was full
+    uint32_t refused() const
+    {
+        return _refused;
+    }
+
+    void reset_counters()
+    {
+        _coalesced = 0;
+        _dropped = 0;
+        _refused = 0;
+    }
+
+private:
+
+    std::array<Event, capacity> _events; // ring
+    int _head;                           // oldest
+    int _cnt;
+
+    // event read from the touchscreen that did not fit (see poll())
+    Event _held;
+
+    uint32_t _coalesced;
+    uint32_t _dropped;
+    uint32_t _refused;
+
+    Event &at(int i)
+    {
+        return _events[(_head + i) % capacity];
+    }
+
+    bool drop_oldest_move();
+
+    // input is ts if its events are time stamped, else null
+    int poll(Touchscreen &ts, const GuiTouchInput *input);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "font.h"
+// gui
+#include "gui_pixel.h"
+
+// Glyphs blended onto a background color, kept in RAM, least recently used
+// out first.
+//
+// Drawing text at runtime means blending each coverage byte of each glyph
+// with the foreground and background colors. Status text and values with
+// units reuse a few glyphs in a few colors, so those are blended once and
+// kept here. Each cached glyph also records, per row, the span of pixels
+// with any coverage; only that span is copied into the line being drawn.
+//
+// The memory is provided by the caller and split into equal slots. A glyph
+// too big for a slot is not cached (get() returns nullptr) and is blended
+// as it is drawn.
+
+class GuiGlyphCache
+{
+public:
+
+    struct Entry {
+        const Glyph *glyph;     // nullptr if the slot is free
+        Color fg;
+        Color bg;
+        uint32_t used;          // for least recently used
+        const uint8_t *spans;   // per row: first, end (end == 0 if empty)
+        const GuiPixel *pixels; // glyph->wid * glyph->hgt
+    };
+
+    GuiGlyphCache(uint8_t *mem, int mem_bytes, int slots);
+
+    // 'glyph' blended with fg over bg, cached if it was not (replacing the
+    // least recently used), or nullptr if it does not fit in a slot.
+    // Counted in the hit rate.
+    const Entry *get(const Font &font, const Glyph *glyph, Color fg,
+                     Color bg);
+
+    // Same, but nullptr if it is not cached; not counted.
+    const Entry *find(const Glyph *glyph, Color fg, Color bg);
+
+    void clear();
+
+    int slots() const
+    {
+        return _slot_cnt;
+    }
+
+    int slot_bytes() const
+    {
+        return _slot_bytes;
+    }
+
+    uint32_t hits() const
+    {
+        return _hits;
+    }
+
+    uint32_t misses() const
+    {
+        return _misses;
+    }
+
+    // hits / lookups (0 if none yet)
+    float hit_rate() const
+    {
+        const uint32_t lookups = _hits + _misses;
+        return lookups == 0 ? 0.0f : float(_hits) / float(lookups);
+    }
+
+    void reset_stats()
+    {
+        _hits = 0;
+        _misses = 0;
+    }
+
+private:
+
+    Entry *_entries;
+    uint8_t *_slot_mem; // slot i at _slot_mem + i * _slot_bytes
+    int _slot_cnt;
+    int _slot_bytes;
+
+    uint32_t _clock;
+    uint32_t _hits;
+    uint32_t _misses;
+
+    int lookup(const Glyph *glyph, Color fg, Color bg) const;
+
+    void fill(int slot, const Font &font, const Glyph *glyph, Color fg,
+              Color bg);
+};
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "font.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_pixel.h"
+
+class GuiGlyphCache;
+
+// Run-length encoded image.
+//
+// Button and label images are mostly long runs of one color, so storing
+// (length, pixel) runs takes a fraction of the flash of raw pixels. Runs go
+// row-major and may continue from one row into the next. Like PixelImage,
+// the runs follow the header directly.
+//
+// Encoding is done at compile time, from a raw constexpr image, in two
+// passes: rle_runs() to size the image, then rle_img() (see RLE_LABEL_IMG
+// in gui_macros.h).
+
+struct RleRun {
+    uint16_t len;
+    GuiPixel pixel;
+};
+
+struct RleImageHdr {
+    PixelImageHdr hdr;
+    int runs;
+};
+
+template <int RUNS>
+struct RleImage {
+    RleImageHdr hdr;
+    RleRun runs[RUNS];
+};
+
+inline const RleRun *image_runs(const RleImageHdr *hdr)
+{
+    return reinterpret_cast<const RleRun *>(hdr + 1);
+}
+
+template <typename PIXEL, int WID, int HGT>
+constexpr int rle_runs(const PixelImage<PIXEL, WID, HGT> &img)
+{
+    int runs = 0;
+    int len = 0;
+    for (int i = 0; i < WID * HGT; i++) {
+        if (len > 0 && img.pixels[i] == img.pixels[i - 1] && len < UINT16_MAX) {
+            len++;
+        } else {
+            runs++;
+            len = 1;
+        }
+    }
+    return runs;
+}
+
+template <int RUNS, typename PIXEL, int WID, int HGT>
+constexpr RleImage<RUNS> rle_img(const PixelImage<PIXEL, WID, HGT> &img)
+{
+    RleImage<RUNS> rle{};
+    rle.hdr = RleImageHdr{PixelImageHdr{WID, HGT}, RUNS};
+    int run = -1;
+    for (int i = 0; i < WID * HGT; i++) {
+        if (run >= 0 && img.pixels[i] == img.pixels[i - 1] &&
+            rle.runs[run].len < UINT16_MAX) {
+            rle.runs[run].len++;
+        } else {
+            run++;
+            rle.runs[run] = RleRun{1, GuiPixel(img.pixels[i])};
+        }
+    }
+    return rle;
+}
+
+// Coverage mask of a label's text, with the colors left out.
+//
+// A button's enabled, disabled and pressed images usually differ only in
+// colors and border, so they can share one mask, each with its own
+// GuiPalette: the colors are applied as the mask is drawn. Coverage is
+// quantized to BPP bits (1, 2, 4 or 8) and packed row-major, most
+// significant bits first. The text is laid out as label_img() does, so
+// with the same colors and BPP 8 the result is identical.
+
+struct MaskImageHdr {
+    PixelImageHdr hdr;
+    int bpp;
+};
+
+template <int BPP, int WID, int HGT>
+struct MaskImage {
+    MaskImageHdr hdr;
+    uint8_t bits[(WID * HGT * BPP + 7) / 8];
+};
+
+inline const uint8_t *image_bits(const MaskImageHdr *hdr)
+{
+    return reinterpret_cast<const uint8_t *>(hdr + 1);
+}
+
+template <int BPP, int WID, int HGT>
+constexpr MaskImage<BPP, WID, HGT> mask_img(const char *txt, const Font &font)
+{
+    static_assert(BPP == 1 || BPP == 2 || BPP == 4 || BPP == 8, "bpp");
+    MaskImage<BPP, WID, HGT> img{};
+    img.hdr = MaskImageHdr{PixelImageHdr{WID, HGT}, BPP};
+
+    const int max = (1 << BPP) - 1;
+    int col = (WID - font.width(txt)) / 2;
+    const int row = (HGT - font.y_adv) / 2;
+    for (const char *s = txt; *s != '\0'; s++) {
+        const Glyph *g = font.glyph(*s);
+        for (int y = 0; y < g->hgt; y++) {
+            for (int x = 0; x < g->wid; x++) {
+                int c = col + g->x_off + x;
+                int r = row + g->y_off + y;
+                int a = font.alpha(g, x, y);
+                if (a == 0 || c < 0 || c >= WID || r < 0 || r >= HGT)
+                    continue;
+                // round, but keep any coverage at all visible
+                int q = (a * max + 127) / 255;
+                if (q == 0)
+                    q = 1;
+                const int bit = (r * WID + c) * BPP;
+                img.bits[bit / 8] |= uint8_t(q << (8 - BPP - bit % 8));
+            }
+        }
+        col += g->x_adv;
+    }
+
+    return img;
+}
+
+// The colors a mask is drawn in (same meaning as label_img()'s arguments).
+struct GuiPalette {
+    Color fg;
+    int brd_thk;
+    Color brd_clr; // Color::none() for no border
+    Color bg;
+};
+
+// A string in a font, drawn at runtime (see GuiText). The image is the
+// string's width and the font's line height, and is drawn in a palette's fg
+// and bg. The text (up to LEN characters) follows the header.
+
+struct TextImageHdr {
+    PixelImageHdr hdr;
+    const Font *font;
+};
+
+template <int LEN>
+struct TextImage {
+    TextImageHdr hdr;
+    char txt[LEN + 1];
+};
+
+inline const char *image_text(const TextImageHdr *hdr)
+{
+    return reinterpret_cast<const char *>(hdr + 1);
+}
+
+// Any image a widget can draw: raw pixels (a PixelImageHdr), runs (an
+// RleImageHdr), a mask and the palette to draw it in, or text and its
+// palette. All convert to a GuiImage, so widgets that take a GuiImage
+// accept any of them.
+
+class GuiImage
+{
+public:
+
+    enum class Format : uint8_t {
+        raw,
+        rle,
+        mask,
+        text,
+    };
+
+    GuiImage() : _format(Format::raw), _hdr(nullptr), _pal(nullptr)
+    {
+    }
+
+    GuiImage(const PixelImageHdr *hdr) :
+        _format(Format::raw),
+        _hdr(hdr),
+        _pal(nullptr)
+    {
+    }
+
+    GuiImage(const RleImageHdr *hdr) :
+        _format(Format::rle),
+        _hdr(hdr == nullptr ? nullptr : &hdr->hdr),
+        _pal(nullptr)
+    {
+    }
+
+    GuiImage(const MaskImageHdr *hdr, const GuiPalette *pal) :
+        _format(Format::mask),
+        _hdr(hdr == nullptr ? nullptr : &hdr->hdr),
+        _pal(pal)
+    {
+    }
+
+    GuiImage(const TextImageHdr *hdr, const GuiPalette *pal) :
+        _format(Format::text),
+        _hdr(hdr == nullptr ? nullptr : &hdr->hdr),
+        _pal(pal)
+    {
+    }
+
+    Format format() const
+    {
+        return _format;
+    }
+
+    const PixelImageHdr *hdr() const
+    {
+        return _hdr;
+    }
+
+    const GuiPalette *palette() const
+    {
+        return _pal;
+    }
+
+    int wid() const
+    {
+        return _hdr->wid;
+    }
+
+    int hgt() const
+    {
+        return _hdr->hgt;
+    }
+
+    // Write to the framebuffer. Runs, masks and text are decoded a strip of
+    // rows at a time into a RAM buffer, which is written as a raw image.
+    // The buffer is a static one, so only one core may call this (the one
+    // drawing straight to the panel), and not while a write is in progress.
+    void write(Framebuffer &fb, int col, int row) const;
+
+    // As above, decoding into 'work' (two strips of at least a row each, see
+    // GuiBlit). A core writing images for another passes its own (e.g.
+    // GuiRenderQueue's render core).
+    void write(Framebuffer &fb, int col, int row, uint8_t *work,
+               int work_bytes) const;
+
+    // Two strips; 2 KB each holds 6 rows of a 160-pixel wide button, or 2
+    // rows of a full-width (480 pixel) image.
+    static const int decode_bytes = 4096;
+
+    // Decode rows [row, row + cnt) into dst, wid() pixels each (e.g. to
+    // draw part of the image into a RAM buffer). Runs are skipped up to row.
+    void rows(int row, int cnt, GuiPixel *dst) const;
+
+    // If set, text is drawn from glyphs cached here; otherwise each glyph is
+    // blended as it is drawn.
+    static GuiGlyphCache *glyph_cache;
+
+private:
+
+    Format _format;
+    const PixelImageHdr *_hdr; // for rle, mask and text, their header
+    const GuiPalette *_pal;    // for mask and text
+};
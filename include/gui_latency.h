@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+// touchscreen
+#include "touchscreen.h"
+
+class GuiWidget;
+
+// Touch-to-photon latency probe: how long from a touch being read until the
+// button it pressed has been redrawn.
+//
+// Each down is time stamped when it is read from the touchscreen
+// (GuiEventQueue::poll(); from a GuiTouchInput, when the controller
+// signalled it), when it is taken from the queue and dispatched to the
+// pages (GuiLoop or GuiEventQueue::dispatch()), when the button that takes
+// it starts drawing itself, and when that draw returns (the framebuffer
+// write is complete; with a GuiRenderQueue canvas it is only queued then).
+// Other buttons drawing in between (e.g. the rest of a radio group) do not
+// count. Downs waiting in the queue keep their read times, in order. A
+// dispatched down that does not get its button drawn before the next down
+// is dispatched is abandoned.
+//
+// Each stage and the total go into a histogram with 1/8 octave resolution,
+// from which p50, p99 and max are reported.
+//
+// The hooks cost one test of 'probe' when no probe is set.
+
+class GuiLatency
+{
+public:
+
+    // Microsecond times: exact below 8 us, then eight bins per power of two
+    // (12.5% wide), up to about 30 s.
+    class Hist
+    {
+    public:
+
+        static const int sub_bins = 8;
+        static const int bins = sub_bins * 24;
+
+        Hist()
+        {
+            reset();
+        }
+
+        void add(uint32_t us);
+
+        void reset();
+
+        uint32_t count() const
+        {
+            return _cnt;
+        }
+
+        uint32_t max() const
+        {
+            return _max;
+        }
+
+        // Time pct% of the samples are at or below (the top of the bin it
+        // falls in, and never above max()).
+        uint32_t percentile(int pct) const;
+
+        static int bin(uint32_t us);
+
+        // lowest time in bin b
+        static uint32_t bin_us(int b);
+
+    private:
+
+        uint32_t _bins[bins];
+        uint32_t _cnt;
+        uint32_t _max;
+    };
+
+    GuiLatency();
+
+    // While set, the hooks record into it.
+    static GuiLatency *probe;
+
+    // Hooks: the event queue calls captured() for each event read and
+    // dispatched() for each event it (or GuiLoop) takes out to dispatch. A
+    // button calls pressed() when it takes a down, and draw_start() and
+    // draw_end() around drawing. An app reading the touchscreen and calling
+    // GuiPage::event() itself calls captured() and dispatched().
+
+    static void captured(const Touchscreen::Event &event)
+    {
+        if (probe != nullptr)
+            probe->on_captured(event, time_us_64());
+    }
+
+    // read now, but signalled (e.g. by the controller's INT) at 'us'
+    static void captured(const Touchscreen::Event &event, uint64_t us)
+    {
+        if (probe != nullptr)
+            probe->on_captured(event, us);
+    }
+
+    static void dispatched(const Touchscreen::Event &event)
+    {
+        if (probe != nullptr)
+            probe->on_dispatched(event);
+    }
+
+    static void pressed(const GuiWidget *button)
+    {
+        if (probe != nullptr)
+            probe->on_pressed(button);
+    }
+
+    static void draw_start(const GuiWidget *button)
+    {
+        if (probe != nullptr)
+            probe->on_draw_start(button);
+    }
+
+    static void draw_end(const GuiWidget *button)
+    {
+        if (probe != nullptr)
+            probe->on_draw_end(button);
+    }
+
+    // read until dispatch
+    const Hist &queued() const
+    {
+        return _queued;
+    }
+
+    // dispatch until the button starts drawing
+    const Hist &handled() const
+    {
+        return _handled;
+    }
+
+    // the button's draw
+    const Hist &drawn() const
+    {
+        return _drawn;
+    }
+
+    // read until drawn
+    const Hist &total() const
+    {
+        return _total;
+    }
+
+    // downs that drew no button (or were read while max_queued were
+    // waiting)
+    uint32_t abandoned() const
+    {
+        return _abandoned;
+    }
+
+    void reset();
+
+    // p50, p99 and max of each stage
+    void print() const;
+
+private:
+
+    enum class Stage {
+        idle,
+        dispatched,
+        drawing,
+    };
+
+    // read times of downs not yet dispatched, oldest first
+    static const int max_queued = 8;
+    uint64_t _queue_us[max_queued];
+    int _queue_head;
+    int _queue_cnt;
+
+    Stage _stage;
+    const GuiWidget *_button; // took the dispatched down
+    uint64_t _captured_us;
+    uint64_t _dispatched_us;
+    uint64_t _draw_us;
+
+    Hist _queued;
+    Hist _handled;
+    Hist _drawn;
+    Hist _total;
+    uint32_t _abandoned;
+
+    void on_captured(const Touchscreen::Event &event, uint64_t us);
+    void on_dispatched(const Touchscreen::Event &event);
+    void on_pressed(const GuiWidget *button);
+    void on_draw_start(const GuiWidget *button);
+    void on_draw_end(const GuiWidget *button);
+};
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+// framebuffer
+#include "framebuffer.h"
+// touchscreen
+#include "touchscreen.h"
+// gui
+#include "gui_event_queue.h"
+#include "gui_page_base.h"
+#include "gui_touch_input.h"
+
+// The app's main loop: reads the touchscreen, dispatches events, flushes the
+// page, and runs periodic tasks (e.g. the page's update()), each with its
+// own period.
+//
+// Each step() reads the touchscreen, then dispatches everything it read and
+// flushes. Only if no events were waiting does it run a task: the due task
+// with the earliest deadline, and just that one, so a touch waits for at
+// most one task. A task is due every period after it was added; one that
+// is not run before it is due again misses that deadline (the missed runs
+// are not made up).
+//
+// The time from the first event of a step to the end of its flush is a
+// frame. Frames longer than the frame budget (e.g. what the SPI bus can
+// send in a frame, see frame_us()) are counted as overruns.
+//
+// With idle() set, run() sleeps (WFE) when there is nothing to do, until an
+// interrupt (e.g. GuiTouchInput's), wake(), the next task deadline, or the
+// backlight dimming time. Stats split the time into dispatch, draw (flush),
+// tasks and idle.
+
+class GuiLoop
+{
+public:
+
+    static const int max_tasks = 8;
+
+    // A step longer than the wake bound stops sleeps (polled input only)
+    // until it is this old.
+    static const uint32_t step_window_us = 1'000'000;
+
+    GuiLoop(Touchscreen &ts);
+
+    // Downs are timed (see GuiLatency) from when the controller signalled
+    // them.
+    GuiLoop(GuiTouchInput &ts);
+
+    // Events go to the widget with focus, else to the bar (e.g. a nav bar,
+    // if any), else to the page. The bar and page are flushed every step.
+    void page(GuiPageBase *page)
+    {
+        _page = page;
+    }
+
+    void bar(GuiPageBase *bar)
+    {
+        _bar = bar;
+    }
+
+    // Call func(arg) every period_us, starting period_us from now. Returns
+    // the task's id, or -1 if there are already max_tasks.
+    int every(uint32_t period_us, void (*func)(intptr_t), intptr_t arg = 0);
+
+    // Call the page's update() every period_us (0 to stop).
+    void page_updates(uint32_t period_us);
+
+    void cancel(int task);
+
+    // Frames longer than this are overruns (0 for no budget).
+    void frame_budget(uint32_t us)
+    {
+        _frame_budget_us = us;
+    }
+
+    // microseconds to send 'pixels' RGB565 pixels at spi_baud
+    static uint32_t frame_us(uint32_t pixels, uint32_t spi_baud)
+    {
+        return uint32_t(uint64_t(pixels) * 16 * 1'000'000 / spi_baud);
+    }
+
+    // One pass of the loop; returns true if it did anything.
+    bool step();
+
+    // step() until stop() (e.g. from a task or an event handler)
+    void run();
+
+    // Sleep in run() when idle (0, the default, spins). A touch that cannot
+    // wake the loop (no interrupt, e.g. a polled touchscreen) is still
+    // handled within wake_bound_us: sleeps are cut short by the longest
+    // recent step (see step_window_us), so there is time left to draw. With
+    // a GuiTouchInput the touch wakes the loop, so sleeps are not cut.
+    void idle(uint32_t wake_bound_us)
+    {
+        _wake_bound_us = wake_bound_us;
+    }
+
+    // Wake a sleeping run(), e.g. from an interrupt handler.
+    static void wake();
+
+    // Set fb's brightness to dim_pct after after_us with no touch, and back
+    // to on_pct on the next touch (fb null to stop dimming).
+    void dim(Framebuffer *fb, uint32_t after_us, int dim_pct,
+             int on_pct = 100);
+
+    bool dimmed() const
+    {
+        return _dimmed;
+    }
+
+    void stop()
+    {
+        _stop = true;
+    }
+
+    const GuiEventQueue &events() const
+    {
+        return _events;
+    }
+
+    struct Stats {
+        uint32_t frames;
+        uint32_t overruns; // frames over budget
+        uint32_t worst_frame_us;
+        uint32_t task_runs;
+        uint32_t missed; // task deadlines missed, all tasks
+        // where the time went
+        uint64_t dispatch_us; // event handlers (and what they draw)
+        uint64_t draw_us;     // flushing pages
+        uint64_t task_us;     // tasks
+        uint64_t idle_us;     // sleeping
+        uint32_t sleeps;
+    };
+
+    void reset_stats()
+    {
+        _stats = Stats{};
+    }
+
+    const Stats &stats() const
+    {
+        return _stats;
+    }
+
+    // deadlines task has missed
+    uint32_t missed(int task) const
+    {
+        return _tasks[task].missed;
+    }
+
+    uint32_t runs(int task) const
+    {
+        return _tasks[task].runs;
+    }
+
+private:
+
+    Touchscreen &_ts;
+    GuiTouchInput *_input; // _ts, if it is one
+    GuiEventQueue _events;
+    GuiPageBase *_page;
+    GuiPageBase *_bar;
+
+    struct Task {
+        void (*func)(intptr_t); // nullptr if the slot is free
+        intptr_t arg;
+        uint32_t period_us;
+        uint64_t deadline_us; // due at; must run before deadline + period
+        uint32_t runs;
+        uint32_t missed;
+    };
+    std::array<Task, max_tasks> _tasks;
+    int _page_task;
+
+    uint32_t _frame_budget_us;
+    bool _stop;
+
+    uint32_t _wake_bound_us;
+    // longest step() that did something, in this window and the one before
+    uint32_t _step_us[2];
+    uint64_t _window_us; // start of this window
+
+    Framebuffer *_dim_fb;
+    uint32_t _dim_after_us;
+    int _dim_pct;
+    int _on_pct;
+    bool _dimmed;
+    uint64_t _touch_us; // last event
+
+    Stats _stats;
+
+    void dispatch(Touchscreen::Event &event);
+    void flush();
+    bool run_task();
+    void stepped(uint64_t start, uint64_t end);
+    uint32_t recent_step_us(uint64_t now);
+    void sleep();
+    static void page_update(intptr_t arg);
+};
@@ -1,7 +1,9 @@
 
 #include "font.h"
-#include "pixel_565.h"
 #include "pixel_image.h"
+// gui
+#include "gui_image.h"
+#include "gui_pixel.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // GuiNumber Helpers
@@ -13,9 +15,9 @@
 
 // Declare one digit image named (e.g.) 'roboto_48_0_img'
 #define DIG_IMG_MAKE(DIG, FNT, FG, BG)                                \
-    static constexpr PixelImage<Pixel565, FNT.width(#DIG), FNT.y_adv> \
+    static constexpr PixelImage<GuiPixel, FNT.width(#DIG), FNT.y_adv> \
         FNT##_##DIG##_img =                                             \
-            label_img<Pixel565, FNT.width(#DIG), FNT.y_adv>(#DIG, FNT, FG, BG)
+            label_img<GuiPixel, FNT.width(#DIG), FNT.y_adv>(#DIG, FNT, FG, BG)
 
 // Declare ten digit images and array of pointers to them
 // Images are constexpr (flash), array is const (RAM)
@@ -38,6 +40,64 @@
             &FNT##_9_img.hdr,                                     \
     }
 
+// Same, but ten digit masks (BPP bits of coverage per pixel) and an array
+// of pointers to them, for a GuiNumber given palettes for its colors
+// Example usage:
+// MASK_DIGIT_ARRAY(roboto_48, 4);
+// static const GuiPalette num_ena = {Color::black(), 0, Color::none(),
+//                                    Color::white()};
+
+#define MASK_DIG_MAKE(DIG, FNT, BPP)                                          \
+    static constexpr MaskImage<BPP, FNT.width(#DIG), FNT.y_adv>               \
+        FNT##_##DIG##_mask =                                                  \
+            mask_img<BPP, FNT.width(#DIG), FNT.y_adv>(#DIG, FNT)
+
+#define MASK_DIGIT_ARRAY(FNT, BPP)                                   \
+    MASK_DIG_MAKE(0, FNT, BPP);                                      \
+    MASK_DIG_MAKE(1, FNT, BPP);                                      \
+    MASK_DIG_MAKE(2, FNT, BPP);                                      \
+    MASK_DIG_MAKE(3, FNT, BPP);                                      \
+    MASK_DIG_MAKE(4, FNT, BPP);                                      \
+    MASK_DIG_MAKE(5, FNT, BPP);                                      \
+    MASK_DIG_MAKE(6, FNT, BPP);                                      \
+    MASK_DIG_MAKE(7, FNT, BPP);                                      \
+    MASK_DIG_MAKE(8, FNT, BPP);                                      \
+    MASK_DIG_MAKE(9, FNT, BPP);                                      \
+    static const MaskImageHdr *FNT##_digit_mask[10] =                \
+        {                                                            \
+            &FNT##_0_mask.hdr, &FNT##_1_mask.hdr, &FNT##_2_mask.hdr, \
+            &FNT##_3_mask.hdr, &FNT##_4_mask.hdr, &FNT##_5_mask.hdr, \
+            &FNT##_6_mask.hdr, &FNT##_7_mask.hdr, &FNT##_8_mask.hdr, \
+            &FNT##_9_mask.hdr,                                       \
+    }
+
+//////////////////////////////////////////////////////////////////////////////
+// Image Helpers
+//////////////////////////////////////////////////////////////////////////////
+
+// Declare a run-length encoded label image, encoded at compile time from
+// label_img<GuiPixel, WID, HGT>(...). Only the runs end up in flash.
+// Example usage:
+// RLE_LABEL_IMG(ok_img, 100, 40, "OK", roboto_24, Color::black(), 2,
+//               Color::black(), Color::white());
+// ...then pass &ok_img.hdr to a GuiLabel or GuiButton.
+
+#define RLE_LABEL_IMG(NAME, WID, HGT, ...)                                 \
+    static constexpr int NAME##_runs =                                     \
+        rle_runs(label_img<GuiPixel, WID, HGT>(__VA_ARGS__));              \
+    static constexpr RleImage<NAME##_runs> NAME =                          \
+        rle_img<NAME##_runs>(label_img<GuiPixel, WID, HGT>(__VA_ARGS__))
+
+// Declare a label's coverage mask, BPP bits per pixel. Pass
+// GuiImage(&NAME.hdr, &palette) to a GuiLabel or GuiButton; each state can
+// use the same mask with its own palette.
+// Example usage:
+// MASK_LABEL_IMG(ok_mask, 4, 100, 40, "OK", roboto_24);
+
+#define MASK_LABEL_IMG(NAME, BPP, WID, HGT, TXT, FNT) \
+    static constexpr MaskImage<BPP, WID, HGT> NAME =  \
+        mask_img<BPP, WID, HGT>(TXT, FNT)
+
 //////////////////////////////////////////////////////////////////////////////
 // GuiButton Helpers
 //////////////////////////////////////////////////////////////////////////////
@@ -48,11 +108,11 @@
                  DN_BG, CK_CB, CK_ARG, DN_CB, DN_ARG, UP_CB, UP_ARG, MODE,   \
                  PRESSED)                                                    \
                                                                              \
-    static constexpr PixelImage<Pixel565, WID, HGT> NAME##_btn_up_img =      \
-        label_img<Pixel565, WID, HGT>(TXT, FNT, FG, BRD, FG, UP_BG);         \
+    static constexpr PixelImage<GuiPixel, WID, HGT> NAME##_btn_up_img =      \
+        label_img<GuiPixel, WID, HGT>(TXT, FNT, FG, BRD, FG, UP_BG);         \
                                                                              \
-    static constexpr PixelImage<Pixel565, WID, HGT> NAME##_btn_dn_img =      \
-        label_img<Pixel565, WID, HGT>(TXT, FNT, FG, BRD, FG, DN_BG);         \
+    static constexpr PixelImage<GuiPixel, WID, HGT> NAME##_btn_dn_img =      \
+        label_img<GuiPixel, WID, HGT>(TXT, FNT, FG, BRD, FG, DN_BG);         \
                                                                              \
     static GuiButton NAME##_btn(FB, COL, ROW, BG,                            \
                                 &NAME##_btn_up_img.hdr, /* enabled */        \
@@ -62,3 +122,26 @@
                                 DN_CB, DN_ARG,          /* on_down */        \
                                 UP_CB, UP_ARG,          /* on_up */          \
                                 MODE, PRESSED)
+
+// Same as BUTTON_1, but one 4-bit mask shared by all three states and a
+// palette per state, instead of two full images
+
+#define BUTTON_MASK_1(NAME, TXT, FB, COL, ROW, WID, HGT, BRD, FNT, FG, BG,    \
+                      UP_BG, DN_BG, CK_CB, CK_ARG, DN_CB, DN_ARG, UP_CB,      \
+                      UP_ARG, MODE, PRESSED)                                  \
+                                                                              \
+    MASK_LABEL_IMG(NAME##_btn_mask, 4, WID, HGT, TXT, FNT);                   \
+                                                                              \
+    static const GuiPalette NAME##_btn_up_pal = {FG, BRD, FG, UP_BG};         \
+                                                                              \
+    static const GuiPalette NAME##_btn_dn_pal = {FG, BRD, FG, DN_BG};         \
+                                                                              \
+    static GuiButton NAME##_btn(                                              \
+        FB, COL, ROW, BG,                                                     \
+        GuiImage(&NAME##_btn_mask.hdr, &NAME##_btn_up_pal), /* enabled */     \
+        GuiImage(&NAME##_btn_mask.hdr, &NAME##_btn_up_pal), /* disabled */    \
+        GuiImage(&NAME##_btn_mask.hdr, &NAME##_btn_dn_pal), /* pressed */     \
+        CK_CB, CK_ARG,                                      /* on_click */    \
+        DN_CB, DN_ARG,                                      /* on_down */     \
+        UP_CB, UP_ARG,                                      /* on_up */       \
+        MODE, PRESSED)
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <climits>
 // pico
 #include "pico/stdlib.h"
 // framebuffer
 #include "color.h"
 #include "framebuffer.h"
 // gui
+#include "gui_image.h"
 #include "gui_widget.h"
 
 // GuiNumber is a widget that displays a number that can be changed.
@@ -16,6 +18,16 @@
 // Key differences between this and other widgets:
 //   the width is variable; and
 //   alignment is supported (left, center, right).
+//
+// The widget remembers which digit image it drew at which column. When the
+// value changes, a digit is rewritten only if a different image (or none)
+// was at its column, and only the strips at the ends that the new number no
+// longer covers are erased. Going from 4999 to 5000 rewrites four digits
+// and erases nothing, instead of erasing and redrawing all of them.
+//
+// The digits can instead be masks (see MASK_DIGIT_ARRAY), drawn in one
+// palette when enabled and another when disabled, so a disabled number
+// does not need a second set of ten images.
 
 
 class GuiNumber : public GuiWidget
@@ -28,42 +40,73 @@ public:
               bool visible = true, bool enabled = true) :
         GuiWidget(fb, col, row, 0, 0, bg, visible, enabled),
         _dig(dig),
+        _dig_mask(nullptr),
+        _pal{nullptr, nullptr},
         _num(num),
         _h_align(h_align),
-        _col_ref(col)
+        _col_ref(col),
+        _drawn_cnt(0),
+        _drawn_pal(nullptr)
     {
     }
 
-    virtual void draw() override
+    GuiNumber(Framebuffer &fb, int col, int row, Color bg,
+              const MaskImageHdr *dig[], const GuiPalette *pal_enabled,
+              const GuiPalette *pal_disabled, int num,
+              Framebuffer::HAlign h_align = Framebuffer::HAlign::Left,
+              bool visible = true, bool enabled = true) :
+        GuiWidget(fb, col, row, 0, 0, bg, visible, enabled),
+        _dig(nullptr),
+        _dig_mask(dig),
+        _pal{pal_enabled, pal_disabled},
+        _num(num),
+        _h_align(h_align),
+        _col_ref(col),
+        _drawn_cnt(0),
+        _drawn_pal(nullptr)
     {
-        if (_visible && _num != unset) {
-            // fb.write() sets _wid and _hgt to the rendered size.
-            _fb.write(_col_ref, _row, _num, _dig, _h_align, &_wid, &_hgt);
-
-            // Set _col based on alignment. Rendering started at:
-            //   _col_ref for left alignment,
-            //   _col_ref - (_wid / 2) for center alignment, or
-            //   _col_ref - _wid for right alignment.
-            if (_h_align == Framebuffer::HAlign::Left) {
-                _col = _col_ref;
-            } else if (_h_align == Framebuffer::HAlign::Center) {
-                _col = _col_ref - _wid / 2;
-            } else if (_h_align == Framebuffer::HAlign::Right) {
-                _col = _col_ref - _wid;
-            }
-        }
+    }
+
+    // draw every digit
+    virtual void draw() override;
+
+    // rewrite only the digits that changed since the last draw
+    virtual void refresh() override;
+
+    virtual void erase() override;
+
+    // the alignment reference moves with the number; no digit is left drawn
+    virtual void move(int col, int row) override;
+
+    virtual void erased() override
+    {
+        _drawn_cnt = 0;
+    }
+
+    // display only
+    virtual bool interactive() const override
+    {
+        return false;
+    }
+
+    // the digit images fill the widget's rectangle
+    virtual bool opaque() const override
+    {
+        return true;
     }
 
     void set_value(int n)
     {
         if (_num != n) {
-            erase();
             _num = n;
             if (_num == unset) {
+                damage();
                 _wid = 0;
                 _hgt = 0;
+                _drawn_cnt = 0;
+                bounds_changed();
             } else {
-                draw();
+                invalidate();
             }
         }
     }
@@ -77,12 +120,37 @@ public:
 
 protected:
 
-    const PixelImageHdr **_dig; // array of digit images
-    int _num;                   // number to display
+    const PixelImageHdr **_dig;     // array of digit images, or
+    const MaskImageHdr **_dig_mask; // array of digit masks
+    const GuiPalette *_pal[2];      // for masks: enabled, disabled
+    int _num;                       // number to display
 
     // _col_ref is the original col passed in constructor
     // _col and _wid are changed in draw() and erase() based on alignment
     Framebuffer::HAlign _h_align;
     int _col_ref;
 
+    // What is on the screen: digit images left to right, starting at _col.
+    // _drawn_cnt is zero if nothing is.
+    static const int max_digits = 10; // INT_MAX
+    const PixelImageHdr *_drawn[max_digits];
+    int _drawn_cnt;
+    const GuiPalette *_drawn_pal; // palette the digits were drawn in
+
+    // palette for the current state (nullptr for image digits)
+    const GuiPalette *palette() const
+    {
+        return _dig_mask == nullptr ? nullptr : _pal[_enabled ? 0 : 1];
+    }
+
+    // what to write for a digit layout() returned
+    GuiImage image(const PixelImageHdr *dig) const;
+
+    // split _num into digit images, left to right; return the count
+    int layout(const PixelImageHdr *img[max_digits], int &wid,
+               int &hgt) const;
+
+    // _col for a number wid wide
+    int align_col(int wid) const;
+
 }; // class GuiNumber
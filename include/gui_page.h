@@ -2,23 +2,37 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
 #include <initializer_list>
 // pico
 #include "pico/stdlib.h"
 // touchscreen
 #include "touchscreen.h"
 // gui
+#include "gui_background.h"
+#include "gui_compositor.h"
+#include "gui_display_list.h"
+#include "gui_page_base.h"
+#include "gui_rect.h"
 #include "gui_widget.h"
 
 
-class GuiPage
+// A page of up to 30 widgets, stacked in order: the first is at the bottom,
+// and raise() moves one to the top. In immediate mode (the default) widgets
+// draw as soon as they change; in deferred mode they are marked, and the
+// page draws them on the next flush(), once per pass of the main loop. A
+// page can draw by replaying a display list (see gui_display_list.h) or
+// through a compositor (see gui_compositor.h). GuiStaticPage is a smaller
+// page for widgets fixed at compile time (see gui_static_page.h).
+
+class GuiPage : public GuiPageBase
 {
 public:
 
     GuiPage(std::initializer_list<GuiWidget *> widgets,
             void (*on_update)(intptr_t) = nullptr, intptr_t on_update_arg = 0);
 
-    void visible(bool v);
+    virtual void visible(bool v) override;
 
     int busy() const
     {
@@ -30,20 +44,83 @@ public:
         _busy = b;
     }
 
-    void draw() const;
+    bool deferred() const
+    {
+        return _deferred;
+    }
 
-    void erase() const;
+    // Leaving deferred mode flushes anything pending.
+    void deferred(bool d);
 
-    // System calls this to see if anything on the page wants to claim event
-    bool event(Touchscreen::Event &event);
+    // Use 'list' to draw the page (nullptr to stop). Everything is recorded
+    // on the next draw.
+    void display_list(GuiDisplayList *list);
+
+    GuiDisplayList *display_list() const
+    {
+        return _list;
+    }
+
+    // Draw through 'c' (nullptr to draw straight to the panel).
+    void compositor(GuiCompositor *c)
+    {
+        _compositor = c;
+    }
 
-    // System calls this to see if the page wants to update itself
-    void update()
+    GuiCompositor *compositor() const
+    {
+        return _compositor;
+    }
+
+    virtual void draw() override;
+
+    virtual void erase() const override;
+
+    // Widgets erase by restoring bg (nullptr to fill with their bg color).
+    // The app draws the background itself (e.g. bg->restore() of the whole
+    // screen) before showing the page.
+    void background(GuiBackground *bg);
+
+    // Move a widget to the top of the stack (and draw it there).
+    void raise(GuiWidget *widget);
+
+    // Pixels a full draw() sends, and pixels of the screen the page covers;
+    // painted / visible is the overdraw ratio.
+    struct Overdraw {
+        uint32_t painted;
+        uint32_t visible;
+
+        float ratio() const
+        {
+            return visible == 0 ? 1.0f : float(painted) / float(visible);
+        }
+    };
+
+    Overdraw overdraw() const;
+
+    // Erase damaged areas, then redraw each widget that was invalidated or
+    // overlaps a damaged area, each once.
+    virtual void flush() override;
+
+    virtual bool event(Touchscreen::Event &event) override;
+
+    // Events are dispatched through a hit-test index by default. Turning it
+    // off offers every event to every widget in order (for comparison).
+    void indexed(bool i)
+    {
+        _indexed = i;
+    }
+
+    virtual void update() override
     {
         if (_visible && _on_update != nullptr)
             _on_update(_on_update_arg);
     }
 
+    virtual int widgets(GuiWidget *out[], int max) override;
+
+    virtual void swapped_out() override;
+
 private:
 
     static const size_t max_widgets = 30;
@@ -53,4 +130,70 @@ private:
     int _busy;
     void (*_on_update)(intptr_t);
     intptr_t _on_update_arg;
+
+    // Areas to erase on the next flush(). Each area is erased to the
+    // background of the widget that damaged it. Damage from the same widget
+    // is merged where the union is still a rectangle. If the list fills up,
+    // damage is erased right away and the next flush() redraws every widget.
+    struct Damage {
+        GuiWidget *widget;
+        GuiRect rect;
+    };
+    static const size_t max_damage = 8;
+    std::array<Damage, max_damage> _damage;
+    unsigned _damage_cnt;
+    bool _damage_all;
+
+    bool _deferred;
+
+    // Hit-test index. The bounding box of the interactive and opaque widgets
+    // is split into a grid of cells, each a power of two in size, and each
+    // cell has a mask of those widgets that overlap it (bit i for
+    // _widgets[i]). An event only goes to the widgets in its cell's mask,
+    // top-down. The index is rebuilt, lazily, when one of them changes
+    // bounds. Visibility is left to the widgets' event().
+    static const int grid_cols = 8;
+    static const int grid_rows = 8;
+    std::array<uint32_t, grid_cols * grid_rows> _grid;
+    GuiRect _grid_rect;
+    int _cell_col_shift;
+    int _cell_row_shift;
+    bool _grid_stale;
+    bool _indexed;
+
+    // Widgets entirely covered by opaque widgets above them (bit i for
+    // _widgets[i]). Updated, lazily, when a widget's bounds or visibility
+    // change.
+    uint32_t _covered;
+    bool _covered_stale;
+
+    // Display list, and a mask of the widgets that need recording again
+    // (bit i for _widgets[i]).
+    GuiDisplayList *_list;
+    uint32_t _list_stale;
+
+    GuiCompositor *_compositor;
+
+    friend class GuiWidget;
+    void changed(const GuiWidget *widget);
+    void record();
+    void draw_widgets(const GuiRect *band);
+    bool compose();
+    bool next_band(const int group[], size_t g, const GuiRect &area, int rows,
+                   int &r, GuiRect &band) const;
+    bool covered(const GuiWidget *widget);
+    uint32_t covered_mask();
+    void redraw(const GuiWidget *widget, const GuiRect &rect, bool below,
+                bool self);
+    size_t draw_over(size_t first, size_t end, GuiRect painted[], size_t cnt);
+    size_t draw_under(size_t i, const GuiRect &rect, bool self,
+                      GuiRect painted[]);
+    int exposed(size_t i, bool opaque_only) const;
+    void reindex(const GuiWidget *widget);
+    bool offer(Touchscreen::Event &event, uint32_t mask,
+               const GuiWidget *skip);
+    void build_index();
+    void damage(GuiWidget *widget, const GuiRect &rect);
+    void erase_damage();
+    void clear_damage();
 };
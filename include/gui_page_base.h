@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+// touchscreen
+#include "touchscreen.h"
+
+class GuiWidget;
+
+// What the app's main loop (and GuiEventQueue) needs of a page: show or hide
+// it, hand it events, and let it update and flush once per pass.
+//
+// GuiPage implements this directly. A GuiStaticPage does not (so that none
+// of its own calls are virtual); wrap it in a GuiPageAdapter where a
+// GuiPageBase is wanted.
+//
+// swap() switches from one page to another painting each pixel at most
+// once, where hiding one and showing the other would erase every old widget
+// and then draw every new one, often over the same area. Background is only
+// filled where the old page's widgets are and no opaque widget of the new
+// page will draw.
+
+class GuiPageBase
+{
+public:
+
+    virtual ~GuiPageBase() = default;
+
+    virtual void visible(bool v) = 0;
+
+    virtual void draw() = 0;
+
+    virtual void erase() const = 0;
+
+    // System calls this to see if anything on the page wants to claim event
+    virtual bool event(Touchscreen::Event &event) = 0;
+
+    // System calls this to see if the page wants to update itself
+    virtual void update() = 0;
+
+    // Draw anything that is pending (once per pass of the main loop).
+    virtual void flush() = 0;
+
+    // For swap(): put up to max of the page's widgets in out[], bottom to
+    // top, and return how many. A page that cannot list them returns -1 (the
+    // default), and is swapped by hiding one page and showing the other.
+    virtual int widgets(GuiWidget *out[], int max)
+    {
+        (void)out;
+        (void)max;
+        return -1;
+    }
+
+    // For swap(): hide the page without erasing its widgets (swap() has
+    // erased what needed it). Anything pending is erased as usual.
+    virtual void swapped_out()
+    {
+        visible(false);
+    }
+
+    // Pixels swap() filled with background, and how many fewer that is than
+    // hiding 'from' and showing 'to' would have filled (what the new page
+    // draws is the same either way).
+    struct Swap {
+        uint32_t erased;
+        uint32_t saved;
+    };
+
+    // Hide 'from' and show 'to'.
+    static Swap swap(GuiPageBase &from, GuiPageBase &to);
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+// The pixel type images are stored in and RAM buffers are built in.
+//
+// It should be the panel's wire format (bits per pixel and byte order), so
+// writing an image or a strip is a straight copy, with no conversion per
+// pixel and no padding. RGB565 unless the build defines GUI_PIXEL, and
+// GUI_PIXEL_H, the header declaring it (see GUI_PIXEL in CMakeLists.txt),
+// e.g. for a panel in 18-bit mode:
+//   -DGUI_PIXEL=Pixel666 -DGUI_PIXEL_H="pixel_666.h"
+//
+// The type needs a default constructor, a constexpr constructor from a
+// Color, and == and !=. Widgets only pass image headers around, so they
+// work with any pixel type; what is built from the images (gui_macros.h,
+// RleImage) and what draws into RAM (GuiBlit, GuiCompositor, GuiBackground,
+// GuiGlyphCache) uses GuiPixel.
+
+#ifdef GUI_PIXEL_H
+#include GUI_PIXEL_H
+#else
+// framebuffer
+#include "pixel_565.h"
+#endif
+
+#ifndef GUI_PIXEL
+#define GUI_PIXEL Pixel565
+#endif
+
+using GuiPixel = GUI_PIXEL;
@@ -0,0 +1,125 @@
+#pragma once
+
+// A rectangle in screen coordinates. It is empty if the width or height is
+// zero (or negative).
+
+struct GuiRect
+{
+    int col;
+    int row;
+    int wid;
+    int hgt;
+
+    bool empty() const
+    {
+        return wid <= 0 || hgt <= 0;
+    }
+
+    int area() const
+    {
+        return empty() ? 0 : wid * hgt;
+    }
+
+    bool operator==(const GuiRect &r) const
+    {
+        return col == r.col && row == r.row && wid == r.wid && hgt == r.hgt;
+    }
+
+    bool operator!=(const GuiRect &r) const
+    {
+        return !(*this == r);
+    }
+
+    bool contains(const GuiRect &r) const
+    {
+        return r.col >= col && (r.col + r.wid) <= (col + wid) && //
+               r.row >= row && (r.row + r.hgt) <= (row + hgt);
+    }
+
+    bool intersects(const GuiRect &r) const
+    {
+        return !empty() && !r.empty() &&                       //
+               r.col < (col + wid) && col < (r.col + r.wid) && //
+               r.row < (row + hgt) && row < (r.row + r.hgt);
+    }
+
+    GuiRect intersect(const GuiRect &r) const
+    {
+        int c0 = col > r.col ? col : r.col;
+        int r0 = row > r.row ? row : r.row;
+        int c1 = (col + wid) < (r.col + r.wid) ? (col + wid) : (r.col + r.wid);
+        int r1 = (row + hgt) < (r.row + r.hgt) ? (row + hgt) : (r.row + r.hgt);
+        if (c1 <= c0 || r1 <= r0)
+            return GuiRect{c0, r0, 0, 0};
+        return GuiRect{c0, r0, c1 - c0, r1 - r0};
+    }
+
+    // smallest rectangle containing this and r
+    GuiRect bound(const GuiRect &r) const
+    {
+        if (r.empty())
+            return *this;
+        if (empty())
+            return r;
+        int c0 = col < r.col ? col : r.col;
+        int r0 = row < r.row ? row : r.row;
+        int c1 = (col + wid) > (r.col + r.wid) ? (col + wid) : (r.col + r.wid);
+        int r1 = (row + hgt) > (r.row + r.hgt) ? (row + hgt) : (r.row + r.hgt);
+        return GuiRect{c0, r0, c1 - c0, r1 - r0};
+    }
+
+    // If the union of this and r is exactly a rectangle (one contains the
+    // other, or they line up and overlap or touch along one side), set this
+    // to the union and return true. Otherwise leave this alone and return
+    // false. Merging never grows a rectangle to cover pixels in neither.
+    bool merge(const GuiRect &r)
+    {
+        if (r.empty() || contains(r))
+            return true;
+        if (empty() || r.contains(*this)) {
+            *this = r;
+            return true;
+        }
+        if (col == r.col && wid == r.wid && //
+            r.row <= (row + hgt) && row <= (r.row + r.hgt)) {
+            int r1 = (row + hgt) > (r.row + r.hgt) ? (row + hgt) : (r.row + r.hgt);
+            row = row < r.row ? row : r.row;
+            hgt = r1 - row;
+            return true;
+        }
+        if (row == r.row && hgt == r.hgt && //
+            r.col <= (col + wid) && col <= (r.col + r.wid)) {
+            int c1 = (col + wid) > (r.col + r.wid) ? (col + wid) : (r.col + r.wid);
+            col = col < r.col ? col : r.col;
+            wid = c1 - col;
+            return true;
+        }
+        return false;
+    }
+
+    // Put the parts of this not covered by r in out[], as up to four
+    // non-overlapping rectangles (above, below, left, right of r). Returns
+    // how many.
+    int subtract(const GuiRect &r, GuiRect out[4]) const
+    {
+        if (!intersects(r)) {
+            if (empty())
+                return 0;
+            out[0] = *this;
+            return 1;
+        }
+        const GuiRect i = intersect(r);
+        int n = 0;
+        if (i.row > row)
+            out[n++] = GuiRect{col, row, wid, i.row - row};
+        if (i.row + i.hgt < row + hgt)
+            out[n++] = GuiRect{col, i.row + i.hgt, wid,
+                               row + hgt - (i.row + i.hgt)};
+        if (i.col > col)
+            out[n++] = GuiRect{col, i.row, i.col - col, i.hgt};
+        if (i.col + i.wid < col + wid)
+            out[n++] = GuiRect{i.col + i.wid, i.row,
+                               col + wid - (i.col + i.wid), i.hgt};
+        return n;
+    }
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_background.h"
+#include "gui_canvas.h"
+#include "gui_image.h"
+
+// Draw commands from the GUI core to a render core.
+//
+// Set GuiWidget::canvas to a GuiRenderQueue and widgets queue compact draw
+// commands instead of writing to their Framebuffer. The render core (core1
+// on RP2040/RP2350, a std::thread on the host) calls run(), which takes
+// commands off the queue in order and does the Framebuffer writes. While
+// the queue is in use, only the render core should touch the Framebuffer.
+//
+// The queue is a single-producer/single-consumer ring: only the GUI core
+// writes _head and only the render core writes _tail, so no locks are
+// needed. If the ring is full, the GUI core waits.
+//
+// Images are passed by pointer and read when the render core writes them;
+// run-length, mask and text images are decoded then, into a buffer the
+// queue keeps for the render core. Constant images (in flash) can be queued
+// and forgotten. An image in RAM (or a palette or text an image refers to)
+// must not change until it has been written: take a fence() after queueing
+// it, and wait() on the fence before changing or reusing it.
+
+class GuiRenderQueue : public GuiCanvas
+{
+public:
+
+    static const uint32_t capacity = 64; // power of two
+
+    struct Cmd {
+        enum class Op : uint8_t {
+            fill_rect, // a, b, c, d = col, row, wid, hgt
+            draw_rect, // a, b, c, d = col, row, wid, hgt
+            line,      // a, b, c, d = c0, r0, c1, r1
+            write,     // a, b = col, row
+            restore,   // a, b, c, d = col, row, wid, hgt from bg
+        };
+        Op op;
+        int16_t a;
+        int16_t b;
+        int16_t c;
+        int16_t d;
+        Color color;
+        GuiImage img;
+        GuiBackground *bg;
+        Framebuffer *fb;
+    };
+
+    GuiRenderQueue();
+
+    // GUI core (producer)
+
+    virtual void fill_rect(Framebuffer &fb, int col, int row, int wid, int hgt,
+                           Color c) override;
+
+    virtual void draw_rect(Framebuffer &fb, int col, int row, int wid, int hgt,
+                           Color c) override;
+
+    virtual void line(Framebuffer &fb, int c0, int r0, int c1, int r1,
+                      Color c) override;
+
+    virtual void write(Framebuffer &fb, int col, int row,
+                       const GuiImage &img) override;
+
+    virtual void restore(Framebuffer &fb, GuiBackground &bg, int col, int row,
+                         int wid, int hgt) override;
+
+    // A fence covering everything queued so far. It is done once all of
+    // that has been written to the Framebuffer.
+    virtual uint32_t fence() const override
+    {
+        return _head.load(std::memory_order_relaxed);
+    }
+
+    // Only commands between _tail and _head are pending, so a fence of any
+    // age is done unless it falls in that window.
+    bool done(uint32_t fence) const
+    {
+        const uint32_t tail = _tail.load(std::memory_order_acquire);
+        const uint32_t head = _head.load(std::memory_order_relaxed);
+        return (fence - tail - 1) >= (head - tail);
+    }
+
+    virtual void wait(uint32_t fence) const override;
+
+    // wait until everything queued so far has been written
+    void sync() const
+    {
+        wait(fence());
+    }
+
+    // times the GUI core found the ring full and had to wait
+    uint32_t full_waits() const
+    {
+        return _full_waits;
+    }
+
+    // Render core (consumer)
+
+    // Write the oldest command; false if there are none.
+    bool render_one();
+
+    // Write commands as they arrive until stop() is called and the queue
+    // is empty, then return (run() can be called again after that).
+    void run();
+
+    // Called from the GUI core.
+    void stop()
+    {
+        _stop.store(true, std::memory_order_release);
+    }
+
+private:
+
+    std::array<Cmd, capacity> _ring;
+
+    // Free-running counts of commands queued and written. _head is written
+    // only by the producer, _tail only by the consumer.
+    std::atomic<uint32_t> _head;
+    std::atomic<uint32_t> _tail;
+
+    std::atomic<bool> _stop;
+
+    uint32_t _full_waits;
+
+    // the render core's, for decoding images
+    alignas(8) uint8_t _decode_work[GuiImage::decode_bytes];
+
+    void push(const Cmd &cmd);
+};
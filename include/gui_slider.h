@@ -34,8 +34,29 @@ public:
 
     virtual void draw() override;
 
+    // move the handle from where it was last drawn to the current value,
+    // sending only what changed (or draw() if there is nothing to move from)
+    virtual void refresh() override;
+
+    virtual void erase() override;
+
+    virtual void erased() override
+    {
+        _drawn_val = not_drawn;
+    }
+
     virtual bool event(Touchscreen::Event &event) override;
 
+    virtual bool interactive() const override
+    {
+        return true;
+    }
+
+    virtual bool opaque() const override
+    {
+        return true;
+    }
+
     int get_value() const
     {
         return _val;
@@ -55,6 +76,10 @@ private:
     const int _val_max;
     int _val;
 
+    // value the handle was last drawn at
+    int _drawn_val;
+    static const int not_drawn = INT_MIN;
+
     // We could save the position of the handle instead of the value, but it's
     // a choice here to save the value instead. This makes is so the handle
     // 'jumps' between discrete value positions instead of smoothly sliding,
@@ -66,7 +91,10 @@ private:
     int to_column(int val);
     int to_value(int col);
 
-    void draw_handle();
-    void erase_handle();
+    void draw_handle(int val);
+    void erase_handle(int val);
+
+    void fill_columns(int first, int last, Color c);
+    void edge(int col);
 
 }; // class GuiSlider
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+// touchscreen
+#include "touchscreen.h"
+// gui
+#include "gui_background.h"
+#include "gui_page_base.h"
+#include "gui_rect.h"
+#include "gui_stats.h"
+#include "gui_widget.h"
+
+// A page whose widget types are fixed at compile time.
+//
+// GuiPage keeps up to 30 GuiWidget pointers and calls draw(), event() etc.
+// through the vtable. GuiStaticPage<Ws...> keeps a std::tuple<Ws...> and,
+// where it knows a widget's most-derived type, calls that type's draw(),
+// event() etc. by name, so the calls are direct and can be inlined. That
+// includes interactive() and opaque(), so a widget type that never claims
+// or blocks events (e.g. GuiLabel) drops out of the event loop at compile
+// time. The page has no array and no index; it is the size of its tuple
+// plus a few bytes.
+//
+// Ws can be widget types (the page owns the widgets, and widget<I>() gets
+// them) or references to widgets that live elsewhere:
+//
+//   GuiStaticPage<GuiLabel, GuiButton> page(GuiLabel(...), GuiButton(...));
+//   GuiStaticPage<GuiLabel &, GuiLabel &> page(l0, l1);
+//
+// A reference can be to a derived type (a GuiLabel & to a GuiButton), so
+// calls through it stay virtual unless its type is final. Own the widgets
+// to get direct calls.
+//
+// Like GuiPage, widgets are stacked in order, and events go top-down,
+// stopping at the first opaque widget under the touch. There is no deferred
+// mode, display list, raise() or occlusion: widgets are not on a GuiPage,
+// so they draw as soon as they change. Use GuiPage for those.
+
+template <typename... Ws>
+class GuiStaticPage
+{
+public:
+
+    static constexpr size_t widget_cnt = sizeof...(Ws);
+
+    template <typename... Args>
+    explicit GuiStaticPage(Args &&...widgets) :
+        _widgets(std::forward<Args>(widgets)...),
+        _visible(false),
+        _on_update(nullptr),
+        _on_update_arg(0)
+    {
+        static_assert(sizeof...(Args) == widget_cnt, "one arg per widget");
+    }
+
+    GuiStaticPage(const GuiStaticPage &) = delete;
+    GuiStaticPage &operator=(const GuiStaticPage &) = delete;
+
+    template <size_t I>
+    auto &widget()
+    {
+        return std::get<I>(_widgets);
+    }
+
+    void on_update(void (*on_update)(intptr_t), intptr_t on_update_arg = 0)
+    {
+        _on_update = on_update;
+        _on_update_arg = on_update_arg;
+    }
+
+    // as GuiPage::background()
+    void background(GuiBackground *bg)
+    {
+        std::apply([bg](auto &...w) { (w.background(bg), ...); }, _widgets);
+    }
+
+    void visible(bool v)
+    {
+        _visible = v;
+        if (_visible)
+            draw();
+        else
+            erase();
+    }
+
+    bool visible() const
+    {
+        return _visible;
+    }
+
+    void draw()
+    {
+        if (!_visible)
+            return;
+        draw_each(std::index_sequence_for<Ws...>{});
+    }
+
+    void erase()
+    {
+        erase_each(std::index_sequence_for<Ws...>{});
+    }
+
+    bool event(Touchscreen::Event &event)
+    {
+        if (!_visible)
+            return false;
+
+        GuiStats::event_start();
+
+        // A widget with focus wants events wherever they are
+        GuiWidget *f = GuiWidget::focus;
+        if (f != nullptr && owns(f) && f->event(event)) {
+            f->claimed();
+            return true;
+        }
+
+        return offer<widget_cnt>(event, f);
+    }
+
+    void update()
+    {
+        if (_visible && _on_update != nullptr)
+            _on_update(_on_update_arg);
+    }
+
+    // Widgets draw when they change; nothing is ever pending.
+    void flush()
+    {
+    }
+
+    // For GuiPageBase::swap()
+    int widgets(GuiWidget *out[], int max)
+    {
+        int cnt = 0;
+        std::apply(
+            [out, max, &cnt](auto &...w) {
+                ((cnt < max ? void(out[cnt++] = &w) : void()), ...);
+            },
+            _widgets);
+        return cnt;
+    }
+
+    void swapped_out()
+    {
+        _visible = false;
+    }
+
+    // Bounds of every widget, in page order. The count is fixed at compile
+    // time; the rects are read from the widgets, which are not literal types
+    // (and some only know their size once drawn).
+    std::array<GuiRect, widget_cnt> bounds() const
+    {
+        return std::apply(
+            [](const auto &...w) {
+                return std::array<GuiRect, widget_cnt>{w.rect()...};
+            },
+            _widgets);
+    }
+
+private:
+
+    std::tuple<Ws...> _widgets;
+    bool _visible;
+    void (*_on_update)(intptr_t);
+    intptr_t _on_update_arg;
+
+    template <size_t I>
+    using widget_t =
+        std::remove_reference_t<std::tuple_element_t<I, std::tuple<Ws...>>>;
+
+    // Widget I is known to be exactly a widget_t<I> if the page owns it, or
+    // if that type is final. Only then are its calls qualified with the
+    // type's name, which makes them direct.
+    template <size_t I>
+    static constexpr bool exact =
+        !std::is_reference_v<std::tuple_element_t<I, std::tuple<Ws...>>> ||
+        std::is_final_v<widget_t<I>>;
+
+    template <size_t... I>
+    void draw_each(std::index_sequence<I...>)
+    {
+        (draw_one<I>(), ...);
+    }
+
+    template <size_t I>
+    void draw_one()
+    {
+        using W = widget_t<I>;
+        auto &w = std::get<I>(_widgets);
+        GuiWidget::Timed timed(w);
+        if constexpr (exact<I>)
+            w.W::draw();
+        else
+            w.draw();
+    }
+
+    template <size_t... I>
+    void erase_each(std::index_sequence<I...>)
+    {
+        (erase_one<I>(), ...);
+    }
+
+    template <size_t I>
+    void erase_one()
+    {
+        using W = widget_t<I>;
+        auto &w = std::get<I>(_widgets);
+        if constexpr (exact<I>)
+            w.W::erase();
+        else
+            w.erase();
+    }
+
+    template <size_t I>
+    bool interactive_one() const
+    {
+        using W = widget_t<I>;
+        const auto &w = std::get<I>(_widgets);
+        if constexpr (exact<I>)
+            return w.W::interactive();
+        else
+            return w.interactive();
+    }
+
+    template <size_t I>
+    bool event_one(Touchscreen::Event &event)
+    {
+        using W = widget_t<I>;
+        auto &w = std::get<I>(_widgets);
+        if constexpr (exact<I>)
+            return w.W::event(event);
+        else
+            return w.event(event);
+    }
+
+    template <size_t I>
+    bool opaque_one() const
+    {
+        using W = widget_t<I>;
+        const auto &w = std::get<I>(_widgets);
+        if constexpr (exact<I>)
+            return w.W::opaque();
+        else
+            return w.opaque();
+    }
+
+    bool owns(const GuiWidget *w) const
+    {
+        return std::apply(
+            [w](const auto &...mine) {
+                return ((w == static_cast<const GuiWidget *>(&mine)) || ...);
+            },
+            _widgets);
+    }
+
+    // Offer the event to widgets I-1 down to 0 (except skip), until one
+    // claims it or it lands on an opaque widget.
+    template <size_t I>
+    bool offer(Touchscreen::Event &event, const GuiWidget *skip)
+    {
+        if constexpr (I == 0) {
+            return false;
+        } else {
+            auto &w = std::get<I - 1>(_widgets);
+            if (&w != skip && interactive_one<I - 1>() &&
+                event_one<I - 1>(event)) {
+                w.claimed();
+                return true;
+            }
+            if (opaque_one<I - 1>() && w.visible() &&
+                w.contains(event.col, event.row))
+                return false;
+            return offer<I - 1>(event, skip);
+        }
+    }
+};
+
+// Lets a GuiStaticPage (or anything with the same members) be used where a
+// GuiPageBase is wanted, e.g. in an array of pages or GuiEventQueue.
+// Only calls through the adapter are virtual.
+
+template <typename PAGE>
+class GuiPageAdapter : public GuiPageBase
+{
+public:
+
+    GuiPageAdapter(PAGE &page) : _page(page)
+    {
+    }
+
+    virtual void visible(bool v) override
+    {
+        _page.visible(v);
+    }
+
+    virtual void draw() override
+    {
+        _page.draw();
+    }
+
+    virtual void erase() const override
+    {
+        _page.erase();
+    }
+
+    virtual bool event(Touchscreen::Event &event) override
+    {
+        return _page.event(event);
+    }
+
+    virtual void update() override
+    {
+        _page.update();
+    }
+
+    virtual void flush() override
+    {
+        _page.flush();
+    }
+
+    virtual int widgets(GuiWidget *out[], int max) override
+    {
+        return _page.widgets(out, max);
+    }
+
+    virtual void swapped_out() override
+    {
+        _page.swapped_out();
+    }
+
+private:
+
+    PAGE &_page;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+
+// Per-widget drawing and event counters, for finding which widget is using
+// up the frame time.
+//
+// They are compiled in only if GUI_STATS is 1 (cmake -DGUI_STATS=ON);
+// otherwise widgets have no counters, GuiWidget::stats() is all zeros, and
+// the hooks compile to nothing.
+//
+// Each widget counts:
+//  - draws: draw() and refresh() calls made by pages and invalidate(), and
+//    the time spent in them (draws an app makes by calling draw() itself are
+//    not counted, and neither are replays of a page's display list, but
+//    their pixels are)
+//  - pixels: every pixel it sends to the framebuffer or canvas
+//  - events it claimed, with a histogram of the time from the page (or
+//    event queue, or loop) receiving the event until the widget's event()
+//    returned: the dispatch latency the user feels, including any drawing
+//    the handler did
+
+#ifndef GUI_STATS
+#define GUI_STATS 0
+#endif
+
+struct GuiStats {
+
+    // latency histogram: [0, 64us), [64us, 128us), ... [4096us, inf)
+    static const int bins = 8;
+    static const uint32_t bin0_us = 64;
+
+    uint32_t draws;
+    uint64_t draw_us;
+    uint64_t pixels;
+    uint32_t events;
+    uint32_t latency[bins];
+    uint32_t latency_max_us;
+
+    static int bin(uint32_t us)
+    {
+        int b = 0;
+        for (uint32_t top = bin0_us; b < bins - 1 && us >= top; top *= 2)
+            b++;
+        return b;
+    }
+
+    // lower edge of bin b
+    static uint32_t bin_us(int b)
+    {
+        return b == 0 ? 0 : bin0_us << (b - 1);
+    }
+
+    void event(uint32_t us)
+    {
+        events++;
+        latency[bin(us)]++;
+        if (us > latency_max_us)
+            latency_max_us = us;
+    }
+
+    // One line per widget; see GuiWidget::print_stats().
+    static void print_header();
+    void print(const char *name) const;
+
+    // Called when an event arrives, before it is dispatched.
+    static void event_start()
+    {
+#if GUI_STATS
+        event_start_us = time_us_64();
+#endif
+    }
+
+    static uint64_t event_start_us;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+// framebuffer
+#include "color.h"
+#include "font.h"
+#include "framebuffer.h"
+// gui
+#include "gui_canvas.h"
+#include "gui_image.h"
+#include "gui_widget.h"
+
+// GuiText is a widget that displays a string that can be changed, rendered
+// at runtime from a Font (see TextImageHdr). Labels need an image built at
+// compile time for each string; this is for text that is not known until
+// runtime, like status messages or values with units.
+//
+// Glyphs are blended with the colors as they are drawn, or copied from
+// GuiImage::glyph_cache if it is set.
+//
+// Like GuiNumber, the width follows the text, and alignment is supported
+// (left, center, right). When the text changes, only the ends the new text
+// no longer covers are erased.
+//
+// With a GuiRenderQueue, the render core reads the text and colors when it
+// draws them, so set_text() and set_color() wait until the last draw has
+// been written before changing them.
+
+class GuiText : public GuiWidget
+{
+public:
+
+    static const int max_len = 47;
+
+    GuiText(Framebuffer &fb, int col, int row, Color bg, const Font &font,
+            Color fg, const char *txt,
+            Framebuffer::HAlign h_align = Framebuffer::HAlign::Left,
+            bool visible = true, bool enabled = true);
+
+    virtual void draw() override;
+
+    // rewrite the text and erase what it no longer covers
+    virtual void refresh() override;
+
+    // the alignment reference moves with the text
+    virtual void move(int col, int row) override;
+
+    virtual void replayed() override
+    {
+        drawn();
+    }
+
+    // display only
+    virtual bool interactive() const override
+    {
+        return false;
+    }
+
+    // the text's background fills the widget's rectangle
+    virtual bool opaque() const override
+    {
+        return true;
+    }
+
+    // Copies up to max_len characters.
+    void set_text(const char *txt);
+
+    const char *get_text() const
+    {
+        return _img.txt;
+    }
+
+    void set_color(Color fg);
+
+    Color get_color() const
+    {
+        return _pal.fg;
+    }
+
+protected:
+
+    TextImage<max_len> _img;
+    GuiPalette _pal;
+
+    // _col_ref is the original col passed in constructor
+    // _col and _wid are changed in draw() based on alignment
+    Framebuffer::HAlign _h_align;
+    int _col_ref;
+
+    // _col for text wid wide
+    int align_col(int wid) const;
+
+    // The canvas the text was last drawn on, and a fence for it (see
+    // GuiCanvas::fence()).
+    GuiCanvas *_drawn_on;
+    uint32_t _fence;
+
+    // fence what was just drawn on canvas
+    void drawn();
+
+    // wait until the last draw no longer reads _img and _pal
+    void settle();
+
+}; // class GuiText
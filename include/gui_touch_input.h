@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+// pico
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+// touchscreen
+#include "touchscreen.h"
+
+// Interrupt-driven touch input. Wraps a Touchscreen (e.g. the GT911) and is
+// used in its place, e.g. by GuiLoop or GuiEventQueue::poll().
+//
+// Reading the controller is an I2C transaction. Instead of one per loop
+// pass, the controller is only read after its INT line has signalled new
+// data (a GPIO interrupt just records that and when), or, in case an edge
+// was missed, when nothing has been read for fallback_us. Everything read
+// goes into a ring of time-stamped events, which get_event() drains. Events
+// can also be put in the ring directly (inject()), e.g. by a host test, and
+// are then dispatched the same way.
+//
+// The ring has one producer and one consumer. The interrupt handler never
+// pushes; read() and inject() do, in thread context, and must not run at the
+// same time as each other (inject() from the thread calling get_event() is
+// always safe).
+
+class GuiTouchInput : public Touchscreen
+{
+public:
+
+    struct Stamped {
+        Event event;
+        uint64_t us; // when the controller signalled it
+    };
+
+    class Ring
+    {
+    public:
+
+        static const int capacity = 32;
+
+        Ring() : _head(0), _tail(0), _dropped(0)
+        {
+        }
+
+        bool empty() const
+        {
+            return _head.load(std::memory_order_acquire) ==
+                   _tail.load(std::memory_order_acquire);
+        }
+
+        // false (and the event is dropped) if full
+        bool push(const Event &event, uint64_t us);
+
+        bool pop(Stamped &stamped);
+
+        uint32_t dropped() const
+        {
+            return _dropped;
+        }
+
+    private:
+
+        std::array<Stamped, capacity> _events;
+        std::atomic<uint32_t> _head; // next to pop
+        std::atomic<uint32_t> _tail; // next to push
+        uint32_t _dropped;
+    };
+
+    // Without an INT line (int_gpio < 0) the controller is read every
+    // fallback_us. The GPIO interrupt is set up by irq_enable(), normally
+    // once the controller has been initialized (its reset uses INT).
+    GuiTouchInput(Touchscreen &ts, int int_gpio,
+                  uint32_t fallback_us = 100'000);
+
+    ~GuiTouchInput();
+
+    // Take the GPIO interrupt on int_gpio's edges (GPIO_IRQ_EDGE_* bits).
+    void irq_enable(uint32_t edges);
+
+    // Call from the GPIO interrupt handler for int_gpio. Also wakes a
+    // sleeping GuiLoop.
+    void signal()
+    {
+        // 32 bits, so the stamp is written in one store
+        _signal_us.store(time_us_32(), std::memory_order_relaxed);
+        _signalled.store(true, std::memory_order_release);
+        __sev();
+    }
+
+    // Read the controller if INT signalled (or fallback_us passed), then
+    // return the oldest event in the ring.
+    virtual Event get_event() override;
+
+    // when the event get_event() last returned was signalled
+    uint64_t event_us() const
+    {
+        return _event_us;
+    }
+
+    // thread context only (see above)
+    bool inject(const Event &event)
+    {
+        return _ring.push(event, time_us_64());
+    }
+
+    bool inject(const Event &event, uint64_t us)
+    {
+        return _ring.push(event, us);
+    }
+
+    virtual void set_rotation(Rotation r) override
+    {
+        _ts.set_rotation(r);
+    }
+
+    const Ring &ring() const
+    {
+        return _ring;
+    }
+
+    // times the controller was read
+    uint32_t reads() const
+    {
+        return _reads;
+    }
+
+private:
+
+    Touchscreen &_ts;
+    const int _int_gpio;
+    const uint32_t _fallback_us;
+
+    std::atomic<bool> _signalled;
+    std::atomic<uint32_t> _signal_us; // low 32 bits of time_us_64()
+    uint64_t _read_us; // last read of the controller
+
+    Ring _ring;
+    uint64_t _event_us;
+    uint32_t _reads;
+
+    // read what the controller has into the ring, up to Ring::capacity
+    void read(uint64_t us);
+
+    // the one the GPIO interrupt goes to
+    static GuiTouchInput *irq_input;
+    static void gpio_irq(uint gpio, uint32_t events);
+};
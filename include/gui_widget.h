@@ -5,7 +5,15 @@
 #include "framebuffer.h"
 // touchscreen
 #include "touchscreen.h"
+// gui
+#include "gui_background.h"
+#include "gui_canvas.h"
+#include "gui_image.h"
+#include "gui_rect.h"
+#include "gui_stats.h"
 
+class GuiPage;
+class GuiPageBase;
 
 class GuiWidget
 {
@@ -20,16 +28,33 @@ public:
         _hgt(hgt),
         _bg(bg),
         _visible(visible),
-        _enabled(enabled)
+        _enabled(enabled),
+        _page(nullptr),
+        _dirty(false),
+        _background(nullptr)
     {
+#if GUI_STATS
+        _stats = GuiStats{};
+        _stats_next = stats_list;
+        stats_list = this;
+#endif
     }
 
-    virtual ~GuiWidget() = default;
-
-    void visible(bool v)
+#if GUI_STATS
+    // A copy (e.g. in a GuiStaticPage) gets its own counters.
+    GuiWidget(const GuiWidget &w) :
+        GuiWidget(w._fb, w._col, w._row, w._wid, w._hgt, w._bg, w._visible,
+                  w._enabled)
     {
-        _visible = v;
+        _page = w._page;
+        _dirty = w._dirty;
+        _background = w._background;
     }
+#endif
+
+    virtual ~GuiWidget();
+
+    void visible(bool v);
 
     bool visible() const
     {
@@ -47,7 +72,7 @@ public:
             force_draw = true;
         }
         if (force_draw)
-            draw();
+            invalidate();
     }
 
     bool contains(int c, int r) const
@@ -55,14 +80,57 @@ public:
         return c >= _col && c < (_col + _wid) && r >= _row && r < (_row + _hgt);
     }
 
+    GuiRect rect() const
+    {
+        return GuiRect{_col, _row, _wid, _hgt};
+    }
+
     virtual void draw()
     {
     }
 
+    // Bring what is on the screen up to date with the widget's state. The
+    // default is a full draw(); widgets that can update just the part that
+    // changed override this.
+    virtual void refresh()
+    {
+        draw();
+    }
+
+    // Move the widget: erase it where it is, then draw it at col, row.
+    virtual void move(int col, int row);
+
     virtual void erase()
     {
         if (_visible)
-            _fb.fill_rect(_col, _row, _wid, _hgt, _bg);
+            erase_rect(_col, _row, _wid, _hgt);
+    }
+
+    // Erase by restoring what is behind the widget from bg, rather than
+    // filling with the widget's bg color (nullptr for that). Pages set this
+    // for all their widgets (see GuiPage::background()).
+    void background(GuiBackground *bg)
+    {
+        _background = bg;
+    }
+
+    GuiBackground *background() const
+    {
+        return _background;
+    }
+
+    // Something else (e.g. GuiPageBase::swap()) erased or painted over the
+    // widget instead of erase(). Widgets that remember what they drew
+    // override this to forget it.
+    virtual void erased()
+    {
+    }
+
+    // Something else (GuiPage's display list) drew what the widget drew on
+    // canvas, which is where it went this time. Widgets that wait for what
+    // they drew to be written (see GuiCanvas::fence()) override this.
+    virtual void replayed()
+    {
     }
 
     // This is called for all widgets when there is an event until one returns
@@ -72,10 +140,173 @@ public:
         return false;
     }
 
+    // True if event() can ever claim an event. Pages don't bother sending
+    // events to widgets that return false, so only widgets that never take
+    // events (labels, numbers, text) override this.
+    virtual bool interactive() const
+    {
+        return true;
+    }
+
+    // True if draw() covers every pixel of the widget's rectangle. Pages
+    // don't draw widgets hidden under opaque ones, and events don't go
+    // through opaque widgets to ones below.
+    virtual bool opaque() const
+    {
+        return false;
+    }
+
     static GuiWidget *focus;
 
+    // If set, all widgets draw on this instead of their Framebuffer.
+    static GuiCanvas *canvas;
+
+    // Drawing and event counters (see gui_stats.h); all zero unless
+    // GUI_STATS.
+    const GuiStats &stats() const
+    {
+#if GUI_STATS
+        return _stats;
+#else
+        return no_stats;
+#endif
+    }
+
+    void reset_stats();
+
+    // Print every widget's counters, one line each (nothing unless
+    // GUI_STATS).
+    static void print_stats();
+
+    // Whatever draws widgets for the app (pages, invalidate()) declares one
+    // of these around each draw() or refresh() to count and time it.
+    class Timed
+    {
+    public:
+
+#if GUI_STATS
+        Timed(const GuiWidget &w) : _stats(w._stats), _start_us(time_us_64())
+        {
+        }
+
+        ~Timed()
+        {
+            _stats.draws++;
+            _stats.draw_us += time_us_64() - _start_us;
+        }
+
+    private:
+
+        GuiStats &_stats;
+        uint64_t _start_us;
+#else
+        Timed(const GuiWidget &)
+        {
+        }
+#endif
+    };
+
+    // Call when event() claimed an event (see GuiStats::event_start()).
+    void claimed() const
+    {
+#if GUI_STATS
+        _stats.event(uint32_t(time_us_64() - GuiStats::event_start_us));
+#endif
+    }
+
 protected:
 
+    // Widgets draw with these rather than calling _fb directly, so the
+    // drawing can be redirected (see canvas).
+
+    void fill_rect(int col, int row, int wid, int hgt, Color c) const
+    {
+        count_pixels(wid, hgt);
+        if (canvas != nullptr)
+            canvas->fill_rect(_fb, col, row, wid, hgt, c);
+        else
+            _fb.fill_rect(col, row, wid, hgt, c);
+    }
+
+    void draw_rect(int col, int row, int wid, int hgt, Color c) const
+    {
+        // as Framebuffer::draw_rect() sends it: four sides
+        count_pixels(wid, 2);
+        count_pixels(2, hgt - 2);
+        if (canvas != nullptr)
+            canvas->draw_rect(_fb, col, row, wid, hgt, c);
+        else
+            _fb.draw_rect(col, row, wid, hgt, c);
+    }
+
+    void line(int c0, int r0, int c1, int r1, Color c) const
+    {
+        const int dc = c1 > c0 ? c1 - c0 : c0 - c1;
+        const int dr = r1 > r0 ? r1 - r0 : r0 - r1;
+        count_pixels((dc > dr ? dc : dr) + 1, 1);
+        if (canvas != nullptr)
+            canvas->line(_fb, c0, r0, c1, r1, c);
+        else
+            _fb.line(c0, r0, c1, r1, c);
+    }
+
+    // Put back what is behind the widget: its background, or its bg color.
+    void erase_rect(int col, int row, int wid, int hgt) const
+    {
+        if (_background != nullptr)
+            restore(*_background, col, row, wid, hgt);
+        else
+            fill_rect(col, row, wid, hgt, _bg);
+    }
+
+    void restore(GuiBackground &bg, int col, int row, int wid, int hgt) const
+    {
+        count_pixels(wid, hgt);
+        if (canvas != nullptr)
+            canvas->restore(_fb, bg, col, row, wid, hgt);
+        else
+            bg.restore(_fb, col, row, wid, hgt);
+    }
+
+    void write(int col, int row, const GuiImage &img) const
+    {
+        if (img.hdr() != nullptr)
+            count_pixels(img.wid(), img.hgt());
+        if (canvas != nullptr)
+            canvas->write(_fb, col, row, img);
+        else
+            img.write(_fb, col, row);
+    }
+
+    void count_pixels(int wid, int hgt) const
+    {
+#if GUI_STATS
+        if (wid > 0 && hgt > 0)
+            _stats.pixels += uint64_t(wid) * hgt;
+#else
+        (void)wid;
+        (void)hgt;
+#endif
+    }
+
+    // The widget's state changed and it needs to be drawn. If the widget is
+    // on a page in deferred mode, this just marks it and the page refreshes
+    // it on the next flush(); otherwise it is refreshed now.
+    void invalidate();
+
+    // The area the widget covers now is about to be uncovered (e.g. it is
+    // going to shrink). If the widget is on a page in deferred mode, the
+    // page erases the area on the next flush(); otherwise it is erased now.
+    void damage();
+
+    // Call after changing _col, _row, _wid or _hgt, so the page can update
+    // its hit-test index.
+    void bounds_changed();
+
+    // Tell the page what draw() would draw has changed (the helpers above
+    // all do).
+    void changed();
+
     Framebuffer &_fb;
 
     int _col;
@@ -87,4 +318,25 @@ protected:
 
     bool _visible;
     bool _enabled;
+
+    // Set when the widget is added to a page. A widget belongs to at most
+    // one page.
+    GuiPage *_page;
+
+    // invalidate() was called in deferred mode, and the page has not drawn
+    // the widget since (a hidden page's flush() leaves it set)
+    bool _dirty;
+
+    GuiBackground *_background;
+
+#if GUI_STATS
+    mutable GuiStats _stats;
+    GuiWidget *_stats_next; // all widgets, for print_stats()
+    static GuiWidget *stats_list;
+#else
+    static const GuiStats no_stats;
+#endif
+
+    friend class GuiPage;
+    friend class GuiPageBase;
 };
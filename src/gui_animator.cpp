@@ -0,0 +1,179 @@
+
+#include <cassert>
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+// gui
+#include "gui_animator.h"
+#include "gui_page_base.h"
+#include "gui_slider.h"
+#include "gui_widget.h"
+
+
+GuiAnimator::GuiAnimator(uint32_t frame_us_min, GuiPageBase *page) :
+    _tweens{},
+    _page(page),
+    _frame_us_min(frame_us_min),
+    _frame_us(frame_us_min),
+    _render_us(0),
+    _rendered(false),
+    _next_us(0),
+    _last_us(0),
+    _skip_us(0),
+    _stats{}
+{
+    assert(frame_us_min > 0);
+}
+
+
+int GuiAnimator::start(int from, int to, uint32_t dur_us, Setter set,
+                       intptr_t arg, Ease ease, uint32_t delay_us)
+{
+    assert(set != nullptr);
+    if (!running())
+        _last_us = 0; // a gap while idle is not skipped frames
+    for (int i = 0; i < max_tweens; i++) {
+        Tween &t = _tweens[i];
+        if (t.set == nullptr) {
+            t = Tween{set, arg, from, to, time_us_64() + delay_us, dur_us, ease};
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+void GuiAnimator::cancel(int tween)
+{
+    assert(0 <= tween && tween < max_tweens);
+    _tweens[tween].set = nullptr;
+}
+
+
+bool GuiAnimator::running() const
+{
+    for (const Tween &t : _tweens)
+        if (t.set != nullptr)
+            return true;
+    return false;
+}
+
+
+uint64_t GuiAnimator::due_us() const
+{
+    uint64_t first = UINT64_MAX;
+    for (const Tween &t : _tweens)
+        if (t.set != nullptr && t.start_us < first)
+            first = t.start_us;
+    return first > _next_us ? first : _next_us;
+}
+
+
+int32_t GuiAnimator::ease(Ease e, int32_t p)
+{
+    const int64_t q = p;
+    switch (e) {
+        case Ease::in:
+            return int32_t(q * q >> 16);
+        case Ease::out:
+            return one - int32_t((one - q) * (one - q) >> 16);
+        case Ease::in_out:
+            // 3p^2 - 2p^3
+            return int32_t((q * q >> 16) * (3 * one - 2 * q) >> 16);
+        default:
+            return p;
+    }
+}
+
+
+bool GuiAnimator::step()
+{
+    if (!running())
+        return false;
+
+    const uint64_t now = time_us_64();
+    if (now < due_us())
+        return false;
+
+    // frames the minimum interval would have drawn since the last one,
+    // carrying the fraction over to the next
+    if (_last_us != 0) {
+        const uint64_t gap = now - _last_us + _skip_us;
+        const uint32_t frames = uint32_t(gap / _frame_us_min);
+        _skip_us = uint32_t(gap % _frame_us_min);
+        if (frames > 1)
+            _stats.skipped += frames - 1;
+    } else {
+        _skip_us = 0;
+    }
+    _last_us = now;
+
+    for (Tween &t : _tweens) {
+        if (t.set == nullptr || now < t.start_us)
+            continue;
+        const uint64_t elapsed = now - t.start_us;
+        const Setter set = t.set;
+        int val = t.to;
+        if (elapsed < t.dur_us) {
+            const int32_t p = int32_t((elapsed << 16) / t.dur_us);
+            const int64_t span = int64_t(t.to) - t.from;
+            val = t.from + int((span * ease(t.ease, p) + one / 2) >> 16);
+        } else {
+            t.set = nullptr; // done; free the slot before the setter runs
+        }
+        set(t.arg, val);
+    }
+
+    if (_page != nullptr)
+        _page->flush();
+
+    // pace to how long drawing takes
+    const uint32_t us = uint32_t(time_us_64() - now);
+    _render_us = _rendered ? (3 * _render_us + us + 3) / 4 : us;
+    _rendered = true;
+    _frame_us = _render_us > _frame_us_min ? _render_us : _frame_us_min;
+    _next_us = now + _frame_us;
+
+    _stats.frames++;
+    if (us > _stats.worst_frame_us)
+        _stats.worst_frame_us = us;
+    return true;
+}
+
+
+void GuiAnimator::run()
+{
+    while (running()) {
+        const uint64_t due = due_us();
+        const uint64_t now = time_us_64();
+        if (now < due)
+            sleep_us(due - now);
+        step();
+    }
+}
+
+
+void GuiAnimator::task(intptr_t arg)
+{
+    reinterpret_cast<GuiAnimator *>(arg)->step();
+}
+
+
+void GuiAnimator::slider_value(intptr_t slider, int val)
+{
+    reinterpret_cast<GuiSlider *>(slider)->set_value(val);
+}
+
+
+void GuiAnimator::widget_col(intptr_t widget, int col)
+{
+    GuiWidget *w = reinterpret_cast<GuiWidget *>(widget);
+    w->move(col, w->rect().row);
+}
+
+
+void GuiAnimator::widget_row(intptr_t widget, int row)
+{
+    GuiWidget *w = reinterpret_cast<GuiWidget *>(widget);
+    w->move(w->rect().col, row);
+}
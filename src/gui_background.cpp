@@ -0,0 +1,182 @@
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_background.h"
+#include "gui_pixel.h"
+
+
+void GuiBackground::ImageSource::span(int col, int row, int wid,
+                                      GuiPixel *dst) const
+{
+    const int r = row - _row;
+    if (r < 0 || r >= _img->hgt) {
+        for (int i = 0; i < wid; i++)
+            dst[i] = _outside;
+        return;
+    }
+    const GuiPixel *src = image_pixels<GuiPixel>(_img) + r * _img->wid;
+    for (int i = 0; i < wid; i++) {
+        const int c = col + i - _col;
+        dst[i] = c >= 0 && c < _img->wid ? src[c] : _outside;
+    }
+}
+
+
+GuiPixel GuiBackground::GradientSource::at(int i) const
+{
+    if (i <= 0)
+        return GuiPixel(_c0);
+    if (i >= _len - 1)
+        return GuiPixel(_c1);
+    return GuiPixel(_c1.blend(_c0, i * 255 / (_len - 1)));
+}
+
+
+void GuiBackground::GradientSource::span(int col, int row, int wid,
+                                         GuiPixel *dst) const
+{
+    if (_vertical) {
+        const GuiPixel p = at(row);
+        for (int i = 0; i < wid; i++)
+            dst[i] = p;
+    } else {
+        for (int i = 0; i < wid; i++)
+            dst[i] = at(col + i);
+    }
+}
+
+
+void GuiBackground::TiledSource::span(int col, int row, int wid,
+                                      GuiPixel *dst) const
+{
+    const GuiPixel *src =
+        image_pixels<GuiPixel>(_img) + (row % _img->hgt) * _img->wid;
+    int c = col % _img->wid;
+    for (int i = 0; i < wid; i++) {
+        dst[i] = src[c];
+        if (++c == _img->wid)
+            c = 0;
+    }
+}
+
+
+GuiBackground::GuiBackground(const Source &src, uint8_t *mem,
+                             int mem_bytes) :
+    _src(src),
+    _strip(nullptr),
+    _slots{},
+    _slot_cnt(0),
+    _clock(0),
+    _hits(0),
+    _misses(0)
+{
+    // the strip starts aligned for its header
+    const uintptr_t align = alignof(PixelImageHdr);
+    uintptr_t p = (reinterpret_cast<uintptr_t>(mem) + align - 1) & ~(align - 1);
+    mem_bytes -= int(p - reinterpret_cast<uintptr_t>(mem));
+    const int strip_bytes = int(sizeof(PixelImageHdr)) +
+                            int(sizeof(GuiPixel)) * strip_cols * tile;
+    const int tile_bytes = int(sizeof(GuiPixel)) * tile * tile;
+    assert(mem_bytes >= strip_bytes + tile_bytes);
+
+    _strip = reinterpret_cast<PixelImageHdr *>(p);
+    p += strip_bytes;
+    mem_bytes -= strip_bytes;
+
+    _slot_cnt = mem_bytes / tile_bytes;
+    if (_slot_cnt > max_slots)
+        _slot_cnt = max_slots;
+    for (int i = 0; i < _slot_cnt; i++) {
+        _slots[i].pixels = reinterpret_cast<GuiPixel *>(p);
+        p += tile_bytes;
+    }
+}
+
+
+void GuiBackground::clear()
+{
+    for (int i = 0; i < _slot_cnt; i++)
+        _slots[i].used = false;
+}
+
+
+const GuiPixel *GuiBackground::get(int col, int row)
+{
+    const int pw = _src.period_wid();
+    const int ph = _src.period_hgt();
+    if (pw > 0)
+        col %= pw;
+    if (ph > 0)
+        row %= ph;
+
+    _clock++;
+    Slot *lru = &_slots[0];
+    for (int i = 0; i < _slot_cnt; i++) {
+        Slot &s = _slots[i];
+        if (s.used && s.col == col && s.row == row) {
+            s.last = _clock;
+            _hits++;
+            return s.pixels;
+        }
+        if (!s.used || (lru->used && s.last < lru->last))
+            lru = &s;
+    }
+
+    _misses++;
+    lru->col = col;
+    lru->row = row;
+    lru->used = true;
+    lru->last = _clock;
+    for (int r = 0; r < tile; r++)
+        _src.span(col, row + r, tile, lru->pixels + r * tile);
+    return lru->pixels;
+}
+
+
+void GuiBackground::restore(Framebuffer &fb, int col, int row, int wid,
+                            int hgt)
+{
+    if (wid <= 0 || hgt <= 0)
+        return;
+    const int col_end = col + wid;
+    const int row_end = row + hgt;
+    GuiPixel *const strip = reinterpret_cast<GuiPixel *>(_strip + 1);
+
+    // a band of rows in one row of tiles at a time, strip_cols wide at most
+    for (int r = row; r < row_end;) {
+        const int tile_row = r - r % tile;
+        const int r_end = tile_row + tile < row_end ? tile_row + tile : row_end;
+        for (int c = col; c < col_end;) {
+            const int c_end =
+                c + strip_cols < col_end ? c + strip_cols : col_end;
+            const int strip_wid = c_end - c;
+            // copy from each tile the band crosses
+            for (int tc = c; tc < c_end;) {
+                const int tile_col = tc - tc % tile;
+                const int tc_end =
+                    tile_col + tile < c_end ? tile_col + tile : c_end;
+                const GuiPixel *src =
+                    get(tile_col, tile_row) + (r - tile_row) * tile +
+                    (tc - tile_col);
+                GuiPixel *dst = strip + (tc - c);
+                for (int y = r; y < r_end; y++) {
+                    memcpy(dst, src, sizeof(GuiPixel) * (tc_end - tc));
+                    src += tile;
+                    dst += strip_wid;
+                }
+                tc = tc_end;
+            }
+            _strip->wid = strip_wid;
+            _strip->hgt = r_end - r;
+            fb.write(c, r, _strip);
+            c = c_end;
+        }
+        r = r_end;
+    }
+}
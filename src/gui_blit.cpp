@@ -0,0 +1,128 @@
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+// framebuffer
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_blit.h"
+#include "gui_pixel.h"
+#include "gui_render_queue.h"
+
+
+void GuiBlit::ImageSource::rows(int row, int cnt, GuiPixel *dst) const
+{
+    const GuiPixel *src = image_pixels<GuiPixel>(_img) + row * _img->wid;
+    memcpy(dst, src, sizeof(GuiPixel) * _img->wid * cnt);
+}
+
+
+GuiBlit::GuiBlit(uint8_t *work, int work_bytes, GuiRenderQueue *queue) :
+    _strips{},
+    _strip_bytes(0),
+    _strip_rows(0),
+    _strip_next(0),
+    _queue(queue),
+    _fb(nullptr),
+    _col(0),
+    _row(0),
+    _src(nullptr),
+    _next_row(0),
+    _strip_waits(0)
+{
+    // each strip starts aligned for its header
+    const uintptr_t align = alignof(PixelImageHdr);
+    uintptr_t p = (reinterpret_cast<uintptr_t>(work) + align - 1) & ~(align - 1);
+    work_bytes -= int(p - reinterpret_cast<uintptr_t>(work));
+    _strip_bytes = work_bytes / 2 & ~int(align - 1);
+    assert(_strip_bytes > int(sizeof(PixelImageHdr)));
+
+    for (Strip &strip : _strips) {
+        strip.hdr = reinterpret_cast<PixelImageHdr *>(p);
+        strip.queued = false;
+        strip.fence = 0;
+        p += _strip_bytes;
+    }
+}
+
+
+void GuiBlit::start(Framebuffer &fb, int col, int row, const Source &src)
+{
+    finish();
+
+    _fb = &fb;
+    _col = col;
+    _row = row;
+    _src = src.height() > 0 ? &src : nullptr;
+    _next_row = 0;
+
+    const int row_bytes = int(sizeof(GuiPixel)) * src.width();
+    _strip_rows = (_strip_bytes - int(sizeof(PixelImageHdr))) / row_bytes;
+    assert(_strip_rows > 0);
+}
+
+
+bool GuiBlit::strip_done(const Strip &strip) const
+{
+    return !strip.queued || _queue->done(strip.fence);
+}
+
+
+bool GuiBlit::step()
+{
+    if (sent())
+        return false;
+
+    Strip &strip = _strips[_strip_next];
+    _strip_next ^= 1;
+
+    // the render core may still be sending what is in this buffer
+    if (!strip_done(strip)) {
+        _strip_waits++;
+        _queue->wait(strip.fence);
+    }
+
+    int cnt = _src->height() - _next_row;
+    if (cnt > _strip_rows)
+        cnt = _strip_rows;
+
+    strip.hdr->wid = _src->width();
+    strip.hdr->hgt = cnt;
+    _src->rows(_next_row, cnt, reinterpret_cast<GuiPixel *>(strip.hdr + 1));
+
+    if (_queue != nullptr) {
+        _queue->write(*_fb, _col, _row + _next_row, strip.hdr);
+        strip.queued = true;
+        strip.fence = _queue->fence();
+    } else {
+        _fb->write(_col, _row + _next_row, strip.hdr);
+    }
+
+    _next_row += cnt;
+    if (_next_row >= _src->height())
+        _src = nullptr;
+    return !sent();
+}
+
+
+void GuiBlit::finish()
+{
+    while (step())
+        ;
+}
+
+
+bool GuiBlit::done() const
+{
+    return sent() && strip_done(_strips[0]) && strip_done(_strips[1]);
+}
+
+
+void GuiBlit::wait()
+{
+    finish();
+    for (const Strip &strip : _strips)
+        if (strip.queued)
+            _queue->wait(strip.fence);
+}
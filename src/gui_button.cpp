@@ -8,6 +8,7 @@
 #include "touchscreen.h"
 // gui
 #include "gui_button.h"
+#include "gui_latency.h"
 #include "gui_widget.h"
 
 using Event = Touchscreen::Event;
@@ -30,13 +31,14 @@ bool GuiButton::event(Event &event)
 
     if (event.type == Event::Type::down) {
         focus = this;
+        GuiLatency::pressed(this);
         bool was_pressed = _pressed;
         if (_mode == Mode::Check)
             _pressed = !_pressed;
         else // Momentary or Radio
             _pressed = true;
         if (_pressed != was_pressed) {
-            draw();
+            invalidate();
             if (_on_down != nullptr)
                 (*_on_down)(_on_down_arg);
         }
@@ -52,7 +54,7 @@ bool GuiButton::event(Event &event)
         if (_mode == Mode::Momentary)
             _pressed = false;
         if (_pressed != was_pressed) {
-            draw();
+            invalidate();
             if (_on_up != nullptr)
                 (*_on_up)(_on_up_arg);
             // if the up is within the button, it's a click
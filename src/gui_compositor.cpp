@@ -0,0 +1,205 @@
+
+#include <cassert>
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_background.h"
+#include "gui_compositor.h"
+#include "gui_image.h"
+#include "gui_pixel.h"
+#include "gui_rect.h"
+
+
+GuiCompositor::GuiCompositor(uint8_t *work, int work_bytes, int max_rows) :
+    _hdr(nullptr),
+    _decode(nullptr),
+    _pixels(0),
+    _max_rows(max_rows),
+    _fb(nullptr),
+    _band{0, 0, 0, 0},
+    _ops(0),
+    _bands(0),
+    _direct_bytes(0)
+{
+    // the band starts aligned for its header
+    const uintptr_t align = alignof(PixelImageHdr);
+    uintptr_t p = (reinterpret_cast<uintptr_t>(work) + align - 1) & ~(align - 1);
+    work_bytes -= int(p - reinterpret_cast<uintptr_t>(work));
+    _pixels = (work_bytes - int(sizeof(PixelImageHdr))) / 2 /
+              int(sizeof(GuiPixel));
+    assert(_pixels > 0);
+    _hdr = reinterpret_cast<PixelImageHdr *>(p);
+    _decode = reinterpret_cast<GuiPixel *>(_hdr + 1) + _pixels;
+}
+
+
+int GuiCompositor::band_rows(int wid) const
+{
+    if (wid <= 0)
+        return 0;
+    const int rows = _pixels / wid;
+    return _max_rows > 0 && rows > _max_rows ? _max_rows : rows;
+}
+
+
+void GuiCompositor::begin(Framebuffer &fb, int col, int row, int wid, int hgt,
+                          Color bg, const GuiBackground::Source *src)
+{
+    assert(wid * hgt <= _pixels);
+    _fb = &fb;
+    _band = GuiRect{col, row, wid, hgt};
+    for (int r = row; r < row + hgt; r++) {
+        GuiPixel *dst = at(col, r);
+        if (src != nullptr) {
+            src->span(col, r, wid, dst);
+        } else {
+            const GuiPixel p(bg);
+            for (int c = 0; c < wid; c++)
+                dst[c] = p;
+        }
+    }
+}
+
+
+void GuiCompositor::end()
+{
+    _hdr->wid = _band.wid;
+    _hdr->hgt = _band.hgt;
+    _fb->write(_band.col, _band.row, _hdr);
+    _bands++;
+}
+
+
+void GuiCompositor::fill(int col, int row, int wid, int hgt, Color c)
+{
+    const GuiRect r = _band.intersect(GuiRect{col, row, wid, hgt});
+    if (r.empty())
+        return;
+    const GuiPixel p(c);
+    for (int y = r.row; y < r.row + r.hgt; y++) {
+        GuiPixel *dst = at(r.col, y);
+        for (int x = 0; x < r.wid; x++)
+            dst[x] = p;
+    }
+}
+
+
+void GuiCompositor::fill_rect(Framebuffer &, int col, int row, int wid,
+                              int hgt, Color c)
+{
+    _ops++;
+    _direct_bytes += window_bytes(wid, hgt);
+    fill(col, row, wid, hgt, c);
+}
+
+
+// as Framebuffer::draw_rect()
+void GuiCompositor::draw_rect(Framebuffer &, int col, int row, int wid,
+                              int hgt, Color c)
+{
+    _ops++;
+    _direct_bytes += 2 * window_bytes(wid, 1) + 2 * window_bytes(1, hgt - 2);
+    fill(col, row, wid, 1, c);
+    fill(col, row + hgt - 1, wid, 1, c);
+    fill(col, row + 1, 1, hgt - 2, c);
+    fill(col + wid - 1, row + 1, 1, hgt - 2, c);
+}
+
+
+// as Framebuffer::line()
+void GuiCompositor::line(Framebuffer &, int c0, int r0, int c1, int r1,
+                         Color c)
+{
+    _ops++;
+    if (c0 == c1 || r0 == r1) {
+        int col = c0 < c1 ? c0 : c1;
+        int row = r0 < r1 ? r0 : r1;
+        int wid = (c0 < c1 ? c1 - c0 : c0 - c1) + 1;
+        int hgt = (r0 < r1 ? r1 - r0 : r0 - r1) + 1;
+        _direct_bytes += window_bytes(wid, hgt);
+        fill(col, row, wid, hgt, c);
+        return;
+    }
+    const GuiRect bounds{c0 < c1 ? c0 : c1, r0 < r1 ? r0 : r1,
+                         (c0 < c1 ? c1 - c0 : c0 - c1) + 1,
+                         (r0 < r1 ? r1 - r0 : r0 - r1) + 1};
+    // straight to the panel, it's a window per pixel
+    const int steps = bounds.wid > bounds.hgt ? bounds.wid : bounds.hgt;
+    _direct_bytes += steps * window_bytes(1, 1);
+    if (!_band.intersects(bounds))
+        return;
+    const GuiPixel p(c);
+    int dc = c1 > c0 ? c1 - c0 : c0 - c1;
+    int dr = r1 > r0 ? r0 - r1 : r1 - r0;
+    int sc = c0 < c1 ? 1 : -1;
+    int sr = r0 < r1 ? 1 : -1;
+    int err = dc + dr;
+    while (true) {
+        if (_band.contains(GuiRect{c0, r0, 1, 1}))
+            *at(c0, r0) = p;
+        if (c0 == c1 && r0 == r1)
+            break;
+        int e2 = 2 * err;
+        if (e2 >= dr) {
+            err += dr;
+            c0 += sc;
+        }
+        if (e2 <= dc) {
+            err += dc;
+            r0 += sr;
+        }
+    }
+}
+
+
+void GuiCompositor::write(Framebuffer &, int col, int row,
+                          const GuiImage &img)
+{
+    _ops++;
+    if (img.hdr() == nullptr)
+        return;
+    _direct_bytes += window_bytes(img.wid(), img.hgt());
+    const GuiRect r = _band.intersect(GuiRect{col, row, img.wid(), img.hgt()});
+    if (r.empty())
+        return;
+
+    // decode as many of the image's rows as fit at a time
+    const int wid = img.wid();
+    int cnt = _pixels / wid;
+    assert(cnt > 0); // image wider than the work buffer allows
+    if (cnt == 0)
+        return;
+    for (int y = r.row; y < r.row + r.hgt; y += cnt) {
+        if (cnt > r.row + r.hgt - y)
+            cnt = r.row + r.hgt - y;
+        img.rows(y - row, cnt, _decode);
+        for (int i = 0; i < cnt; i++) {
+            const GuiPixel *src = _decode + i * wid + (r.col - col);
+            GuiPixel *dst = at(r.col, y + i);
+            for (int x = 0; x < r.wid; x++)
+                dst[x] = src[x];
+        }
+    }
+}
+
+
+void GuiCompositor::restore(Framebuffer &, GuiBackground &bg, int col,
+                            int row, int wid, int hgt)
+{
+    _ops++;
+    // as GuiBackground::restore(): a window per tile row per strip
+    if (wid > 0 && hgt > 0) {
+        const int tile = GuiBackground::tile;
+        const int tile_rows = (row + hgt - 1) / tile - row / tile + 1;
+        const int strips =
+            (wid + GuiBackground::strip_cols - 1) / GuiBackground::strip_cols;
+        _direct_bytes += window_bytes(wid, hgt) +
+                         (tile_rows * strips - 1) * window_cmd_bytes;
+    }
+    const GuiRect r = _band.intersect(GuiRect{col, row, wid, hgt});
+    for (int y = r.row; y < r.row + r.hgt; y++)
+        bg.source().span(r.col, y, r.wid, at(r.col, y));
+}
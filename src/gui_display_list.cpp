@@ -0,0 +1,127 @@
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_background.h"
+#include "gui_display_list.h"
+#include "gui_image.h"
+
+using Code = GuiDisplayList::Op::Code;
+
+
+GuiDisplayList::GuiDisplayList(Op *ops, int max_ops) :
+    _ops(ops),
+    _max(max_ops),
+    _cnt(0),
+    _overflow(false),
+    _widget(0),
+    _insert(0),
+    _replace(0),
+    _records(0)
+{
+    assert(_ops != nullptr && _max > 0);
+}
+
+
+void GuiDisplayList::clear()
+{
+    _cnt = 0;
+    _overflow = false;
+    _widget = 0;
+    _insert = 0;
+    _replace = 0;
+    _records = 0;
+}
+
+
+void GuiDisplayList::begin(int widget)
+{
+    assert(0 <= widget && widget <= UINT8_MAX);
+    end();
+    _records++;
+
+    // ops are in widget order, so the widget's ops are one run
+    int first = 0;
+    while (first < _cnt && _ops[first].widget < widget)
+        first++;
+    int last = first;
+    while (last < _cnt && _ops[last].widget == widget)
+        last++;
+
+    _widget = widget;
+    _insert = first;
+    _replace = last;
+}
+
+
+void GuiDisplayList::end()
+{
+    // the widget drew fewer ops than last time: drop the rest of the old ones
+    memmove(&_ops[_insert], &_ops[_replace], sizeof(Op) * (_cnt - _replace));
+    _cnt -= _replace - _insert;
+    _replace = _insert;
+}
+
+
+void GuiDisplayList::insert(const Op &op)
+{
+    // A widget usually draws the same ops as last time, with new values, so
+    // they go over the old ones. Only extra ops move the rest along.
+    if (_insert < _replace) {
+        _ops[_insert++] = op;
+        return;
+    }
+    if (_cnt == _max) {
+        _overflow = true;
+        return;
+    }
+    memmove(&_ops[_insert + 1], &_ops[_insert], sizeof(Op) * (_cnt - _insert));
+    _ops[_insert++] = op;
+    _cnt++;
+    _replace = _insert;
+}
+
+
+void GuiDisplayList::fill_rect(Framebuffer &, int col, int row, int wid,
+                               int hgt, Color c)
+{
+    insert(Op{Code::fill_rect, uint8_t(_widget), int16_t(col), int16_t(row),
+              int16_t(wid), int16_t(hgt), c, GuiImage(), nullptr});
+}
+
+
+void GuiDisplayList::draw_rect(Framebuffer &, int col, int row, int wid,
+                               int hgt, Color c)
+{
+    insert(Op{Code::draw_rect, uint8_t(_widget), int16_t(col), int16_t(row),
+              int16_t(wid), int16_t(hgt), c, GuiImage(), nullptr});
+}
+
+
+void GuiDisplayList::line(Framebuffer &, int c0, int r0, int c1, int r1,
+                          Color c)
+{
+    insert(Op{Code::line, uint8_t(_widget), int16_t(c0), int16_t(r0),
+              int16_t(c1), int16_t(r1), c, GuiImage(), nullptr});
+}
+
+
+void GuiDisplayList::write(Framebuffer &, int col, int row,
+                           const GuiImage &img)
+{
+    insert(Op{Code::write, uint8_t(_widget), int16_t(col), int16_t(row), 0, 0,
+              Color(), img, nullptr});
+}
+
+
+void GuiDisplayList::restore(Framebuffer &, GuiBackground &bg, int col,
+                             int row, int wid, int hgt)
+{
+    insert(Op{Code::restore, uint8_t(_widget), int16_t(col), int16_t(row),
+              int16_t(wid), int16_t(hgt), Color(), GuiImage(), &bg});
+}
@@ -0,0 +1,139 @@
+
+#include <cassert>
+#include <cstdint>
+// touchscreen
+#include "touchscreen.h"
+// gui
+#include "gui_event_queue.h"
+#include "gui_latency.h"
+#include "gui_page_base.h"
+#include "gui_stats.h"
+#include "gui_touch_input.h"
+#include "gui_widget.h"
+
+using Event = Touchscreen::Event;
+
+
+GuiEventQueue::GuiEventQueue() :
+    _events{},
+    _head(0),
+    _cnt(0),
+    _held(),
+    _coalesced(0),
+    _dropped(0),
+    _refused(0)
+{
+}
+
+
+bool GuiEventQueue::push(const Event &event)
+{
+    if (event.type == Event::Type::none)
+        return true;
+
+    if (event.type == Event::Type::move) {
+        if (_cnt > 0 && at(_cnt - 1).type == Event::Type::move) {
+            at(_cnt - 1) = event;
+            _coalesced++;
+            return true;
+        }
+        if (_cnt == capacity && !drop_oldest_move()) {
+            _dropped++;
+            return true;
+        }
+    } else if (_cnt == capacity && !drop_oldest_move()) {
+        _refused++;
+        return false;
+    }
+
+    at(_cnt++) = event;
+    return true;
+}
+
+
+// Drop the oldest queued move, shifting the newer events down.
+bool GuiEventQueue::drop_oldest_move()
+{
+    for (int i = 0; i < _cnt; i++) {
+        if (at(i).type == Event::Type::move) {
+            for (int j = i; j < _cnt - 1; j++)
+                at(j) = at(j + 1);
+            _cnt--;
+            _dropped++;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool GuiEventQueue::pop(Event &event)
+{
+    if (_cnt == 0)
+        return false;
+    event = at(0);
+    _head = (_head + 1) % capacity;
+    _cnt--;
+    return true;
+}
+
+
+int GuiEventQueue::poll(Touchscreen &ts)
+{
+    return poll(ts, nullptr);
+}
+
+
+int GuiEventQueue::poll(GuiTouchInput &ts)
+{
+    return poll(ts, &ts);
+}
+
+
+int GuiEventQueue::poll(Touchscreen &ts, const GuiTouchInput *input)
+{
+    // something read last time that did not fit goes first
+    if (_held.type != Event::Type::none) {
+        if (!push(_held))
+            return 0;
+        _held = Event();
+    }
+
+    // (a touchscreen reporting a held touch on every read never runs out)
+    int cnt = 0;
+    while (cnt < capacity) {
+        Event event(ts.get_event());
+        if (event.type == Event::Type::none)
+            break;
+        if (input != nullptr)
+            GuiLatency::captured(event, input->event_us());
+        else
+            GuiLatency::captured(event);
+        cnt++;
+        if (!push(event)) {
+            _held = event;
+            break;
+        }
+    }
+    return cnt;
+}
+
+
+bool GuiEventQueue::dispatch(GuiPageBase &page)
+{
+    Event event;
+    if (!pop(event))
+        return false;
+
+    GuiStats::event_start();
+    GuiLatency::dispatched(event);
+    GuiWidget *f = GuiWidget::focus;
+    if (f != nullptr) {
+        if (f->event(event))
+            f->claimed();
+    } else {
+        page.event(event);
+    }
+
+    return true;
+}
@@ -0,0 +1,130 @@
+
+#include <cassert>
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "font.h"
+// gui
+#include "gui_glyph_cache.h"
+#include "gui_pixel.h"
+
+
+// two bytes per row, padded to align the pixels that follow
+static int spans_bytes(const Glyph *glyph)
+{
+    const int align = int(alignof(GuiPixel));
+    return (2 * glyph->hgt + align - 1) & ~(align - 1);
+}
+
+
+GuiGlyphCache::GuiGlyphCache(uint8_t *mem, int mem_bytes, int slots) :
+    _entries(nullptr),
+    _slot_mem(nullptr),
+    _slot_cnt(slots),
+    _slot_bytes(0),
+    _clock(0),
+    _hits(0),
+    _misses(0)
+{
+    assert(slots > 0);
+
+    // entries first, then the slots, each aligned for its pixels
+    const uintptr_t align = alignof(Entry);
+    uintptr_t p = (reinterpret_cast<uintptr_t>(mem) + align - 1) & ~(align - 1);
+    _entries = reinterpret_cast<Entry *>(p);
+    p += sizeof(Entry) * slots;
+    const int used = int(p - reinterpret_cast<uintptr_t>(mem));
+    assert(used < mem_bytes);
+
+    _slot_mem = reinterpret_cast<uint8_t *>(p);
+    _slot_bytes = (mem_bytes - used) / slots & ~int(alignof(GuiPixel) - 1);
+    assert(_slot_bytes > 0);
+
+    clear();
+}
+
+
+void GuiGlyphCache::clear()
+{
+    for (int i = 0; i < _slot_cnt; i++)
+        _entries[i] = Entry{nullptr, Color(), Color(), 0, nullptr, nullptr};
+    _clock = 0;
+}
+
+
+// slot holding glyph in these colors, or -1
+int GuiGlyphCache::lookup(const Glyph *glyph, Color fg, Color bg) const
+{
+    for (int i = 0; i < _slot_cnt; i++) {
+        const Entry &e = _entries[i];
+        if (e.glyph == glyph && e.fg == fg && e.bg == bg)
+            return i;
+    }
+    return -1;
+}
+
+
+const GuiGlyphCache::Entry *GuiGlyphCache::find(const Glyph *glyph, Color fg,
+                                                Color bg)
+{
+    const int i = lookup(glyph, fg, bg);
+    if (i < 0)
+        return nullptr;
+    _entries[i].used = ++_clock;
+    return &_entries[i];
+}
+
+
+const GuiGlyphCache::Entry *GuiGlyphCache::get(const Font &font,
+                                               const Glyph *glyph, Color fg,
+                                               Color bg)
+{
+    const Entry *e = find(glyph, fg, bg);
+    if (e != nullptr) {
+        _hits++;
+        return e;
+    }
+    _misses++;
+
+    // spans, then pixels
+    if (spans_bytes(glyph) + int(sizeof(GuiPixel)) * glyph->wid * glyph->hgt >
+        _slot_bytes)
+        return nullptr;
+
+    // a free slot, else the least recently used
+    int victim = 0;
+    for (int i = 1; i < _slot_cnt && _entries[victim].glyph != nullptr; i++)
+        if (_entries[i].glyph == nullptr ||
+            _entries[i].used < _entries[victim].used)
+            victim = i;
+
+    fill(victim, font, glyph, fg, bg);
+    return &_entries[victim];
+}
+
+
+void GuiGlyphCache::fill(int slot, const Font &font, const Glyph *glyph,
+                         Color fg, Color bg)
+{
+    uint8_t *mem = _slot_mem + slot * _slot_bytes;
+    uint8_t *spans = mem;
+    GuiPixel *pixels = reinterpret_cast<GuiPixel *>(mem + spans_bytes(glyph));
+
+    for (int y = 0; y < glyph->hgt; y++) {
+        int first = glyph->wid;
+        int end = 0;
+        for (int x = 0; x < glyph->wid; x++) {
+            const int a = font.alpha(glyph, x, y);
+            pixels[y * glyph->wid + x] = GuiPixel(fg.blend(bg, a));
+            if (a != 0) {
+                if (x < first)
+                    first = x;
+                end = x + 1;
+            }
+        }
+        spans[2 * y] = uint8_t(end == 0 ? 0 : first);
+        spans[2 * y + 1] = uint8_t(end);
+    }
+
+    _entries[slot] = Entry{glyph, fg, bg, ++_clock, spans, pixels};
+}
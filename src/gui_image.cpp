@@ -0,0 +1,303 @@
+
+#include <cassert>
+#include <cstdint>
+// framebuffer
+#include "color.h"
+#include "font.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_blit.h"
+#include "gui_glyph_cache.h"
+#include "gui_image.h"
+#include "gui_pixel.h"
+
+// Runs of an RleImage, handed out a strip at a time. GuiBlit asks for rows
+// in order, so this just keeps its place.
+class RleSource : public GuiBlit::Source
+{
+public:
+
+    RleSource(const RleImageHdr *rle) :
+        _rle(rle),
+        _run(image_runs(rle)),
+        _left(0),
+        _next_row(0)
+    {
+    }
+
+    virtual int width() const override
+    {
+        return _rle->hdr.wid;
+    }
+
+    virtual int height() const override
+    {
+        return _rle->hdr.hgt;
+    }
+
+    // start at row instead of the top
+    void skip(int row)
+    {
+        assert(_next_row == 0);
+        int todo = row * _rle->hdr.wid;
+        while (todo >= _run->len) {
+            todo -= _run->len;
+            _run++;
+        }
+        _left = todo == 0 ? 0 : _run->len - todo;
+        _next_row = row;
+    }
+
+    virtual void rows(int row, int cnt, GuiPixel *dst) const override
+    {
+        assert(row == _next_row);
+        _next_row = row + cnt;
+
+        int todo = cnt * _rle->hdr.wid;
+        while (todo > 0) {
+            if (_left == 0)
+                _left = _run->len;
+            int n = _left < todo ? _left : todo;
+            const GuiPixel p = _run->pixel;
+            todo -= n;
+            _left -= n;
+            while (n-- > 0)
+                *dst++ = p;
+            if (_left == 0)
+                _run++;
+        }
+    }
+
+private:
+
+    const RleImageHdr *_rle;
+
+    // place in the runs
+    mutable const RleRun *_run;
+    mutable int _left; // pixels left in *_run, 0 if not started
+    mutable int _next_row;
+};
+
+
+// A mask drawn in a palette. The 2^bpp possible text pixels are blended
+// once up front, so each pixel is a lookup.
+class MaskSource : public GuiBlit::Source
+{
+public:
+
+    MaskSource(const MaskImageHdr *mask, const GuiPalette *pal) :
+        _mask(mask),
+        _bg(pal->bg),
+        _brd(pal->brd_clr),
+        _brd_thk(pal->brd_clr == Color::none() ? 0 : pal->brd_thk)
+    {
+        const int max = (1 << mask->bpp) - 1;
+        _text[0] = _bg; // unused; zero coverage shows bg or border
+        for (int q = 1; q <= max; q++)
+            _text[q] = GuiPixel(pal->fg.blend(pal->bg, q * 255 / max));
+    }
+
+    virtual int width() const override
+    {
+        return _mask->hdr.wid;
+    }
+
+    virtual int height() const override
+    {
+        return _mask->hdr.hgt;
+    }
+
+    virtual void rows(int row, int cnt, GuiPixel *dst) const override
+    {
+        const int wid = _mask->hdr.wid;
+        const int hgt = _mask->hdr.hgt;
+        const int bpp = _mask->bpp;
+        const int max = (1 << bpp) - 1;
+        const uint8_t *bits = image_bits(_mask);
+
+        for (int r = row; r < row + cnt; r++) {
+            const bool brd_row = r < _brd_thk || r >= hgt - _brd_thk;
+            int bit = r * wid * bpp;
+            for (int c = 0; c < wid; c++, bit += bpp) {
+                const int q = (bits[bit / 8] >> (8 - bpp - bit % 8)) & max;
+                if (q != 0)
+                    *dst++ = _text[q];
+                else if (brd_row || c < _brd_thk || c >= wid - _brd_thk)
+                    *dst++ = _brd;
+                else
+                    *dst++ = _bg;
+            }
+        }
+    }
+
+private:
+
+    const MaskImageHdr *_mask;
+    GuiPixel _bg;
+    GuiPixel _brd;
+    int _brd_thk;        // zero if no border
+    GuiPixel _text[256]; // indexed by coverage
+};
+
+
+// A line of text, laid out as label_img() does. Each strip is filled with
+// bg, then each glyph's rows in the strip are copied in from the glyph cache
+// (only the span with coverage), or blended if not cached.
+class TextSource : public GuiBlit::Source
+{
+public:
+
+    TextSource(const TextImageHdr *text, const GuiPalette *pal) :
+        _text(text),
+        _fg(pal->fg),
+        _bg(pal->bg)
+    {
+    }
+
+    virtual int width() const override
+    {
+        return _text->hdr.wid;
+    }
+
+    virtual int height() const override
+    {
+        return _text->hdr.hgt;
+    }
+
+    virtual void rows(int row, int cnt, GuiPixel *dst) const override
+    {
+        const int wid = _text->hdr.wid;
+        const Font &font = *_text->font;
+        GuiGlyphCache *cache = GuiImage::glyph_cache;
+
+        const GuiPixel bg(_bg);
+        for (int i = 0; i < wid * cnt; i++)
+            dst[i] = bg;
+
+        int col = 0;
+        for (const char *s = image_text(_text); *s != '\0'; s++) {
+            const Glyph *g = font.glyph(*s);
+            const int c0 = col + g->x_off;
+            col += g->x_adv;
+
+            // glyph rows in this strip
+            const int y0 = row > g->y_off ? row - g->y_off : 0;
+            int y1 = row + cnt - g->y_off;
+            if (y1 > g->hgt)
+                y1 = g->hgt;
+            if (y0 >= y1)
+                continue;
+
+            // Glyphs are cached by the strip they start in. If a later strip
+            // finds one evicted (by a string with more glyphs than the cache
+            // has slots), it is blended rather than cached again.
+            const GuiGlyphCache::Entry *e = nullptr;
+            if (cache != nullptr)
+                e = y0 == 0 ? cache->get(font, g, _fg, _bg)
+                            : cache->find(g, _fg, _bg);
+
+            for (int y = y0; y < y1; y++) {
+                GuiPixel *d = dst + (g->y_off + y - row) * wid;
+                int x0 = e == nullptr ? 0 : e->spans[2 * y];
+                int x1 = e == nullptr ? g->wid : e->spans[2 * y + 1];
+                if (c0 + x0 < 0)
+                    x0 = -c0;
+                if (c0 + x1 > wid)
+                    x1 = wid - c0;
+                if (e != nullptr) {
+                    const GuiPixel *p = e->pixels + y * g->wid;
+                    for (int x = x0; x < x1; x++)
+                        d[c0 + x] = p[x];
+                } else {
+                    for (int x = x0; x < x1; x++) {
+                        const int a = font.alpha(g, x, y);
+                        if (a != 0)
+                            d[c0 + x] = GuiPixel(_fg.blend(_bg, a));
+                    }
+                }
+            }
+        }
+    }
+
+private:
+
+    const TextImageHdr *_text;
+    Color _fg;
+    Color _bg;
+};
+
+
+GuiGlyphCache *GuiImage::glyph_cache = nullptr;
+
+
+// for write() without a buffer of its own
+alignas(8) static uint8_t decode_work[GuiImage::decode_bytes];
+static bool decoding = false;
+
+
+void GuiImage::write(Framebuffer &fb, int col, int row) const
+{
+    if (_format == Format::raw) {
+        fb.write(col, row, _hdr);
+        return;
+    }
+    assert(!decoding); // decode_work is in use
+    decoding = true;
+    write(fb, col, row, decode_work, decode_bytes);
+    decoding = false;
+}
+
+
+void GuiImage::write(Framebuffer &fb, int col, int row, uint8_t *work,
+                     int work_bytes) const
+{
+    if (_format == Format::raw) {
+        fb.write(col, row, _hdr);
+        return;
+    }
+
+    // Whatever calls this does the panel writes, so the strips are written
+    // directly.
+    GuiBlit blit(work, work_bytes);
+    if (_format == Format::rle) {
+        const RleSource src(reinterpret_cast<const RleImageHdr *>(_hdr));
+        blit.start(fb, col, row, src);
+        blit.finish();
+    } else if (_format == Format::mask) {
+        const MaskSource src(reinterpret_cast<const MaskImageHdr *>(_hdr),
+                             _pal);
+        blit.start(fb, col, row, src);
+        blit.finish();
+    } else if (_hdr->wid > 0) {
+        const TextSource src(reinterpret_cast<const TextImageHdr *>(_hdr),
+                             _pal);
+        blit.start(fb, col, row, src);
+        blit.finish();
+    }
+}
+
+
+void GuiImage::rows(int row, int cnt, GuiPixel *dst) const
+{
+    assert(0 <= row && row + cnt <= _hdr->hgt);
+    if (cnt <= 0)
+        return;
+    if (_format == Format::raw) {
+        const GuiPixel *src = image_pixels<GuiPixel>(_hdr) + row * _hdr->wid;
+        for (int i = 0; i < _hdr->wid * cnt; i++)
+            dst[i] = src[i];
+    } else if (_format == Format::rle) {
+        RleSource src(reinterpret_cast<const RleImageHdr *>(_hdr));
+        src.skip(row);
+        src.rows(row, cnt, dst);
+    } else if (_format == Format::mask) {
+        const MaskSource src(reinterpret_cast<const MaskImageHdr *>(_hdr),
+                             _pal);
+        src.rows(row, cnt, dst);
+    } else if (_hdr->wid > 0) {
+        const TextSource src(reinterpret_cast<const TextImageHdr *>(_hdr),
+                             _pal);
+        src.rows(row, cnt, dst);
+    }
+}
@@ -0,0 +1,179 @@
+
+#include <cstdint>
+#include <cstdio>
+// pico
+#include "pico/stdlib.h"
+// touchscreen
+#include "touchscreen.h"
+// gui
+#include "gui_latency.h"
+
+using Event = Touchscreen::Event;
+
+GuiLatency *GuiLatency::probe = nullptr;
+
+
+int GuiLatency::Hist::bin(uint32_t us)
+{
+    if (us < uint32_t(sub_bins))
+        return int(us);
+    // p is the power of two at or below us (p >= 3)
+    int p = 31;
+    while ((us & (uint32_t(1) << p)) == 0)
+        p--;
+    const int b = (p - 2) * sub_bins + int((us >> (p - 3)) & (sub_bins - 1));
+    return b < bins ? b : bins - 1;
+}
+
+
+uint32_t GuiLatency::Hist::bin_us(int b)
+{
+    if (b < sub_bins)
+        return uint32_t(b);
+    const int p = b / sub_bins + 2;
+    return uint32_t(sub_bins + b % sub_bins) << (p - 3);
+}
+
+
+void GuiLatency::Hist::add(uint32_t us)
+{
+    _bins[bin(us)]++;
+    _cnt++;
+    if (us > _max)
+        _max = us;
+}
+
+
+void GuiLatency::Hist::reset()
+{
+    for (uint32_t &b : _bins)
+        b = 0;
+    _cnt = 0;
+    _max = 0;
+}
+
+
+uint32_t GuiLatency::Hist::percentile(int pct) const
+{
+    if (_cnt == 0)
+        return 0;
+    // the sample at or above pct% of them
+    const uint32_t rank = uint32_t((uint64_t(_cnt) * pct + 99) / 100);
+    uint32_t seen = 0;
+    for (int b = 0; b < bins; b++) {
+        seen += _bins[b];
+        if (seen >= rank && seen > 0) {
+            const uint32_t top = b + 1 < bins ? bin_us(b + 1) - 1 : _max;
+            return top < _max ? top : _max;
+        }
+    }
+    return _max;
+}
+
+
+GuiLatency::GuiLatency() :
+    _queue_us{},
+    _queue_head(0),
+    _queue_cnt(0),
+    _stage(Stage::idle),
+    _button(nullptr),
+    _captured_us(0),
+    _dispatched_us(0),
+    _draw_us(0),
+    _abandoned(0)
+{
+}
+
+
+void GuiLatency::reset()
+{
+    _queue_cnt = 0;
+    _stage = Stage::idle;
+    _button = nullptr;
+    _queued.reset();
+    _handled.reset();
+    _drawn.reset();
+    _total.reset();
+    _abandoned = 0;
+}
+
+
+void GuiLatency::on_captured(const Event &event, uint64_t us)
+{
+    if (event.type != Event::Type::down)
+        return;
+    if (_queue_cnt == max_queued) {
+        _abandoned++;
+        return;
+    }
+    _queue_us[(_queue_head + _queue_cnt++) % max_queued] = us;
+}
+
+
+void GuiLatency::on_dispatched(const Event &event)
+{
+    if (event.type != Event::Type::down || _queue_cnt == 0)
+        return;
+    if (_stage != Stage::idle)
+        _abandoned++;
+    _captured_us = _queue_us[_queue_head];
+    _queue_head = (_queue_head + 1) % max_queued;
+    _queue_cnt--;
+    _stage = Stage::dispatched;
+    _button = nullptr;
+    _dispatched_us = time_us_64();
+}
+
+
+void GuiLatency::on_pressed(const GuiWidget *button)
+{
+    if (_stage == Stage::dispatched && _button == nullptr)
+        _button = button;
+}
+
+
+void GuiLatency::on_draw_start(const GuiWidget *button)
+{
+    if (_stage != Stage::dispatched || button != _button)
+        return;
+    _stage = Stage::drawing;
+    _draw_us = time_us_64();
+}
+
+
+void GuiLatency::on_draw_end(const GuiWidget *button)
+{
+    if (_stage != Stage::drawing || button != _button)
+        return;
+    const uint64_t now = time_us_64();
+    _queued.add(uint32_t(_dispatched_us - _captured_us));
+    _handled.add(uint32_t(_draw_us - _dispatched_us));
+    _drawn.add(uint32_t(now - _draw_us));
+    _total.add(uint32_t(now - _captured_us));
+    _stage = Stage::idle;
+    _button = nullptr;
+}
+
+
+void GuiLatency::print() const
+{
+    static const struct {
+        const char *name;
+        const Hist GuiLatency::*hist;
+    } stages[] = {
+        {"queued", &GuiLatency::_queued},
+        {"handled", &GuiLatency::_handled},
+        {"drawn", &GuiLatency::_drawn},
+        {"total", &GuiLatency::_total},
+    };
+
+    printf("%lu presses (%lu abandoned)\n", (unsigned long)_total.count(),
+           (unsigned long)_abandoned);
+    printf("%-8s %8s %8s %8s\n", "us", "p50", "p99", "max");
+    for (const auto &s : stages) {
+        const Hist &h = this->*s.hist;
+        printf("%-8s %8lu %8lu %8lu\n", s.name,
+               (unsigned long)h.percentile(50), (unsigned long)h.percentile(99),
+               (unsigned long)h.max());
+    }
+}
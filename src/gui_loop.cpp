@@ -0,0 +1,275 @@
+
+#include <cassert>
+#include <cstdint>
+// pico
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+// framebuffer
+#include "framebuffer.h"
+// touchscreen
+#include "touchscreen.h"
+// gui
+#include "gui_event_queue.h"
+#include "gui_latency.h"
+#include "gui_loop.h"
+#include "gui_page_base.h"
+#include "gui_stats.h"
+#include "gui_touch_input.h"
+#include "gui_widget.h"
+
+using Event = Touchscreen::Event;
+
+
+GuiLoop::GuiLoop(Touchscreen &ts) :
+    _ts(ts),
+    _input(nullptr),
+    _events(),
+    _page(nullptr),
+    _bar(nullptr),
+    _tasks{},
+    _page_task(-1),
+    _frame_budget_us(0),
+    _stop(false),
+    _wake_bound_us(0),
+    _step_us{},
+    _window_us(0),
+    _dim_fb(nullptr),
+    _dim_after_us(0),
+    _dim_pct(0),
+    _on_pct(100),
+    _dimmed(false),
+    _touch_us(0),
+    _stats{}
+{
+}
+
+
+GuiLoop::GuiLoop(GuiTouchInput &ts) : GuiLoop(static_cast<Touchscreen &>(ts))
+{
+    _input = &ts;
+}
+
+
+int GuiLoop::every(uint32_t period_us, void (*func)(intptr_t), intptr_t arg)
+{
+    assert(func != nullptr && period_us > 0);
+    for (int i = 0; i < max_tasks; i++) {
+        Task &t = _tasks[i];
+        if (t.func == nullptr) {
+            t = Task{func, arg, period_us, time_us_64() + period_us, 0, 0};
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+void GuiLoop::cancel(int task)
+{
+    assert(0 <= task && task < max_tasks);
+    _tasks[task].func = nullptr;
+}
+
+
+void GuiLoop::page_update(intptr_t arg)
+{
+    GuiLoop *loop = reinterpret_cast<GuiLoop *>(arg);
+    if (loop->_page != nullptr)
+        loop->_page->update();
+}
+
+
+void GuiLoop::page_updates(uint32_t period_us)
+{
+    if (_page_task >= 0)
+        cancel(_page_task);
+    _page_task = -1;
+    if (period_us > 0)
+        _page_task = every(period_us, page_update, intptr_t(this));
+}
+
+
+void GuiLoop::dispatch(Event &event)
+{
+    GuiStats::event_start();
+    GuiLatency::dispatched(event);
+    GuiWidget *f = GuiWidget::focus;
+    if (f != nullptr) {
+        if (f->event(event))
+            f->claimed();
+    } else if (_bar == nullptr || !_bar->event(event)) {
+        if (_page != nullptr)
+            _page->event(event);
+    }
+}
+
+
+void GuiLoop::flush()
+{
+    if (_bar != nullptr)
+        _bar->flush();
+    if (_page != nullptr)
+        _page->flush();
+}
+
+
+// Run the due task with the earliest deadline, if any.
+bool GuiLoop::run_task()
+{
+    const uint64_t now = time_us_64();
+    Task *next = nullptr;
+    for (Task &t : _tasks)
+        if (t.func != nullptr && t.deadline_us <= now &&
+            (next == nullptr || t.deadline_us < next->deadline_us))
+            next = &t;
+    if (next == nullptr)
+        return false;
+
+    // deadlines passed while it waited
+    const uint32_t late = uint32_t((now - next->deadline_us) / next->period_us);
+    next->missed += late;
+    _stats.missed += late;
+    next->deadline_us += uint64_t(late + 1) * next->period_us;
+
+    next->runs++;
+    _stats.task_runs++;
+    next->func(next->arg);
+    return true;
+}
+
+
+// Longest step in this window and the one before, starting a new window
+// if this one is over.
+uint32_t GuiLoop::recent_step_us(uint64_t now)
+{
+    if (now - _window_us >= step_window_us) {
+        const bool last = now - _window_us < 2 * uint64_t(step_window_us);
+        _step_us[1] = last ? _step_us[0] : 0;
+        _step_us[0] = 0;
+        _window_us = now;
+    }
+    return _step_us[0] > _step_us[1] ? _step_us[0] : _step_us[1];
+}
+
+
+void GuiLoop::stepped(uint64_t start, uint64_t end)
+{
+    recent_step_us(end);
+    if (end - start > _step_us[0])
+        _step_us[0] = uint32_t(end - start);
+}
+
+
+bool GuiLoop::step()
+{
+    const uint64_t start = time_us_64();
+    if (_input != nullptr)
+        _events.poll(*_input);
+    else
+        _events.poll(_ts);
+
+    if (!_events.empty()) {
+        if (_dimmed) {
+            _dim_fb->brightness(_on_pct);
+            _dimmed = false;
+        }
+
+        const uint64_t dispatch_start = time_us_64();
+        Event event;
+        while (_events.pop(event))
+            dispatch(event);
+        const uint64_t draw_start = time_us_64();
+        flush();
+        const uint64_t end = time_us_64();
+        _touch_us = end;
+
+        _stats.dispatch_us += draw_start - dispatch_start;
+        _stats.draw_us += end - draw_start;
+        const uint32_t us = uint32_t(end - dispatch_start);
+        _stats.frames++;
+        if (us > _stats.worst_frame_us)
+            _stats.worst_frame_us = us;
+        if (_frame_budget_us != 0 && us > _frame_budget_us)
+            _stats.overruns++;
+        stepped(start, end);
+        return true;
+    }
+
+    const uint64_t task_start = time_us_64();
+    if (run_task()) {
+        const uint64_t draw_start = time_us_64();
+        flush();
+        const uint64_t end = time_us_64();
+        _stats.task_us += draw_start - task_start;
+        _stats.draw_us += end - draw_start;
+        stepped(start, end);
+        return true;
+    }
+
+    if (_dim_fb != nullptr && !_dimmed &&
+        task_start - _touch_us >= _dim_after_us) {
+        _dim_fb->brightness(_dim_pct);
+        _dimmed = true;
+        return true;
+    }
+
+    return false;
+}
+
+
+void GuiLoop::dim(Framebuffer *fb, uint32_t after_us, int dim_pct,
+                  int on_pct)
+{
+    if (_dimmed && fb != _dim_fb)
+        _dim_fb->brightness(_on_pct);
+    _dim_fb = fb;
+    _dim_after_us = after_us;
+    _dim_pct = dim_pct;
+    _on_pct = on_pct;
+    _dimmed = false;
+    _touch_us = time_us_64();
+}
+
+
+void GuiLoop::wake()
+{
+    __sev();
+}
+
+
+// Wait for an interrupt, a task's deadline or the dimming time. Touches
+// on a polled touchscreen only wake the loop when the sleep ends, so then
+// it ends in time to handle one within the wake bound, or is skipped if a
+// recent step was that long.
+void GuiLoop::sleep()
+{
+    const uint64_t now = time_us_64();
+    uint64_t until = now + _wake_bound_us;
+    if (_input == nullptr) {
+        const uint32_t step_us = recent_step_us(now);
+        if (_wake_bound_us <= step_us)
+            return;
+        until -= step_us;
+    }
+    for (const Task &t : _tasks)
+        if (t.func != nullptr && t.deadline_us < until)
+            until = t.deadline_us;
+    if (_dim_fb != nullptr && !_dimmed && _touch_us + _dim_after_us < until)
+        until = _touch_us + _dim_after_us;
+    if (until <= now)
+        return;
+
+    best_effort_wfe_or_timeout(from_us_since_boot(until));
+    _stats.idle_us += time_us_64() - now;
+    _stats.sleeps++;
+}
+
+
+void GuiLoop::run()
+{
+    _stop = false;
+    while (!_stop)
+        if (!step() && _wake_bound_us != 0)
+            sleep();
+    _stop = false;
+}
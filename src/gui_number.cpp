@@ -0,0 +1,164 @@
+
+#include <cassert>
+#include <climits>
+// pico
+#include "pico/stdlib.h"
+// framebuffer
+#include "framebuffer.h"
+// gui
+#include "gui_image.h"
+#include "gui_number.h"
+#include "gui_widget.h"
+
+using HAlign = Framebuffer::HAlign;
+
+
+int GuiNumber::layout(const PixelImageHdr *img[max_digits], int &wid,
+                      int &hgt) const
+{
+    assert(_num >= 0);
+
+    int digits[max_digits];
+    int cnt = 0;
+    int n = _num;
+    do {
+        digits[cnt++] = n % 10;
+        n /= 10;
+    } while (n > 0);
+
+    wid = 0;
+    hgt = 0;
+    for (int i = 0; i < cnt; i++) {
+        const int d = digits[cnt - 1 - i];
+        img[i] = _dig_mask == nullptr ? _dig[d] : &_dig_mask[d]->hdr;
+        wid += img[i]->wid;
+        if (img[i]->hgt > hgt)
+            hgt = img[i]->hgt;
+    }
+    return cnt;
+}
+
+
+GuiImage GuiNumber::image(const PixelImageHdr *dig) const
+{
+    if (_dig_mask == nullptr)
+        return GuiImage(dig);
+    // layout() gave the hdr member, which is first in the MaskImageHdr
+    return GuiImage(reinterpret_cast<const MaskImageHdr *>(dig), palette());
+}
+
+
+// Rendering starts at:
+//   _col_ref for left alignment,
+//   _col_ref - (wid / 2) for center alignment, or
+//   _col_ref - wid for right alignment.
+int GuiNumber::align_col(int wid) const
+{
+    if (_h_align == HAlign::Center)
+        return _col_ref - wid / 2;
+    else if (_h_align == HAlign::Right)
+        return _col_ref - wid;
+    else
+        return _col_ref;
+}
+
+
+void GuiNumber::draw()
+{
+    if (!_visible || _num == unset)
+        return;
+
+    const PixelImageHdr *img[max_digits];
+    int wid, hgt;
+    const int cnt = layout(img, wid, hgt);
+    const int col = align_col(wid);
+
+    int c = col;
+    for (int i = 0; i < cnt; i++) {
+        write(c, _row, image(img[i]));
+        _drawn[i] = img[i];
+        c += img[i]->wid;
+    }
+    _drawn_cnt = cnt;
+    _drawn_pal = palette();
+
+    if (_col != col || _wid != wid || _hgt != hgt) {
+        _col = col;
+        _wid = wid;
+        _hgt = hgt;
+        bounds_changed();
+    }
+}
+
+
+void GuiNumber::refresh()
+{
+    if (!_visible || _num == unset)
+        return;
+
+    if (_drawn_cnt == 0) {
+        draw();
+        return;
+    }
+
+    const PixelImageHdr *img[max_digits];
+    int wid, hgt;
+    const int cnt = layout(img, wid, hgt);
+    const int col = align_col(wid);
+
+    // Walk the old and new digits left to right together, by column. A new
+    // digit is skipped if the same image starts at the same column (and
+    // enabling or disabling has not changed the colors).
+    const bool recolor = _drawn_pal != palette();
+    int c = col;   // column of new digit i
+    int o = 0;     // old digit index
+    int oc = _col; // column of old digit o
+    for (int i = 0; i < cnt; i++) {
+        while (o < _drawn_cnt && oc < c)
+            oc += _drawn[o++]->wid;
+        if (recolor || !(o < _drawn_cnt && oc == c && _drawn[o] == img[i]))
+            write(c, _row, image(img[i]));
+        c += img[i]->wid;
+    }
+    for (int i = 0; i < cnt; i++)
+        _drawn[i] = img[i];
+    _drawn_cnt = cnt;
+    _drawn_pal = palette();
+
+    // erase what the old number covered outside the new one
+    const int old_end = _col + _wid;
+    const int new_end = col + wid;
+    if (_col < col) {
+        int end = old_end < col ? old_end : col;
+        erase_rect(_col, _row, end - _col, _hgt);
+    }
+    if (old_end > new_end) {
+        int start = _col > new_end ? _col : new_end;
+        erase_rect(start, _row, old_end - start, _hgt);
+    }
+
+    if (_col != col || _wid != wid || _hgt != hgt) {
+        _col = col;
+        _wid = wid;
+        _hgt = hgt;
+        bounds_changed();
+    }
+}
+
+
+void GuiNumber::erase()
+{
+    GuiWidget::erase();
+    erased();
+}
+
+
+void GuiNumber::move(int col, int row)
+{
+    if (col == _col && row == _row)
+        return;
+    // the digits drawn at the old place are not at the new one
+    erased();
+    _col_ref += col - _col;
+    GuiWidget::move(col, row);
+}
@@ -1,11 +1,18 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
 #include <initializer_list>
 // pico
 #include "pico/stdlib.h"
 // gui
+#include "gui_background.h"
+#include "gui_compositor.h"
+#include "gui_display_list.h"
+#include "gui_latency.h"
 #include "gui_page.h"
+#include "gui_rect.h"
+#include "gui_stats.h"
 #include "gui_widget.h"
 
 
@@ -16,29 +23,356 @@ GuiPage::GuiPage(std::initializer_list<GuiWidget *> widgets,
     _visible(false),
     _busy(0),
     _on_update(on_update),
-    _on_update_arg(on_update_arg)
+    _on_update_arg(on_update_arg),
+    _damage{},
+    _damage_cnt(0),
+    _damage_all(false),
+    _deferred(false),
+    _grid{},
+    _grid_rect{0, 0, 0, 0},
+    _cell_col_shift(0),
+    _cell_row_shift(0),
+    _grid_stale(true),
+    _indexed(true),
+    _covered(0),
+    _covered_stale(true),
+    _list(nullptr),
+    _list_stale(0),
+    _compositor(nullptr)
 {
+    static_assert(max_widgets <= 32, "widget masks are 32 bits");
     assert(widgets.size() <= max_widgets);
-    for (GuiWidget *w : widgets)
+    for (GuiWidget *w : widgets) {
+        w->_page = this;
         _widgets[_widget_cnt++] = w;
+    }
 }
 
 
 void GuiPage::visible(bool v)
 {
     _visible = v;
-    if (_visible)
+    if (_visible) {
+        // everything gets drawn; nothing pending matters
+        clear_damage();
         draw();
-    else
+    } else {
+        // pending damage might extend past the widgets' current areas
+        erase_damage();
+        clear_damage();
         erase();
+    }
+}
+
+
+int GuiPage::widgets(GuiWidget *out[], int max)
+{
+    int cnt = 0;
+    for (size_t i = 0; i < _widget_cnt && cnt < max; i++)
+        out[cnt++] = _widgets[i];
+    return cnt;
+}
+
+
+void GuiPage::swapped_out()
+{
+    _visible = false;
+    erase_damage();
+    clear_damage();
+}
+
+
+void GuiPage::deferred(bool d)
+{
+    if (_deferred && !d)
+        flush();
+    _deferred = d;
+}
+
+
+void GuiPage::display_list(GuiDisplayList *list)
+{
+    _list = list;
+    if (_list != nullptr) {
+        _list->clear();
+        _list_stale = ~uint32_t(0);
+    }
 }
 
 
-void GuiPage::draw() const
+void GuiPage::changed(const GuiWidget *widget)
 {
-    if (_visible)
-        for (size_t i = 0; i < _widget_cnt; i++)
+    if (_list == nullptr)
+        return;
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        if (_widgets[i] == widget) {
+            _list_stale |= uint32_t(1) << i;
+            return;
+        }
+    }
+}
+
+
+// Record the stale widgets into the display list. Recording is not drawing,
+// so the latency probe does not see it.
+void GuiPage::record()
+{
+    GuiCanvas *const canvas = GuiWidget::canvas;
+    GuiWidget::canvas = _list;
+    GuiLatency *const probe = GuiLatency::probe;
+    GuiLatency::probe = nullptr;
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        if ((_list_stale & (uint32_t(1) << i)) != 0) {
+            _list->begin(i);
+#if GUI_STATS
+            // recording sends nothing; the pixels count when replayed
+            const uint64_t pixels = _widgets[i]->_stats.pixels;
+            _widgets[i]->draw();
+            _widgets[i]->_stats.pixels = pixels;
+#else
             _widgets[i]->draw();
+#endif
+        }
+    }
+    _list->end();
+    GuiLatency::probe = probe;
+    GuiWidget::canvas = canvas;
+    _list_stale = 0;
+}
+
+
+void GuiPage::draw()
+{
+    if (!_visible)
+        return;
+    if (_compositor != nullptr && compose())
+        return;
+    draw_widgets(nullptr);
+}
+
+
+// Draw (or replay) the widgets not covered, or with a band, just those that
+// reach into it.
+void GuiPage::draw_widgets(const GuiRect *band)
+{
+    if (_list != nullptr) {
+        if (_list_stale != 0)
+            record();
+        if (!_list->overflow()) {
+            using Code = GuiDisplayList::Op::Code;
+            const uint32_t hidden = covered_mask();
+            uint32_t replayed = 0;
+            for (int i = 0; i < _list->size(); i++) {
+                const GuiDisplayList::Op &op = (*_list)[i];
+                if ((hidden & (uint32_t(1) << op.widget)) != 0)
+                    continue;
+                const GuiWidget *w = _widgets[op.widget];
+                if (band != nullptr && !band->intersects(w->rect()))
+                    continue;
+                replayed |= uint32_t(1) << op.widget;
+                switch (op.code) {
+                    case Code::fill_rect:
+                        w->fill_rect(op.a, op.b, op.c, op.d, op.color);
+                        break;
+                    case Code::draw_rect:
+                        w->draw_rect(op.a, op.b, op.c, op.d, op.color);
+                        break;
+                    case Code::line:
+                        w->line(op.a, op.b, op.c, op.d, op.color);
+                        break;
+                    case Code::write:
+                        w->write(op.a, op.b, op.img);
+                        break;
+                    case Code::restore:
+                        w->restore(*op.bg, op.a, op.b, op.c, op.d);
+                        break;
+                }
+            }
+            for (size_t i = 0; i < _widget_cnt; i++)
+                if ((replayed & (uint32_t(1) << i)) != 0)
+                    _widgets[i]->replayed();
+            return;
+        }
+        // didn't fit; draw the usual way
+    }
+
+    const uint32_t hidden = covered_mask();
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        if ((hidden & (uint32_t(1) << i)) != 0)
+            continue;
+        if (band != nullptr && !band->intersects(_widgets[i]->rect()))
+            continue;
+        GuiWidget::Timed timed(*_widgets[i]);
+        _widgets[i]->draw();
+    }
+}
+
+
+// Draw through the compositor, a band at a time. Each group of overlapping
+// widgets is composed only if its bands cost fewer bytes than drawing it
+// straight; otherwise (or if a row of it does not fit in a band) it is drawn
+// straight. False if nothing was composed (and nothing drawn).
+bool GuiPage::compose()
+{
+#if GUI_STATS
+    // widgets are drawn once per band; count what they cover, once
+    uint64_t pixels[max_widgets];
+    for (size_t i = 0; i < _widget_cnt; i++)
+        pixels[i] = _widgets[i]->_stats.pixels;
+#endif
+
+    GuiCanvas *const canvas = GuiWidget::canvas;
+    GuiWidget::canvas = _compositor;
+
+    // Drawing a widget into an empty band sends nothing, but measures what
+    // drawing it straight would send, and sets the size of one that does not
+    // know it until it is drawn (e.g. a GuiNumber). It is not a real draw, so
+    // the latency probe does not see it.
+    GuiLatency *const probe = GuiLatency::probe;
+    GuiLatency::probe = nullptr;
+    uint32_t direct[max_widgets];
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        GuiWidget *w = _widgets[i];
+        if (!w->_visible)
+            continue;
+        const uint32_t before = _compositor->direct_bytes();
+        _compositor->begin(w->_fb, 0, 0, 0, 0, w->_bg);
+        w->draw();
+        direct[i] = _compositor->direct_bytes() - before;
+#if GUI_STATS
+        w->_stats.pixels = pixels[i];
+#endif
+    }
+    GuiLatency::probe = probe;
+
+    // Widgets that overlap (directly or through others) are composed
+    // together; group[i] is the first widget in i's group, or -1 if i is
+    // not drawn.
+    const uint32_t hidden = covered_mask();
+    int group[max_widgets];
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        const GuiWidget *w = _widgets[i];
+        group[i] = -1;
+        if (!w->_visible || (hidden & (uint32_t(1) << i)) != 0 ||
+            w->rect().empty())
+            continue;
+        group[i] = int(i);
+        for (size_t j = 0; j < i; j++) {
+            if (group[j] < 0 || group[j] == group[i] ||
+                !_widgets[j]->rect().intersects(w->rect()))
+                continue;
+            const int from = group[i] > group[j] ? group[i] : group[j];
+            const int to = group[i] > group[j] ? group[j] : group[i];
+            for (size_t k = 0; k <= i; k++)
+                if (group[k] == from)
+                    group[k] = to;
+        }
+    }
+
+    // areas[i] is the bounding box of group i if it is composed, or empty if
+    // it is drawn straight
+    GuiRect areas[max_widgets];
+    bool any = false;
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        areas[i] = GuiRect{0, 0, 0, 0};
+        if (group[i] != int(i))
+            continue;
+        GuiRect area{0, 0, 0, 0};
+        uint32_t straight = 0;
+        for (size_t k = i; k < _widget_cnt; k++) {
+            if (group[k] == int(i)) {
+                area = area.bound(_widgets[k]->rect());
+                straight += direct[k];
+            }
+        }
+        const int rows = _compositor->band_rows(area.wid);
+        if (rows == 0)
+            continue;
+        uint32_t composed = 0;
+        GuiRect band;
+        for (int r = area.row; next_band(group, i, area, rows, r, band);)
+            composed += GuiCompositor::window_bytes(band.wid, band.hgt);
+        if (composed < straight) {
+            areas[i] = area;
+            any = true;
+        }
+    }
+    if (!any) {
+        GuiWidget::canvas = canvas;
+        return false;
+    }
+
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        if (group[i] != int(i))
+            continue;
+        GuiWidget *const bottom = _widgets[i];
+        const GuiRect &area = areas[i];
+        if (area.empty()) {
+            GuiWidget::canvas = canvas;
+            for (size_t k = i; k < _widget_cnt; k++) {
+                if (group[k] == int(i)) {
+                    GuiWidget::Timed timed(*_widgets[k]);
+                    _widgets[k]->draw();
+                }
+            }
+            GuiWidget::canvas = _compositor;
+            continue;
+        }
+
+        const GuiBackground::Source *src =
+            bottom->_background == nullptr ? nullptr
+                                           : &bottom->_background->source();
+        const int rows = _compositor->band_rows(area.wid);
+        GuiRect band;
+        for (int r = area.row; next_band(group, i, area, rows, r, band);) {
+            _compositor->begin(bottom->_fb, band.col, band.row, band.wid,
+                               band.hgt, bottom->_bg, src);
+            draw_widgets(&band);
+            _compositor->end();
+        }
+    }
+    GuiWidget::canvas = canvas;
+
+#if GUI_STATS
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        GuiWidget *w = _widgets[i];
+        if (group[i] < 0 || areas[group[i]].empty())
+            continue;
+        w->_stats.pixels = pixels[i];
+        w->count_pixels(w->_wid, w->_hgt);
+    }
+#endif
+    return true;
+}
+
+
+// The next band of group g (composed over area, up to rows high) at or below
+// row r: it starts at the next row a widget in the group covers, and is
+// trimmed to the group's widgets in it. r moves past it. False when there
+// are no more.
+bool GuiPage::next_band(const int group[], size_t g, const GuiRect &area,
+                        int rows, int &r, GuiRect &band) const
+{
+    const int area_end = area.row + area.hgt;
+    int top = area_end;
+    for (size_t k = g; k < _widget_cnt; k++) {
+        if (group[k] != int(g))
+            continue;
+        const GuiRect w = _widgets[k]->rect();
+        const int from = w.row > r ? w.row : r;
+        if (w.row + w.hgt > r && from < top)
+            top = from;
+    }
+    if (top >= area_end)
+        return false;
+    const GuiRect rows_rect{area.col, top, area.wid,
+                            top + rows < area_end ? rows : area_end - top};
+    band = GuiRect{0, 0, 0, 0};
+    for (size_t k = g; k < _widget_cnt; k++)
+        if (group[k] == int(g))
+            band = band.bound(rows_rect.intersect(_widgets[k]->rect()));
+    r = rows_rect.row + rows_rect.hgt;
+    return true;
 }
 
 
@@ -49,15 +383,385 @@ void GuiPage::erase() const
 }
 
 
+void GuiPage::background(GuiBackground *bg)
+{
+    for (size_t i = 0; i < _widget_cnt; i++)
+        _widgets[i]->background(bg);
+}
+
+
+void GuiPage::raise(GuiWidget *widget)
+{
+    size_t i = 0;
+    while (i < _widget_cnt && _widgets[i] != widget)
+        i++;
+    assert(i < _widget_cnt);
+
+    for (; i + 1 < _widget_cnt; i++)
+        _widgets[i] = _widgets[i + 1];
+    _widgets[i] = widget;
+
+    // widget indexes changed
+    _grid_stale = true;
+    _covered_stale = true;
+    if (_list != nullptr)
+        display_list(_list);
+
+    // nothing is above it now
+    if (_visible) {
+        GuiWidget::Timed timed(*widget);
+        widget->draw();
+    }
+}
+
+
+// Area of _widgets[i] not covered by visible widgets above it (only opaque
+// ones if opaque_only), or -1 if what is left is too fragmented to track.
+int GuiPage::exposed(size_t i, bool opaque_only) const
+{
+    static const int max_pieces = 16;
+    GuiRect pieces[max_pieces];
+    int cnt = 0;
+    if (!_widgets[i]->rect().empty())
+        pieces[cnt++] = _widgets[i]->rect();
+
+    for (size_t j = i + 1; j < _widget_cnt && cnt > 0; j++) {
+        const GuiWidget *above = _widgets[j];
+        if (!above->_visible || (opaque_only && !above->opaque()))
+            continue;
+        GuiRect left[max_pieces];
+        int left_cnt = 0;
+        for (int k = 0; k < cnt; k++) {
+            GuiRect out[4];
+            const int n = pieces[k].subtract(above->rect(), out);
+            if (left_cnt + n > max_pieces)
+                return -1;
+            for (int o = 0; o < n; o++)
+                left[left_cnt++] = out[o];
+        }
+        for (int k = 0; k < left_cnt; k++)
+            pieces[k] = left[k];
+        cnt = left_cnt;
+    }
+
+    int area = 0;
+    for (int k = 0; k < cnt; k++)
+        area += pieces[k].area();
+    return area;
+}
+
+
+uint32_t GuiPage::covered_mask()
+{
+    if (_covered_stale) {
+        _covered = 0;
+        // (a widget with an empty rectangle may not know its size yet)
+        for (size_t i = 0; i < _widget_cnt; i++) {
+            const GuiWidget *w = _widgets[i];
+            if (w->_visible && !w->rect().empty() && exposed(i, true) == 0)
+                _covered |= uint32_t(1) << i;
+        }
+        _covered_stale = false;
+    }
+    return _covered;
+}
+
+
+bool GuiPage::covered(const GuiWidget *widget)
+{
+    const uint32_t mask = covered_mask();
+    for (size_t i = 0; i < _widget_cnt; i++)
+        if (_widgets[i] == widget)
+            return (mask & (uint32_t(1) << i)) != 0;
+    return false;
+}
+
+
+// Draw the widgets in [first, end) that overlap anything in painted[0..cnt),
+// in order, adding what each paints. Returns the new count.
+size_t GuiPage::draw_over(size_t first, size_t end, GuiRect painted[],
+                          size_t cnt)
+{
+    const uint32_t hidden = covered_mask();
+    for (size_t i = first; i < end; i++) {
+        GuiWidget *w = _widgets[i];
+        if (!w->_visible || (hidden & (uint32_t(1) << i)) != 0)
+            continue;
+        bool over = false;
+        for (size_t p = 0; p < cnt && !over; p++)
+            over = painted[p].intersects(w->rect());
+        if (!over)
+            continue;
+        GuiWidget::Timed timed(*w);
+        w->draw();
+        painted[cnt++] = w->rect();
+    }
+    return cnt;
+}
+
+
+// _widgets[i] erased 'rect' to background: draw the widgets below it that
+// overlap it (and those above them they overlap), then, if self, the widget
+// itself if they painted over it. Returns the count in painted, which
+// starts with rect.
+size_t GuiPage::draw_under(size_t i, const GuiRect &rect, bool self,
+                           GuiRect painted[])
+{
+    painted[0] = rect;
+    const size_t cnt = draw_over(0, i, painted, 1);
+    if (!self || cnt == 1)
+        return cnt;
+    return draw_over(i, i + 1, painted + 1, cnt - 1) + 1;
+}
+
+
+// A widget painted 'rect' (refreshed or erased) in immediate mode: draw
+// again, in order, the widgets above it that overlap it, and any above
+// them they overlap. If rect was erased to background (below), the widgets
+// under it are drawn first (see draw_under()).
+void GuiPage::redraw(const GuiWidget *widget, const GuiRect &rect, bool below,
+                     bool self)
+{
+    if (!_visible)
+        return;
+    size_t i = 0;
+    while (i < _widget_cnt && _widgets[i] != widget)
+        i++;
+    GuiRect painted[max_widgets + 1];
+    size_t cnt = 1;
+    painted[0] = rect;
+    if (below)
+        cnt = draw_under(i, rect, self, painted);
+    draw_over(i + 1, _widget_cnt, painted, cnt);
+}
+
+
+GuiPage::Overdraw GuiPage::overdraw() const
+{
+    Overdraw od{0, 0};
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        const GuiWidget *w = _widgets[i];
+        if (!w->_visible)
+            continue;
+        if (exposed(i, true) != 0)
+            od.painted += w->rect().area();
+        // too fragmented: count it all, overstating what is visible
+        const int e = exposed(i, false);
+        od.visible += e < 0 ? w->rect().area() : e;
+    }
+    return od;
+}
+
+
 bool GuiPage::event(Touchscreen::Event &event)
 {
     if (!_visible)
         return false;
 
-    for (size_t i = 0; i < _widget_cnt; i++) {
-        if (_widgets[i]->event(event))
-            return true;
+    GuiStats::event_start();
+
+    // A widget with focus wants events wherever they are
+    GuiWidget *f = GuiWidget::focus;
+    if (f != nullptr && f->_page == this && f->event(event)) {
+        f->claimed();
+        return true;
     }
 
+    if (!_indexed)
+        return offer(event, ~uint32_t(0), f);
+
+    if (_grid_stale)
+        build_index();
+
+    const int c = event.col - _grid_rect.col;
+    const int r = event.row - _grid_rect.row;
+    if (c < 0 || c >= _grid_rect.wid || r < 0 || r >= _grid_rect.hgt)
+        return false;
+
+    return offer(event, _grid[(r >> _cell_row_shift) * grid_cols +
+                              (c >> _cell_col_shift)],
+                 f);
+}
+
+
+// Offer the event to the widgets in mask (except skip), top-down, until one
+// claims it or it lands on an opaque widget.
+bool GuiPage::offer(Touchscreen::Event &event, uint32_t mask,
+                    const GuiWidget *skip)
+{
+    for (int i = int(_widget_cnt) - 1; i >= 0; i--) {
+        GuiWidget *w = _widgets[i];
+        if ((mask & (uint32_t(1) << i)) == 0 || w == skip)
+            continue;
+        if (w->interactive() && w->event(event)) {
+            w->claimed();
+            return true;
+        }
+        if (w->_visible && w->opaque() && w->contains(event.col, event.row))
+            return false;
+    }
     return false;
 }
+
+
+void GuiPage::reindex(const GuiWidget *widget)
+{
+    if (widget->interactive() || widget->opaque())
+        _grid_stale = true;
+    _covered_stale = true;
+}
+
+
+// smallest shift such that (len >> shift) < cells
+static int cell_shift(int len, int cells)
+{
+    int shift = 0;
+    while ((len >> shift) >= cells)
+        shift++;
+    return shift;
+}
+
+
+void GuiPage::build_index()
+{
+    _grid.fill(0);
+    _grid_rect = GuiRect{0, 0, 0, 0};
+
+    // bounding box of everything that can claim or block an event
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        const GuiWidget *w = _widgets[i];
+        if (w->interactive() || w->opaque())
+            _grid_rect = _grid_rect.bound(w->rect());
+    }
+
+    _cell_col_shift = cell_shift(_grid_rect.wid - 1, grid_cols);
+    _cell_row_shift = cell_shift(_grid_rect.hgt - 1, grid_rows);
+
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        const GuiWidget *w = _widgets[i];
+        if (!(w->interactive() || w->opaque()) || w->rect().empty())
+            continue;
+        const GuiRect r = w->rect();
+        const int c0 = (r.col - _grid_rect.col) >> _cell_col_shift;
+        const int c1 = (r.col + r.wid - 1 - _grid_rect.col) >> _cell_col_shift;
+        const int r0 = (r.row - _grid_rect.row) >> _cell_row_shift;
+        const int r1 = (r.row + r.hgt - 1 - _grid_rect.row) >> _cell_row_shift;
+        for (int gr = r0; gr <= r1; gr++)
+            for (int gc = c0; gc <= c1; gc++)
+                _grid[gr * grid_cols + gc] |= uint32_t(1) << i;
+    }
+
+    _grid_stale = false;
+}
+
+
+void GuiPage::damage(GuiWidget *widget, const GuiRect &rect)
+{
+    if (!widget->_visible || rect.empty())
+        return;
+
+    if (!_damage_all) {
+        // merge with an existing area from the same widget if possible
+        for (size_t i = 0; i < _damage_cnt; i++) {
+            if (_damage[i].widget == widget && _damage[i].rect.merge(rect))
+                return;
+        }
+        if (_damage_cnt < max_damage) {
+            _damage[_damage_cnt++] = Damage{widget, rect};
+            return;
+        }
+        // Out of room: erase what we have now and redraw the whole page on
+        // the next flush().
+        erase_damage();
+        _damage_cnt = 0;
+        _damage_all = true;
+    }
+
+    widget->erase_rect(rect.col, rect.row, rect.wid, rect.hgt);
+}
+
+
+void GuiPage::erase_damage()
+{
+    for (size_t i = 0; i < _damage_cnt; i++) {
+        const GuiWidget *w = _damage[i].widget;
+        const GuiRect &r = _damage[i].rect;
+        w->erase_rect(r.col, r.row, r.wid, r.hgt);
+    }
+}
+
+
+void GuiPage::clear_damage()
+{
+    _damage_cnt = 0;
+    _damage_all = false;
+    for (size_t i = 0; i < _widget_cnt; i++)
+        _widgets[i]->_dirty = false;
+}
+
+
+void GuiPage::flush()
+{
+    if (!_visible) {
+        // It all gets drawn when the page is shown. Widgets stay dirty until
+        // then: their bounds may be out of date (see GuiPageBase::swap()).
+        _damage_cnt = 0;
+        _damage_all = false;
+        return;
+    }
+
+    if (_damage_all) {
+        // damaged areas have already been erased
+        clear_damage();
+        draw();
+        return;
+    }
+
+    erase_damage();
+
+    // Each widget is drawn at most once, bottom to top. One overlapping an
+    // erased area, or an area a widget below it painted, needs a full draw;
+    // one that is only invalidated can just refresh. Covered widgets are not
+    // drawn at all.
+    const uint32_t hidden = covered_mask();
+    GuiRect painted[2 * max_widgets + 1];
+    size_t painted_cnt = 0;
+    for (size_t i = 0; i < _widget_cnt; i++) {
+        GuiWidget *w = _widgets[i];
+        if ((hidden & (uint32_t(1) << i)) != 0) {
+            w->_dirty = false;
+            continue;
+        }
+        bool erased = false;
+        for (size_t d = 0; d < _damage_cnt && !erased; d++)
+            erased = _damage[d].rect.intersects(w->rect());
+        for (size_t p = 0; p < painted_cnt && !erased; p++)
+            erased = painted[p].intersects(w->rect());
+        const GuiRect before = w->rect();
+        if (erased) {
+            GuiWidget::Timed timed(*w);
+            // a changed widget refreshes first so it erases what it no
+            // longer covers, then draws over the erased area
+            if (w->_dirty)
+                w->refresh();
+            w->draw();
+        } else if (w->_dirty) {
+            GuiWidget::Timed timed(*w);
+            w->refresh();
+        }
+        if (w->_visible && (erased || w->_dirty)) {
+            const GuiRect area = before.bound(w->rect());
+            if (before != w->rect()) {
+                // it erased what it no longer covers, over widgets below
+                GuiRect under[max_widgets + 1];
+                const size_t cnt = draw_under(i, area, true, under);
+                for (size_t u = 1; u < cnt; u++)
+                    painted[painted_cnt++] = under[u];
+            }
+            painted[painted_cnt++] = area;
+        }
+        w->_dirty = false;
+    }
+
+    _damage_cnt = 0;
+}
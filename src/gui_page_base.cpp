@@ -0,0 +1,87 @@
+
+#include <cstdint>
+// gui
+#include "gui_page_base.h"
+#include "gui_rect.h"
+#include "gui_widget.h"
+
+static const int max_pieces = 16;
+
+
+// Take r out of pieces[0..cnt). False if what is left is too fragmented to
+// track (pieces is then left alone).
+static bool cut(GuiRect pieces[max_pieces], int &cnt, const GuiRect &r)
+{
+    GuiRect left[max_pieces];
+    int left_cnt = 0;
+    for (int k = 0; k < cnt; k++) {
+        GuiRect out[4];
+        const int n = pieces[k].subtract(r, out);
+        if (left_cnt + n > max_pieces)
+            return false;
+        for (int o = 0; o < n; o++)
+            left[left_cnt++] = out[o];
+    }
+    for (int k = 0; k < left_cnt; k++)
+        pieces[k] = left[k];
+    cnt = left_cnt;
+    return true;
+}
+
+
+GuiPageBase::Swap GuiPageBase::swap(GuiPageBase &from, GuiPageBase &to)
+{
+    static const int max_widgets = 32;
+    GuiWidget *old_w[max_widgets];
+    GuiWidget *new_w[max_widgets];
+    const int old_cnt = from.widgets(old_w, max_widgets);
+    const int new_cnt = to.widgets(new_w, max_widgets);
+    if (old_cnt < 0 || new_cnt < 0) {
+        from.visible(false);
+        to.visible(true);
+        return Swap{0, 0};
+    }
+
+    from.swapped_out();
+
+    uint32_t erase_all = 0; // what erasing the old page would fill
+    Swap s{0, 0};
+    for (int i = 0; i < old_cnt; i++) {
+        GuiWidget *w = old_w[i];
+        if (!w->_visible || w->rect().empty())
+            continue;
+        erase_all += w->rect().area();
+
+        // Leave out what the new page's opaque widgets paint anyway, and
+        // what a later old widget erases to its own background (as erasing
+        // the old page widget by widget would). A widget that changed since
+        // it was last drawn may not cover its rect() any more, so it does
+        // not count. If that gets too fragmented, erase the whole widget.
+        GuiRect pieces[max_pieces] = {w->rect()};
+        int cnt = 1;
+        bool ok = true;
+        for (int j = 0; j < new_cnt && ok && cnt > 0; j++) {
+            const GuiWidget *n = new_w[j];
+            if (n->_visible && n->opaque() && !n->_dirty)
+                ok = cut(pieces, cnt, n->rect());
+        }
+        for (int j = i + 1; j < old_cnt && ok && cnt > 0; j++)
+            if (old_w[j]->_visible)
+                ok = cut(pieces, cnt, old_w[j]->rect());
+        if (!ok) {
+            pieces[0] = w->rect();
+            cnt = 1;
+        }
+
+        for (int k = 0; k < cnt; k++) {
+            const GuiRect &p = pieces[k];
+            w->erase_rect(p.col, p.row, p.wid, p.hgt);
+            s.erased += p.area();
+        }
+        w->erased();
+    }
+    s.saved = erase_all - s.erased;
+
+    to.visible(true);
+    return s;
+}
@@ -0,0 +1,140 @@
+
+#include <atomic>
+#include <cstdint>
+// pico
+#include "pico/stdlib.h"
+// framebuffer
+#include "color.h"
+#include "framebuffer.h"
+#include "pixel_image.h"
+// gui
+#include "gui_background.h"
+#include "gui_image.h"
+#include "gui_render_queue.h"
+
+using Op = GuiRenderQueue::Cmd::Op;
+
+
+GuiRenderQueue::GuiRenderQueue() :
+    _ring{},
+    _head(0),
+    _tail(0),
+    _stop(false),
+    _full_waits(0)
+{
+    static_assert((capacity & (capacity - 1)) == 0, "capacity: power of 2");
+}
+
+
+void GuiRenderQueue::push(const Cmd &cmd)
+{
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+
+    if ((head - _tail.load(std::memory_order_acquire)) == capacity) {
+        _full_waits++;
+        while ((head - _tail.load(std::memory_order_acquire)) == capacity)
+            tight_loop_contents();
+    }
+
+    _ring[head & (capacity - 1)] = cmd;
+
+    // publish the command
+    _head.store(head + 1, std::memory_order_release);
+}
+
+
+void GuiRenderQueue::fill_rect(Framebuffer &fb, int col, int row, int wid,
+                               int hgt, Color c)
+{
+    push(Cmd{Op::fill_rect, int16_t(col), int16_t(row), int16_t(wid),
+             int16_t(hgt), c, GuiImage(), nullptr, &fb});
+}
+
+
+void GuiRenderQueue::draw_rect(Framebuffer &fb, int col, int row, int wid,
+                               int hgt, Color c)
+{
+    push(Cmd{Op::draw_rect, int16_t(col), int16_t(row), int16_t(wid),
+             int16_t(hgt), c, GuiImage(), nullptr, &fb});
+}
+
+
+void GuiRenderQueue::line(Framebuffer &fb, int c0, int r0, int c1, int r1,
+                          Color c)
+{
+    push(Cmd{Op::line, int16_t(c0), int16_t(r0), int16_t(c1), int16_t(r1), c,
+             GuiImage(), nullptr, &fb});
+}
+
+
+void GuiRenderQueue::write(Framebuffer &fb, int col, int row,
+                           const GuiImage &img)
+{
+    push(Cmd{Op::write, int16_t(col), int16_t(row), 0, 0, Color(), img,
+             nullptr, &fb});
+}
+
+
+// The background's tiles are built and sent by the render core.
+void GuiRenderQueue::restore(Framebuffer &fb, GuiBackground &bg, int col,
+                             int row, int wid, int hgt)
+{
+    push(Cmd{Op::restore, int16_t(col), int16_t(row), int16_t(wid),
+             int16_t(hgt), Color(), GuiImage(), &bg, &fb});
+}
+
+
+void GuiRenderQueue::wait(uint32_t fence) const
+{
+    while (!done(fence))
+        tight_loop_contents();
+}
+
+
+bool GuiRenderQueue::render_one()
+{
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+
+    if (tail == _head.load(std::memory_order_acquire))
+        return false;
+
+    const Cmd &cmd = _ring[tail & (capacity - 1)];
+    switch (cmd.op) {
+        case Op::fill_rect:
+            cmd.fb->fill_rect(cmd.a, cmd.b, cmd.c, cmd.d, cmd.color);
+            break;
+        case Op::draw_rect:
+            cmd.fb->draw_rect(cmd.a, cmd.b, cmd.c, cmd.d, cmd.color);
+            break;
+        case Op::line:
+            cmd.fb->line(cmd.a, cmd.b, cmd.c, cmd.d, cmd.color);
+            break;
+        case Op::write:
+            cmd.img.write(*cmd.fb, cmd.a, cmd.b, _decode_work,
+                          sizeof(_decode_work));
+            break;
+        case Op::restore:
+            cmd.bg->restore(*cmd.fb, cmd.a, cmd.b, cmd.c, cmd.d);
+            break;
+    }
+
+    // the slot can be reused, and fences up to here are done
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+
+void GuiRenderQueue::run()
+{
+    while (true) {
+        if (render_one())
+            continue;
+        // check for stop only when empty, so everything queued is written
+        if (_stop.load(std::memory_order_acquire) && !render_one())
+            break;
+        tight_loop_contents();
+    }
+
+    // ready to run again
+    _stop.store(false, std::memory_order_relaxed);
+}
@@ -27,6 +27,7 @@ GuiSlider::GuiSlider(Framebuffer &fb, int col, int row, int wid, int hgt, //
     _val_min(val_min),
     _val_max(val_max),
     _val(val_init),
+    _drawn_val(not_drawn),
     _on_value(on_value),
     _on_value_arg(on_value_arg)
 {
@@ -110,20 +111,20 @@ int GuiSlider::to_value(int c)
 }
 
 
-void GuiSlider::draw_handle()
+void GuiSlider::draw_handle(int val)
 {
-    int handle_ctr = to_column(_val);
+    int handle_ctr = to_column(val);
     const int left = handle_ctr - _handle_wid / 2;
     const int right = handle_ctr + _handle_wid / 2;
-    _fb.line(left, _row + 1, left, _row + _hgt - 2, _fg);
-    _fb.line(right, _row + 1, right, _row + _hgt - 2, _fg);
-    _fb.fill_rect(left + 1, _row + 1, _handle_wid - 2, _hgt - 2, _handle_bg);
+    line(left, _row + 1, left, _row + _hgt - 2, _fg);
+    line(right, _row + 1, right, _row + _hgt - 2, _fg);
+    fill_rect(left + 1, _row + 1, _handle_wid - 2, _hgt - 2, _handle_bg);
 }
 
 
-void GuiSlider::erase_handle()
+void GuiSlider::erase_handle(int val)
 {
-    int handle_ctr = to_column(_val);
+    int handle_ctr = to_column(val);
 
     // fill to cover the left and right edges of the handle
     int handle_left = handle_ctr - _handle_wid / 2;
@@ -136,7 +137,7 @@ void GuiSlider::erase_handle()
         // at right end, don't fill right edge
         width--;
     }
-    _fb.fill_rect(handle_left, _row + 1, width, _hgt - 2, _track_bg);
+    fill_rect(handle_left, _row + 1, width, _hgt - 2, _track_bg);
 }
 
 
@@ -144,13 +145,94 @@ void GuiSlider::erase_handle()
 void GuiSlider::draw()
 {
     if (_visible) {
-        _fb.draw_rect(_col, _row, _wid, _hgt, _fg);
-        _fb.fill_rect(_col + 1, _row + 1, _wid - 2, _hgt - 2, _track_bg);
-        draw_handle();
+        draw_rect(_col, _row, _wid, _hgt, _fg);
+        fill_rect(_col + 1, _row + 1, _wid - 2, _hgt - 2, _track_bg);
+        draw_handle(_val);
+        _drawn_val = _val;
     }
 }
 
 
+// Move the handle from _drawn_val to _val.
+//
+// If the old and new handles overlap, only the difference is sent: the
+// strip of track the handle uncovered, the handle's new edges, and the
+// strip of handle interior that is newly covered (including the old edge
+// that is now inside the handle). The result is pixel-for-pixel what
+// erase_handle() then draw_handle() would leave, including not touching the
+// track outline when the handle moves away from either end.
+void GuiSlider::refresh()
+{
+    if (!_visible)
+        return;
+
+    // Nothing drawn to move from, or the handle has not moved and something
+    // else changed (e.g. enabled(e, true)): draw it all.
+    if (_drawn_val == not_drawn || _drawn_val == _val) {
+        draw();
+        return;
+    }
+
+    const int old_left = to_column(_drawn_val) - _handle_wid / 2;
+    const int new_left = to_column(_val) - _handle_wid / 2;
+    const int shift = new_left - old_left;
+
+    if (shift >= _handle_wid || -shift >= _handle_wid) {
+        // no overlap
+        erase_handle(_drawn_val);
+        draw_handle(_val);
+    } else if (shift > 0) {
+        const int old_right = old_left + _handle_wid - 1;
+        const int new_right = new_left + _handle_wid - 1;
+        // uncovered track, but not the track's left edge
+        int track_left = old_left == _col ? old_left + 1 : old_left;
+        fill_columns(track_left, new_left - 1, _track_bg);
+        edge(new_left);
+        // interior; the old right edge is interior or the new left edge
+        int fill_left = old_right > new_left ? old_right : new_left + 1;
+        fill_columns(fill_left, new_right - 1, _handle_bg);
+        edge(new_right);
+    } else if (shift < 0) {
+        const int old_right = old_left + _handle_wid - 1;
+        const int new_right = new_left + _handle_wid - 1;
+        // uncovered track, but not the track's right edge
+        int track_right = old_right == _col + _wid - 1 ? old_right - 1
+                                                        : old_right;
+        fill_columns(new_right + 1, track_right, _track_bg);
+        edge(new_right);
+        // interior; the old left edge is interior or the new right edge
+        int fill_right = old_left < new_right ? old_left : new_right - 1;
+        fill_columns(new_left + 1, fill_right, _handle_bg);
+        edge(new_left);
+    }
+    // else different values, same handle position
+
+    _drawn_val = _val;
+}
+
+
+void GuiSlider::erase()
+{
+    GuiWidget::erase();
+    erased();
+}
+
+
+// fill columns first..last (inclusive) inside the track outline
+void GuiSlider::fill_columns(int first, int last, Color c)
+{
+    if (last >= first)
+        fill_rect(first, _row + 1, last - first + 1, _hgt - 2, c);
+}
+
+
+// one of the handle's vertical edges
+void GuiSlider::edge(int col)
+{
+    line(col, _row + 1, col, _row + _hgt - 2, _fg);
+}
+
+
 bool GuiSlider::event(Event &event)
 {
     if (!_visible || !_enabled)
@@ -200,8 +282,7 @@ void GuiSlider::set_value(int v)
         v = _val_max;
 
     if (v != _val) {
-        erase_handle();
         _val = v;
-        draw_handle();
+        invalidate();
     }
 }
@@ -0,0 +1,33 @@
+
+#include <cstdint>
+#include <cstdio>
+// pico
+#include "pico/stdlib.h"
+// gui
+#include "gui_stats.h"
+
+uint64_t GuiStats::event_start_us = 0;
+
+
+void GuiStats::print_header()
+{
+    printf("%-20s %7s %10s %9s %6s", "widget", "draws", "draw us", "pixels",
+           "events");
+    for (int b = 0; b < bins; b++) {
+        char edge[12];
+        snprintf(edge, sizeof(edge), "<%lu", (unsigned long)bin_us(b + 1));
+        printf(" %6s", b == bins - 1 ? "more" : edge);
+    }
+    printf(" %7s\n", "max us");
+}
+
+
+void GuiStats::print(const char *name) const
+{
+    printf("%-20s %7lu %10llu %9llu %6lu", name, (unsigned long)draws,
+           (unsigned long long)draw_us, (unsigned long long)pixels,
+           (unsigned long)events);
+    for (int b = 0; b < bins; b++)
+        printf(" %6lu", (unsigned long)latency[b]);
+    printf(" %7lu\n", (unsigned long)latency_max_us);
+}
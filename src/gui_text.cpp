@@ -0,0 +1,133 @@
+
+#include <cstring>
+// pico
+#include "pico/stdlib.h"
+// framebuffer
+#include "color.h"
+#include "font.h"
+#include "framebuffer.h"
+// gui
+#include "gui_canvas.h"
+#include "gui_image.h"
+#include "gui_text.h"
+#include "gui_widget.h"
+
+using HAlign = Framebuffer::HAlign;
+
+
+GuiText::GuiText(Framebuffer &fb, int col, int row, Color bg, const Font &font,
+                 Color fg, const char *txt, HAlign h_align, bool visible,
+                 bool enabled) :
+    GuiWidget(fb, col, row, 0, font.y_adv, bg, visible, enabled),
+    _img{},
+    _pal{fg, 0, Color::none(), bg},
+    _h_align(h_align),
+    _col_ref(col),
+    _drawn_on(nullptr),
+    _fence(0)
+{
+    _img.hdr = TextImageHdr{PixelImageHdr{0, font.y_adv}, &font};
+    strncpy(_img.txt, txt, max_len);
+    _img.hdr.hdr.wid = font.width(_img.txt);
+    _wid = _img.hdr.hdr.wid;
+    _col = align_col(_wid);
+}
+
+
+int GuiText::align_col(int wid) const
+{
+    if (_h_align == HAlign::Center)
+        return _col_ref - wid / 2;
+    else if (_h_align == HAlign::Right)
+        return _col_ref - wid;
+    else
+        return _col_ref;
+}
+
+
+void GuiText::draw()
+{
+    if (!_visible)
+        return;
+
+    const int wid = _img.hdr.hdr.wid;
+    const int col = align_col(wid);
+    write(col, _row, GuiImage(&_img.hdr, &_pal));
+    drawn();
+
+    if (_col != col || _wid != wid) {
+        _col = col;
+        _wid = wid;
+        bounds_changed();
+    }
+}
+
+
+void GuiText::refresh()
+{
+    if (!_visible)
+        return;
+
+    const int old_col = _col;
+    const int old_end = _col + _wid;
+
+    draw();
+
+    // erase what the old text covered outside the new
+    const int new_end = _col + _wid;
+    if (old_col < _col) {
+        int end = old_end < _col ? old_end : _col;
+        erase_rect(old_col, _row, end - old_col, _hgt);
+    }
+    if (old_end > new_end) {
+        int start = old_col > new_end ? old_col : new_end;
+        erase_rect(start, _row, old_end - start, _hgt);
+    }
+}
+
+
+void GuiText::move(int col, int row)
+{
+    _col_ref += col - _col;
+    GuiWidget::move(col, row);
+}
+
+
+// A display list recording the draw has nothing to fence; the page calls
+// replayed() when it draws the list on the real canvas.
+void GuiText::drawn()
+{
+    _drawn_on = canvas;
+    if (canvas != nullptr)
+        _fence = canvas->fence();
+}
+
+
+void GuiText::settle()
+{
+    if (_drawn_on != nullptr) {
+        _drawn_on->wait(_fence);
+        _drawn_on = nullptr;
+    }
+}
+
+
+void GuiText::set_text(const char *txt)
+{
+    if (strncmp(_img.txt, txt, max_len) == 0)
+        return;
+    settle();
+    strncpy(_img.txt, txt, max_len);
+    _img.hdr.hdr.wid = _img.hdr.font->width(_img.txt);
+    invalidate();
+}
+
+
+void GuiText::set_color(Color fg)
+{
+    if (_pal.fg != fg) {
+        settle();
+        _pal.fg = fg;
+        invalidate();
+    }
+}
@@ -0,0 +1,114 @@
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+// pico
+#include "hardware/gpio.h"
+#include "pico/stdlib.h"
+// touchscreen
+#include "touchscreen.h"
+// gui
+#include "gui_touch_input.h"
+
+using Event = Touchscreen::Event;
+
+GuiTouchInput *GuiTouchInput::irq_input = nullptr;
+
+
+bool GuiTouchInput::Ring::push(const Event &event, uint64_t us)
+{
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == capacity) {
+        _dropped++;
+        return false;
+    }
+    _events[tail % capacity] = Stamped{event, us};
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+
+bool GuiTouchInput::Ring::pop(Stamped &stamped)
+{
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+        return false;
+    stamped = _events[head % capacity];
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+
+GuiTouchInput::GuiTouchInput(Touchscreen &ts, int int_gpio,
+                             uint32_t fallback_us) :
+    _ts(ts),
+    _int_gpio(int_gpio),
+    _fallback_us(fallback_us),
+    _signalled(false),
+    _signal_us(0),
+    _read_us(0),
+    _ring(),
+    _event_us(0),
+    _reads(0)
+{
+}
+
+
+GuiTouchInput::~GuiTouchInput()
+{
+    // the interrupt stays enabled, but goes nowhere
+    if (irq_input == this)
+        irq_input = nullptr;
+}
+
+
+void GuiTouchInput::irq_enable(uint32_t edges)
+{
+    assert(_int_gpio >= 0);
+    // one input per GPIO interrupt callback
+    assert(irq_input == nullptr || irq_input == this);
+    irq_input = this;
+    gpio_set_irq_enabled_with_callback(uint(_int_gpio), edges, true, gpio_irq);
+}
+
+
+void GuiTouchInput::gpio_irq(uint gpio, uint32_t)
+{
+    if (irq_input != nullptr && int(gpio) == irq_input->_int_gpio)
+        irq_input->signal();
+}
+
+
+// A controller that reports a held touch on every read never runs out, so
+// this stops after a ring's worth.
+void GuiTouchInput::read(uint64_t us)
+{
+    _reads++;
+    _read_us = time_us_64();
+    for (int i = 0; i < Ring::capacity; i++) {
+        Event event(_ts.get_event());
+        if (event.type == Event::Type::none)
+            break;
+        _ring.push(event, us);
+    }
+}
+
+
+Event GuiTouchInput::get_event()
+{
+    const uint64_t now = time_us_64();
+    if (_signalled.exchange(false, std::memory_order_acquire)) {
+        // the signal was less than 2^31 us (35 minutes) ago, or came in
+        // just now, after 'now' was read
+        const int32_t ago = int32_t(uint32_t(now) -
+                                    _signal_us.load(std::memory_order_relaxed));
+        read(ago > 0 ? now - uint32_t(ago) : now);
+    } else if (now - _read_us >= _fallback_us)
+        read(now);
+
+    Stamped s;
+    if (!_ring.pop(s))
+        return Event();
+    _event_us = s.us;
+    return s.event;
+}
@@ -1,4 +1,117 @@
 
+#include <cstdio>
+// gui
+#include "gui_page.h"
+#include "gui_stats.h"
 #include "gui_widget.h"
 
 GuiWidget *GuiWidget::focus = nullptr;
+
+GuiCanvas *GuiWidget::canvas = nullptr;
+
+#if GUI_STATS
+GuiWidget *GuiWidget::stats_list = nullptr;
+#else
+const GuiStats GuiWidget::no_stats{};
+#endif
+
+
+GuiWidget::~GuiWidget()
+{
+#if GUI_STATS
+    GuiWidget **w = &stats_list;
+    while (*w != this)
+        w = &(*w)->_stats_next;
+    *w = _stats_next;
+#endif
+}
+
+
+void GuiWidget::visible(bool v)
+{
+    _visible = v;
+    changed();
+    if (_page != nullptr)
+        _page->reindex(this);
+}
+
+
+void GuiWidget::move(int col, int row)
+{
+    if (col == _col && row == _row)
+        return;
+    damage();
+    _col = col;
+    _row = row;
+    bounds_changed();
+    invalidate();
+}
+
+
+void GuiWidget::invalidate()
+{
+    changed();
+    if (_page != nullptr && _page->deferred())
+        _dirty = true;
+    else if (_page == nullptr || !_page->covered(this)) {
+        const GuiRect before = rect();
+        {
+            Timed timed(*this);
+            refresh();
+        }
+        // a widget that changed size erased what it no longer covers
+        if (_page != nullptr)
+            _page->redraw(this, before.bound(rect()), before != rect(), true);
+    }
+}
+
+
+void GuiWidget::damage()
+{
+    changed();
+    if (_page != nullptr && _page->deferred())
+        _page->damage(this, rect());
+    else if (_page == nullptr || !_page->covered(this)) {
+        erase();
+        if (_page != nullptr)
+            _page->redraw(this, rect(), true, false);
+    }
+}
+
+
+void GuiWidget::bounds_changed()
+{
+    changed();
+    if (_page != nullptr)
+        _page->reindex(this);
+}
+
+
+void GuiWidget::changed()
+{
+    if (_page != nullptr)
+        _page->changed(this);
+}
+
+
+void GuiWidget::reset_stats()
+{
+#if GUI_STATS
+    _stats = GuiStats{};
+#endif
+}
+
+
+void GuiWidget::print_stats()
+{
+#if GUI_STATS
+    GuiStats::print_header();
+    for (const GuiWidget *w = stats_list; w != nullptr; w = w->_stats_next) {
+        // widgets are known by where they are
+        char name[32];
+        snprintf(name, sizeof(name), "%d,%d %dx%d", w->_col, w->_row, w->_wid,
+                 w->_hgt);
+        w->_stats.print(name);
+    }
+#endif
+}
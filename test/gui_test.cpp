@@ -1,8 +1,11 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 // pico
+#include "hardware/gpio.h"
 #include "hardware/spi.h"
+#include "pico/multicore.h"
 #include "pico/stdio.h"
 #include "pico/stdio_usb.h"
 #include "pico/stdlib.h"
@@ -13,19 +16,29 @@
 #include "util.h"
 // framebuffer
 #include "color.h"
-#include "font.h"
-#include "pixel_565.h"
 #include "pixel_image.h"
-#include "roboto.h"
 #include "ws35.h"
 // touchscreen
 #include "gt911.h"
 // gui
+#include "gui_animator.h"
+#include "gui_blit.h"
 #include "gui_button.h"
+#include "gui_event_queue.h"
+#include "gui_image.h"
 #include "gui_label.h"
+#include "gui_latency.h"
+#include "gui_loop.h"
 #include "gui_number.h"
 #include "gui_page.h"
+#include "gui_page_base.h"
+#include "gui_pixel.h"
+#include "gui_render_queue.h"
 #include "gui_slider.h"
+#include "gui_static_page.h"
+#include "gui_stats.h"
+#include "gui_touch_input.h"
+#include "gui_assets.h" // generated from gui_test_assets.txt
 //
 #include "fb_gpio_cfg.h"
 #include "ts_gpio_cfg.h"
@@ -53,11 +66,19 @@ static I2cDev i2c_dev(ts_i2c_inst, ts_i2c_scl_gpio, ts_i2c_sda_gpio,
 
 static Gt911 ts(i2c_dev, ts_i2c_addr, ts_rst_gpio, ts_int_gpio);
 
+// The tests read touches through this: the GT911 is only read over I2C
+// after it signals on INT.
+static GuiTouchInput touch(ts, ts_int_gpio);
+
 // clang-format off
 namespace Label1 { static void run(); }
 namespace Button1 { static void run(); }
 namespace NavGroup1 { static void run(); }
 namespace Events1 { static void run(); }
+namespace Render1 { static void run(); }
+namespace Blit1 { static void run(); }
+namespace Anim1 { static void run(); }
+namespace Latency1 { static void run(); }
 // clang-format on
 
 static struct {
@@ -68,6 +89,10 @@ static struct {
     {"Button1", Button1::run},
     {"NavGroup1", NavGroup1::run},
     {"Events1", Events1::run},
+    {"Render1", Render1::run},
+    {"Blit1", Blit1::run},
+    {"Anim1", Anim1::run},
+    {"Latency1", Latency1::run},
 };
 static const int num_tests = sizeof(tests) / sizeof(tests[0]);
 
@@ -78,6 +103,9 @@ static void help()
     printf("Usage: enter test number (0..%d)\n", num_tests - 1);
     for (int i = 0; i < num_tests; i++)
         printf("%2d: %s\n", i, tests[i].name);
+#if GUI_STATS
+    printf("or \"stats\" for per-widget draw and event counters\n");
+#endif
     printf("\n");
 }
 
@@ -140,6 +168,8 @@ int main()
 
     assert(ts.init());
     ts.set_rotation(Touchscreen::Rotation::landscape);
+    // INT pulses once per report; either edge means there is data
+    touch.irq_enable(GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
     printf("Touchscreen ready\n");
 
     help();
@@ -150,7 +180,11 @@ int main()
         if (0 <= c && c <= 255) {
             if (argv.add_char(char(c))) {
                 int test_num = -1;
-                if (argv.argc() != 1) {
+                if (argv.argc() == 1 && strcmp(argv[0], "stats") == 0) {
+                    printf("\n");
+                    GuiWidget::print_stats();
+                    printf("> ");
+                } else if (argv.argc() != 1) {
                     printf("\n");
                     printf("One integer only (got %d)\n", argv.argc());
                     help();
@@ -182,37 +216,17 @@ int main()
 
 namespace Label1 {
 
-static constexpr Font font = roboto_32;
-
-static constexpr char txt_en[] = "Enabled";
-static constexpr char txt_dis[] = "Disabled";
-
-static constexpr int wid_en = font.width(txt_en);
-static constexpr int wid_dis = font.width(txt_dis);
-static constexpr int wid = (wid_en > wid_dis) ? wid_en : wid_dis;
-
-static constexpr int hgt_en = font.y_adv;
-static constexpr int hgt_dis = font.y_adv;
-static constexpr int hgt = (hgt_en > hgt_dis) ? hgt_en : hgt_dis;
-
-static constexpr Color fg_en = Color::black();
-static constexpr Color fg_dis = Color::gray(75);
+// images (label1_en, label1_dis) are in gui_test_assets.txt
 
 static constexpr Color bg_en = Color::white();
-static constexpr Color bg_dis = Color::gray(25);
-
-static constexpr PixelImage<Pixel565, wid, hgt> img_en =
-    label_img<Pixel565, wid, hgt>(txt_en, font, fg_en, 0, fg_en, bg_en);
-
-static constexpr PixelImage<Pixel565, wid, hgt> img_dis =
-    label_img<Pixel565, wid, hgt>(txt_dis, font, fg_dis, 0, fg_dis, bg_dis);
 
 static void run()
 {
-    int col = (fb.width() - wid) / 2;
-    int row = (fb.height() - hgt) / 2;
+    int col = (fb.width() - label1_en_img.hdr.wid) / 2;
+    int row = (fb.height() - label1_en_img.hdr.hgt) / 2;
 
-    GuiLabel label(fb, col, row, bg_en, &img_en.hdr, &img_dis.hdr);
+    GuiLabel label(fb, col, row, bg_en, &label1_en_img.hdr,
+                   &label1_dis_img.hdr);
     label.draw();
     for (int i = 0; i < 5; i++) {
         sleep_ms(1000);
@@ -227,17 +241,9 @@ static void run()
 
 namespace Button1 {
 
-static constexpr Font font = roboto_32;
+// images (button1, twice its text's size) are in gui_test_assets.txt
 
-static constexpr char txt[] = "Button";
-static constexpr int wid = font.width(txt) * 2;
-static constexpr int hgt = font.y_adv * 2;
 static constexpr Color screen_bg = Color::white();
-static constexpr Color fg = Color::black();
-static constexpr Color bg_up = Color::white();
-static constexpr Color bg_dn = Color::gray(80);
-static constexpr int brd_thk = 4;
-static constexpr Color brd_clr = fg;
 
 static void btn_click(int)
 {
@@ -254,18 +260,15 @@ static void btn_up(int)
     printf("up!\n");
 }
 
-static constexpr PixelImage<Pixel565, wid, hgt> img_up =
-    label_img<Pixel565, wid, hgt>(txt, font, fg, brd_thk, brd_clr, bg_up);
-
-static constexpr PixelImage<Pixel565, wid, hgt> img_dn =
-    label_img<Pixel565, wid, hgt>(txt, font, fg, brd_thk, brd_clr, bg_dn);
-
 static void run()
 {
     printf("(press any key to stop)\n");
 
-    GuiButton btn(fb, (fb.width() - wid) / 2, (fb.height() - hgt) / 2,
-                  screen_bg, &img_up.hdr, &img_up.hdr, &img_dn.hdr, //
+    const PixelImageHdr *img_up = &button1_btn_up_img.hdr;
+    const PixelImageHdr *img_dn = &button1_btn_dn_img.hdr;
+    GuiButton btn(fb, (fb.width() - img_up->wid) / 2,
+                  (fb.height() - img_up->hgt) / 2, screen_bg, //
+                  img_up, img_up, img_dn,                      //
                   btn_click, 0, btn_down, 0, btn_up, 0);
 
     btn.draw();
@@ -276,7 +279,7 @@ static void run()
         if (0 <= c && c <= 255)
             break;
 
-        Touchscreen::Event event(ts.get_event());
+        Touchscreen::Event event(touch.get_event());
         if (event.type == Touchscreen::Event::Type::none)
             continue;
 
@@ -303,7 +306,8 @@ static void run()
 
 namespace NavGroup1 {
 
-static constexpr Font font = roboto_32;
+// images (labels, roboto_48 digits, nav button masks) are in
+// gui_test_assets.txt
 
 static constexpr Color screen_fg = Color::black();
 static constexpr Color screen_bg = Color::white();
@@ -315,61 +319,30 @@ static void nop(int)
 {
 }
 
-///// Use preprocessor to create an image for each digit 0-9.
-
-#define IMG_MAKE(N, F, FG, BG)                                                \
-    static constexpr PixelImage<Pixel565, F.width(#N), F.y_adv> F##_img_##N = \
-        label_img<Pixel565, F.width(#N), F.y_adv>(#N, F, FG, BG);
-
-// clang-format off
-#define IMG_LIST(F, FG, BG) IMG_MAKE(0, F, FG, BG) IMG_MAKE(1, F, FG, BG) \
-                            IMG_MAKE(2, F, FG, BG) IMG_MAKE(3, F, FG, BG) \
-                            IMG_MAKE(4, F, FG, BG) IMG_MAKE(5, F, FG, BG) \
-                            IMG_MAKE(6, F, FG, BG) IMG_MAKE(7, F, FG, BG) \
-                            IMG_MAKE(8, F, FG, BG) IMG_MAKE(9, F, FG, BG)
-// clang-format on
-
-// Expand to create all ten images
-IMG_LIST(roboto_48, screen_fg, screen_bg)
-
-// Clean up macros
-#undef IMG_MAKE
-#undef IMG_LIST
-
-static const PixelImageHdr *roboto_48_digit_img[10] = {
-    &roboto_48_img_0.hdr, &roboto_48_img_1.hdr, &roboto_48_img_2.hdr,
-    &roboto_48_img_3.hdr, &roboto_48_img_4.hdr, &roboto_48_img_5.hdr,
-    &roboto_48_img_6.hdr, &roboto_48_img_7.hdr, &roboto_48_img_8.hdr,
-    &roboto_48_img_9.hdr,
-};
-
 /////
 
-#define GUI_LABEL(FB, VAR, TXT, FNT, WID, HGT, COL, ROW, FG, BG)            \
-    static constexpr int VAR##_wid = (WID != 0 ? WID : FNT.width(TXT));     \
-    static constexpr int VAR##_hgt = (HGT != 0 ? HGT : FNT.y_adv);          \
-    static constexpr PixelImage<Pixel565, VAR##_wid, VAR##_hgt> VAR##_img = \
-        label_img<Pixel565, VAR##_wid, VAR##_hgt>(TXT, FNT, FG, 0,          \
-                                                  Color::none(), BG);       \
-    static GuiLabel VAR(FB, (COL), (ROW), BG, &VAR##_img.hdr, &VAR##_img.hdr)
+// a label showing IMG_img (gui_test_assets.txt)
+#define GUI_LABEL(FB, IMG, COL, ROW, BG) \
+    GuiLabel(FB, (COL), (ROW), BG, &IMG##_img.hdr, &IMG##_img.hdr)
 
 /////
 
-// page 0
+// pages 0 and 1 are just labels: static pages are a fraction of the size,
+// and as they own their labels, call them directly
 
-GUI_LABEL(fb, l0a, "Label 0A", font, 0, 0, 100, 100, screen_fg, screen_bg);
-GUI_LABEL(fb, l0b, "Label 0B", font, 0, 0, 100, (100 + l0a_hgt + 10), screen_fg,
-          screen_bg);
+// page 0
 
-static GuiPage page_0({&l0a, &l0b});
+static GuiStaticPage<GuiLabel, GuiLabel> page_0(
+    GUI_LABEL(fb, l0a, 100, 100, screen_bg),
+    GUI_LABEL(fb, l0b, 100, (100 + l0a_img.hdr.hgt + 10), screen_bg));
+static GuiPageAdapter<decltype(page_0)> page_0_adapter(page_0);
 
 // page 1
 
-GUI_LABEL(fb, l1a, "Label 1A", font, 0, 0, 200, 100, screen_fg, screen_bg);
-GUI_LABEL(fb, l1b, "Label 1B", font, 0, 0, 200, (100 + l1a_hgt + 10), screen_fg,
-          screen_bg);
-
-static GuiPage page_1({&l1a, &l1b});
+static GuiStaticPage<GuiLabel, GuiLabel> page_1(
+    GUI_LABEL(fb, l1a, 200, 100, screen_bg),
+    GUI_LABEL(fb, l1b, 200, (100 + l1a_img.hdr.hgt + 10), screen_bg));
+static GuiPageAdapter<decltype(page_1)> page_1_adapter(page_1);
 
 // page 2
 
@@ -400,7 +373,6 @@ static void s2a_value(intptr_t)
 {
     int val = s2a.get_value();
     n2a.set_value(val);
-    n2a.draw();
 }
 
 static GuiNumber n2b(fb, s_align, row_b, screen_bg, roboto_48_digit_img, 0,
@@ -431,14 +403,13 @@ static void s2c_value(intptr_t)
 {
     int val = s2c.get_value();
     n2c.set_value(val);
-    n2c.draw();
 }
 
 static GuiPage page_2({&n2a, &s2a, &n2b, &s2b, &n2c, &s2c});
 
 /////
 
-static GuiPage *pages[] = {&page_0, &page_1, &page_2};
+static GuiPageBase *pages[] = {&page_0_adapter, &page_1_adapter, &page_2};
 
 static int active_page = -1;
 
@@ -448,7 +419,6 @@ static int active_page = -1;
 static constexpr int fb_width = 480;
 
 static constexpr int nav_cnt = 3;
-static constexpr Font nav_font = roboto_24;
 
 static constexpr Color nav_bg_ena = Color::gray(80);
 static constexpr Color nav_bg_dis = screen_bg;
@@ -457,42 +427,38 @@ static constexpr Color nav_bg_prs = Color::red();
 static constexpr int nav_brd_thk_ena = 4;
 static constexpr int nav_brd_thk_dis = 1;
 static constexpr int nav_brd_thk_prs = 6;
-static constexpr int nav_brd_thk_max = 6;
 
-static constexpr int nav_hgt = nav_font.y_adv + 2 * nav_brd_thk_max;
-static constexpr int nav_wid = fb_width / nav_cnt;
+// The three states of a nav button differ only in colors and border, so
+// they share one 4-bit text mask (bN_mask, fb_width / nav_cnt wide, padded
+// for nav_brd_thk_prs), each drawn in its own palette.
+static const GuiPalette nav_pal_ena = {screen_fg, nav_brd_thk_ena, screen_fg,
+                                       nav_bg_ena};
+static const GuiPalette nav_pal_dis = {screen_fg, nav_brd_thk_dis, screen_fg,
+                                       nav_bg_dis};
+static const GuiPalette nav_pal_prs = {screen_fg, nav_brd_thk_prs, screen_fg,
+                                       nav_bg_prs};
 
 // clang-format off
-#define NAV_BUTTON(N, TXT) \
-    static constexpr PixelImage<Pixel565, nav_wid, nav_hgt> b##N##_img_ena = \
-        label_img<Pixel565, nav_wid, nav_hgt>(TXT, nav_font, screen_fg, \
-                                              nav_brd_thk_ena, screen_fg, \
-                                              nav_bg_ena); \
-    \
-    static constexpr PixelImage<Pixel565, nav_wid, nav_hgt> b##N##_img_dis = \
-        label_img<Pixel565, nav_wid, nav_hgt>(TXT, nav_font, screen_fg, \
-                                              nav_brd_thk_dis, screen_fg, \
-                                              nav_bg_dis); \
-    \
-    static constexpr PixelImage<Pixel565, nav_wid, nav_hgt> b##N##_img_prs = \
-        label_img<Pixel565, nav_wid, nav_hgt>(TXT, nav_font, screen_fg, \
-                                              nav_brd_thk_prs, screen_fg, \
-                                              nav_bg_prs); \
-    \
-    static GuiButton nav_##N(fb, N * fb_width / nav_cnt, 0, screen_bg, \
-                             &b##N##_img_ena.hdr, \
-                             &b##N##_img_dis.hdr, \
-                             &b##N##_img_prs.hdr, \
-                             nav_click, N, nop, 0, nop, 0);
+#define NAV_BUTTON(N) \
+    GuiButton(fb, N * fb_width / nav_cnt, 0, screen_bg, \
+              GuiImage(&b##N##_mask.hdr, &nav_pal_ena), \
+              GuiImage(&b##N##_mask.hdr, &nav_pal_dis), \
+              GuiImage(&b##N##_mask.hdr, &nav_pal_prs), \
+              nav_click, N, nop, 0, nop, 0)
 // clang-format on
 
-NAV_BUTTON(0, "PAGE 0")
-NAV_BUTTON(1, "PAGE 1")
-NAV_BUTTON(2, "PAGE 2")
+// the nav bar gets events before the active page
+static GuiStaticPage<GuiButton, GuiButton, GuiButton> nav_bar(NAV_BUTTON(0),
+                                                              NAV_BUTTON(1),
+                                                              NAV_BUTTON(2));
+static GuiPageAdapter<decltype(nav_bar)> nav_bar_adapter(nav_bar);
 
 #undef NAV_BUTTON
 
-static GuiButton *navs[] = {&nav_0, &nav_1, &nav_2};
+static GuiButton *navs[] = {&nav_bar.widget<0>(), &nav_bar.widget<1>(),
+                            &nav_bar.widget<2>()};
+
+static GuiLoop loop(touch);
 
 /////
 
@@ -516,55 +482,84 @@ static void nav_click(int page_num)
         // first call only, hide them all and force redraw
         for (int p = 0; p < page_cnt; p++)
             hide_page(p, true);
+        active_page = page_num;
+        show_page(active_page);
     } else {
-        // old 'active_page' is becoming inactive - hide it
-        hide_page(active_page);
+        // swap pages, erasing only what the new page does not draw over
+        navs[active_page]->enabled(true);
+        navs[page_num]->enabled(false);
+        const GuiPageBase::Swap s =
+            GuiPageBase::swap(*pages[active_page], *pages[page_num]);
+        printf("page %d to %d: %lu pixels erased, %lu saved\n", active_page,
+               page_num, (unsigned long)s.erased, (unsigned long)s.saved);
+        active_page = page_num;
     }
 
-    // switch pages
-    active_page = page_num;
-
-    // new 'active_page' is becoming active - show it
-    show_page(active_page);
+    loop.page(pages[active_page]);
 }
 
 /////
 
+static void check_key(intptr_t)
+{
+    int c = stdio_getchar_timeout_us(0);
+    if (c == 's')
+        GuiWidget::print_stats();
+    else if (0 <= c && c <= 255)
+        loop.stop();
+}
+
 static void run()
 {
+#if GUI_STATS
+    printf("(press 's' for widget stats, any other key to stop)\n");
+#else
     printf("(press any key to stop)\n");
+#endif
 
-    nav_click(0); // start out on page 0
+    // page 2's sliders update numbers; let the page batch the redraws
+    page_2.deferred(true);
 
-    while (true) {
-
-        int c = stdio_getchar_timeout_us(0);
-        if (0 <= c && c <= 255)
-            break;
-
-        Touchscreen::Event event(ts.get_event());
-        if (event.type == Touchscreen::Event::Type::none)
-            continue;
-
-        //printf("Event: %s at (%d, %d)\n", //
-        //event.type_name(), event.col, event.row);
-
-        // anyone have focus?
-        if (GuiWidget::focus != nullptr) {
-            // yes, send event there
-            GuiWidget::focus->event(event);
-        } else {
-            // no, see if anyone wants it
-            bool handled = false;
-            // nav buttons?
-            for (int p = 0; p < page_cnt && !handled; p++)
-                handled = navs[p]->event(event);
-            // anyone on current page want it?
-            if (!handled)
-                pages[active_page]->event(event);
-        }
-    }
+    nav_bar.visible(true);
+    nav_click(0); // start out on page 0
 
+    // The loop reads the touchscreen, sends events to the nav bar or the
+    // page, and flushes. Redrawing can take longer than the time between
+    // touch samples; its queue keeps only the newest of a run of moves.
+    loop.bar(&nav_bar_adapter);
+    loop.page_updates(100'000);
+    const int key_task = loop.every(50'000, check_key);
+    // a quarter of the screen per frame
+    loop.frame_budget(GuiLoop::frame_us(fb.width() * fb.height() / 4,
+                                        spi_baud_actual));
+    // sleep when idle (the touchscreen's INT wakes the loop), and dim the
+    // backlight after 30 s without a touch
+    loop.idle(50'000);
+    loop.dim(&fb, 30'000'000, 20);
+    loop.run();
+    loop.dim(nullptr, 0, 0);
+    loop.cancel(key_task);
+
+    const GuiEventQueue &events = loop.events();
+    printf("events: %lu moves coalesced, %lu dropped, %lu refused\n",
+           (unsigned long)events.coalesced(), (unsigned long)events.dropped(),
+           (unsigned long)events.refused());
+    const GuiLoop::Stats &stats = loop.stats();
+    printf("frames: %lu, %lu over budget, worst %lu us; tasks: %lu runs, "
+           "%lu deadlines missed\n",
+           (unsigned long)stats.frames, (unsigned long)stats.overruns,
+           (unsigned long)stats.worst_frame_us, (unsigned long)stats.task_runs,
+           (unsigned long)stats.missed);
+    const uint64_t total_us =
+        stats.dispatch_us + stats.draw_us + stats.task_us + stats.idle_us;
+    if (total_us > 0)
+        printf("time: dispatch %llu%%, draw %llu%%, tasks %llu%%, idle %llu%% "
+               "(%lu sleeps)\n",
+               (unsigned long long)(stats.dispatch_us * 100 / total_us),
+               (unsigned long long)(stats.draw_us * 100 / total_us),
+               (unsigned long long)(stats.task_us * 100 / total_us),
+               (unsigned long long)(stats.idle_us * 100 / total_us),
+               (unsigned long)stats.sleeps);
     printf("\n");
 }
 
@@ -577,18 +572,219 @@ static void run()
 {
     printf("(press any key to stop)\n");
 
+    const uint32_t reads = touch.reads();
+    const uint64_t start_us = time_us_64();
     while (true) {
-        Touchscreen::Event event(ts.get_event());
+        Touchscreen::Event event(touch.get_event());
         if (event.type != Touchscreen::Event::Type::none) {
-            printf("Event: %s at (%d, %d)\n", //
-                   event.type_name(), event.col, event.row);
+            printf("Event: %s at (%d, %d), %llu us\n", //
+                   event.type_name(), event.col, event.row,
+                   (unsigned long long)(touch.event_us() - start_us));
         }
         int c = stdio_getchar_timeout_us(0);
         if (0 <= c && c <= 255)
             break;
     }
 
+    printf("%lu touchscreen reads in %llu ms\n",
+           (unsigned long)(touch.reads() - reads),
+           (unsigned long long)((time_us_64() - start_us) / 1000));
     printf("\n");
 }
 
 } // namespace Events1
+
+
+namespace Render1 {
+
+// NavGroup1 with the Framebuffer writes done on core1
+
+static GuiRenderQueue queue;
+
+static void core1_main()
+{
+    queue.run();
+    multicore_fifo_push_blocking(0); // tell core0 we are done
+}
+
+static void run()
+{
+    multicore_launch_core1(core1_main);
+
+    GuiWidget::canvas = &queue;
+    NavGroup1::run();
+    GuiWidget::canvas = nullptr;
+
+    queue.stop();
+    multicore_fifo_pop_blocking(); // core1 has written everything
+    multicore_reset_core1();
+
+    printf("render: producer waited on a full queue %lu times\n",
+           (unsigned long)queue.full_waits());
+    printf("\n");
+}
+
+} // namespace Render1
+
+
+namespace Blit1 {
+
+// full-screen gradient, computed a strip at a time, sent directly and then
+// double-buffered through core1
+
+class Gradient : public GuiBlit::Source
+{
+public:
+
+    virtual int width() const override
+    {
+        return fb.width();
+    }
+
+    virtual int height() const override
+    {
+        return fb.height();
+    }
+
+    virtual void rows(int row, int cnt, GuiPixel *dst) const override
+    {
+        const int wid = width();
+        const int hgt = height();
+        for (int r = row; r < row + cnt; r++)
+            for (int c = 0; c < wid; c++)
+                *dst++ = GuiPixel(Color(uint8_t(c * 255 / (wid - 1)),
+                                        uint8_t(r * 255 / (hgt - 1)), 128));
+    }
+};
+
+static const int blit_work_bytes =
+    2 * (16 + 8 * 480 * int(sizeof(GuiPixel))); // 8 rows/strip
+static uint8_t blit_work[blit_work_bytes] __attribute__((aligned(8)));
+
+static GuiRenderQueue queue;
+
+static void core1_main()
+{
+    queue.run();
+    multicore_fifo_push_blocking(0);
+}
+
+static void run()
+{
+    const Gradient src;
+
+    GuiBlit direct(blit_work, blit_work_bytes);
+    uint64_t start_us = time_us_64();
+    direct.start(fb, 0, 0, src);
+    direct.wait();
+    printf("direct: %lu us\n", (unsigned long)(time_us_64() - start_us));
+
+    multicore_launch_core1(core1_main);
+    GuiBlit queued(blit_work, blit_work_bytes, &queue);
+    start_us = time_us_64();
+    queued.start(fb, 0, 0, src);
+    queued.wait();
+    printf("double-buffered: %lu us (%lu strip waits)\n",
+           (unsigned long)(time_us_64() - start_us),
+           (unsigned long)queued.strip_waits());
+    queue.stop();
+    multicore_fifo_pop_blocking();
+    multicore_reset_core1();
+
+    printf("\n");
+}
+
+} // namespace Blit1
+
+
+namespace Anim1 {
+
+// a slider swept back and forth, eased, then a sweep with a tall handle
+// that is slow to draw (fewer frames, same duration)
+
+static void sweep(GuiSlider &sld)
+{
+    GuiAnimator anim;
+    const uint64_t start_us = time_us_64();
+    for (int i = 0; i < 3; i++) {
+        anim.start(0, 100, 1'000'000, GuiAnimator::slider_value,
+                   intptr_t(&sld), GuiAnimator::Ease::in_out);
+        anim.run();
+        anim.start(100, 0, 1'000'000, GuiAnimator::slider_value,
+                   intptr_t(&sld), GuiAnimator::Ease::in_out);
+        anim.run();
+    }
+    printf("%lu us: %lu frames, %lu skipped, worst %lu us, paced at %lu us\n",
+           (unsigned long)(time_us_64() - start_us),
+           (unsigned long)anim.stats().frames,
+           (unsigned long)anim.stats().skipped,
+           (unsigned long)anim.stats().worst_frame_us,
+           (unsigned long)anim.frame_us());
+}
+
+static void run()
+{
+    const Color fg = Color::black();
+    const Color bg = Color::white();
+
+    GuiSlider thin(fb, 40, 60, fb.width() - 80, 40, fg, bg, Color::gray(90),
+                   Color::white(), 0, 100, 0, nullptr, 0);
+    thin.draw();
+    sweep(thin);
+
+    GuiSlider tall(fb, 40, 120, fb.width() - 80, 160, fg, bg,
+                   Color::gray(90), Color::white(), 0, 100, 0, nullptr, 0);
+    tall.draw();
+    sweep(tall);
+
+    printf("\n");
+}
+
+} // namespace Anim1
+
+
+namespace Latency1 {
+
+// Touch-to-photon: press the button repeatedly; each press is timed from
+// the touchscreen read until the pressed image has been written.
+
+static GuiLatency lat;
+
+static GuiLoop *loop_ = nullptr;
+
+static void check_key(intptr_t)
+{
+    int c = stdio_getchar_timeout_us(0);
+    if (0 <= c && c <= 255)
+        loop_->stop();
+}
+
+static void run()
+{
+    printf("(press the button a few times, then any key to stop)\n");
+
+    // Button1's
+    const PixelImageHdr *img_up = &button1_btn_up_img.hdr;
+    const PixelImageHdr *img_dn = &button1_btn_dn_img.hdr;
+    GuiButton btn(fb, (fb.width() - img_up->wid) / 2,
+                  (fb.height() - img_up->hgt) / 2, Button1::screen_bg,
+                  img_up, img_up, img_dn, //
+                  nullptr, 0, nullptr, 0, nullptr, 0);
+    GuiPage page({&btn});
+    page.visible(true);
+
+    GuiLoop loop(touch);
+    loop_ = &loop;
+    loop.page(&page);
+    loop.every(50'000, check_key);
+
+    lat.reset();
+    GuiLatency::probe = &lat;
+    loop.run();
+    GuiLatency::probe = nullptr;
+
+    lat.print();
+    printf("\n");
+}
+
+} // namespace Latency1